@@ -0,0 +1,108 @@
+// 周期性保存快照时调用线程被阻塞的时间：同步 serialize(obj, filename) / 同步原子写（fsync + rename）
+// vs serialize_async 在不同队列深度下。两次保存之间模拟一段计算，异步写盘可以与之重叠
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <string>
+#include <vector>
+#include "binary_serialization.h"
+#include "binary_async.h"
+
+struct Record {
+    int id;
+    std::string name;
+    std::vector<double> data;
+    BINARY_SERIALIZABLE(id, name, data)
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ms_between(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+volatile double sink;
+
+// 模拟两次保存之间的请求处理
+void compute(std::vector<Record>& state, double ms) {
+    auto until = Clock::now() + std::chrono::microseconds(static_cast<long>(ms * 1000));
+    size_t i = 0;
+    double acc = 0;
+    while (Clock::now() < until) {
+        Record& r = state[i++ % state.size()];
+        r.id += 1;
+        acc += r.id;
+    }
+    sink = acc;
+}
+
+struct Row {
+    double avgStall;
+    double maxStall;
+    double totalMs;
+};
+
+template<typename Save>
+Row run(std::vector<Record>& state, int checkpoints, double workMs, Save&& save) {
+    std::vector<double> stalls;
+    auto start = Clock::now();
+    for (int c = 0; c < checkpoints; ++c) {
+        compute(state, workMs);
+        auto t0 = Clock::now();
+        save(c);
+        stalls.push_back(ms_between(t0, Clock::now()));
+    }
+    double total = ms_between(start, Clock::now());
+    double sum = 0;
+    for (double s : stalls) sum += s;
+    return {sum / stalls.size(), *std::max_element(stalls.begin(), stalls.end()), total};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    using namespace BinarySerialization;
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 500000;
+    const int checkpoints = 10;
+    const double workMs = 50;
+    std::vector<Record> state(n);
+    for (size_t i = 0; i < n; ++i) {
+        state[i].id = static_cast<int>(i);
+        state[i].name = "record-" + std::to_string(i);
+        state[i].data.assign(i % 8, 0.5 * static_cast<double>(i));
+    }
+    BufferWriter probe;
+    serialize(state, probe);
+    std::printf("snapshot: %.1f MB, %d checkpoints, %.0f ms of work between them\n", probe.size() / 1048576.0,
+                checkpoints, workMs);
+    std::printf("%-22s %14s %14s %12s\n", "", "avg stall ms", "max stall ms", "total ms");
+    auto print = [](const char* label, const Row& r) {
+        std::printf("%-22s %14.2f %14.2f %12.1f\n", label, r.avgStall, r.maxStall, r.totalMs);
+    };
+
+    print("sync serialize", run(state, checkpoints, workMs, [&](int) { serialize(state, "bench_async.data"); }));
+    print("sync atomic + fsync", run(state, checkpoints, workMs, [&](int) {
+        BufferWriter buffer;
+        serialize(state, buffer);
+        detail::write_file_atomically("bench_async.data", buffer.data(), buffer.size());
+    }));
+    for (size_t depth : {1, 2, 4}) {
+        AsyncFileWriter writer(depth);
+        std::vector<std::future<void>> pending;
+        Row row = run(state, checkpoints, workMs, [&](int) {
+            pending.push_back(serialize_async(state, "bench_async.data", writer));
+        });
+        auto t0 = Clock::now();
+        for (auto& f : pending) f.get();
+        row.totalMs += ms_between(t0, Clock::now());
+        char label[32];
+        std::snprintf(label, sizeof(label), "async depth %zu", depth);
+        print(label, row);
+    }
+
+    std::remove("bench_async.data");
+    return 0;
+}
@@ -0,0 +1,61 @@
+// 小结构体热路径：std::ostringstream / std::istringstream vs BufferWriter / BufferReader
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "binary_serialization.h"
+#include "bench_timing.h"
+
+struct SmallRecord {
+    int id;
+    double price;
+    long long timestamp;
+    std::string symbol;
+    BINARY_SERIALIZABLE(id, price, timestamp, symbol)
+};
+
+namespace {
+
+void report(const char* label, size_t n, double streamMs, double bufferMs) {
+    std::printf("%-22s %10.1f ns/op %10.1f ns/op %8.1fx\n",
+                label, streamMs * 1e6 / n, bufferMs * 1e6 / n, streamMs / bufferMs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    const int reps = 5;
+    std::vector<SmallRecord> records(n);
+    for (size_t i = 0; i < n; ++i) {
+        records[i] = {static_cast<int>(i), i * 0.25, static_cast<long long>(i) * 1000, "SYM" + std::to_string(i % 100)};
+    }
+
+    std::string streamWire;
+    double streamMs = best_ms(reps, [&] {
+        std::ostringstream os;
+        for (const auto& r : records) BinarySerialization::serialize(r, os);
+        streamWire = os.str();
+    });
+    BinarySerialization::BufferWriter writer;
+    double bufferMs = best_ms(reps, [&] {
+        writer.clear();
+        for (const auto& r : records) BinarySerialization::serialize(r, writer);
+    });
+    if (writer.str() != streamWire) std::printf("  wire mismatch between stream and buffer\n");
+    std::printf("records: %zu, %zu bytes, best of %d\n", n, writer.size(), reps);
+    std::printf("%-22s %16s %16s %9s\n", "case", "iostream", "buffer", "speedup");
+    report("serialize", n, streamMs, bufferMs);
+
+    SmallRecord out;
+    streamMs = best_ms(reps, [&] {
+        std::istringstream is(streamWire);
+        for (size_t i = 0; i < n; ++i) BinarySerialization::deserialize(out, is);
+    });
+    bufferMs = best_ms(reps, [&] {
+        BinarySerialization::BufferReader reader(writer.data(), writer.size());
+        for (size_t i = 0; i < n; ++i) BinarySerialization::deserialize(out, reader);
+    });
+    report("deserialize", n, streamMs, bufferMs);
+    return 0;
+}
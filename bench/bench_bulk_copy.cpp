@@ -0,0 +1,114 @@
+// 批量拷贝快速路径前后对比：逐元素 write/read（旧实现） vs 整段 write/read（当前实现）
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "binary_serialization.h"
+#include "bench_timing.h"
+
+struct UserDefinedType {
+    int idx;
+    std::string name;
+    std::vector<double> data;
+    BINARY_SERIALIZABLE(idx, name, data)
+};
+
+namespace {
+
+// 旧实现：长度前缀 + 每个元素一次 os.write / is.read
+template<typename T>
+void serialize_per_element(const std::vector<T>& v, std::ostream& os) {
+    size_t size = v.size();
+    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    for (const auto& item : v) os.write(reinterpret_cast<const char*>(&item), sizeof(T));
+}
+
+template<typename T>
+void deserialize_per_element(std::vector<T>& v, std::istream& is) {
+    size_t size;
+    is.read(reinterpret_cast<char*>(&size), sizeof(size));
+    v.resize(size);
+    for (auto& item : v) is.read(reinterpret_cast<char*>(&item), sizeof(T));
+}
+
+void report(const char* label, size_t bytes, double beforeMs, double afterMs) {
+    double mb = bytes / (1024.0 * 1024.0);
+    std::printf("%-28s %10.1f MB/s %10.1f MB/s %8.1fx\n",
+                label, mb / (beforeMs / 1000.0), mb / (afterMs / 1000.0), beforeMs / afterMs);
+}
+
+template<typename T>
+void bench_vector(const char* name, size_t n, int reps) {
+    std::vector<T> src(n);
+    for (size_t i = 0; i < n; ++i) src[i] = static_cast<T>(i * 3 + 1);
+    std::vector<T> dst;
+    std::string label;
+
+    std::string wire;
+    double before = best_ms(reps, [&] {
+        std::ostringstream os;
+        serialize_per_element(src, os);
+        wire = os.str();
+    });
+    double after = best_ms(reps, [&] {
+        std::ostringstream os;
+        BinarySerialization::serialize(src, os);
+        wire = os.str();
+    });
+    label = std::string(name) + " serialize";
+    report(label.c_str(), wire.size(), before, after);
+
+    before = best_ms(reps, [&] {
+        std::istringstream is(wire);
+        deserialize_per_element(dst, is);
+    });
+    after = best_ms(reps, [&] {
+        std::istringstream is(wire);
+        BinarySerialization::deserialize(dst, is);
+    });
+    if (dst != src) std::printf("  round-trip mismatch for %s\n", name);
+    label = std::string(name) + " deserialize";
+    report(label.c_str(), wire.size(), before, after);
+}
+
+void bench_user_defined(size_t n, int reps) {
+    UserDefinedType src{7, "samples", std::vector<double>(n)};
+    for (size_t i = 0; i < n; ++i) src.data[i] = i * 0.5;
+    UserDefinedType dst;
+
+    // 旧实现下 data 成员走逐元素路径，其余成员不变
+    auto old_serialize = [&](std::ostream& os) {
+        BinarySerialization::serialize(src.idx, os);
+        BinarySerialization::serialize(src.name, os);
+        serialize_per_element(src.data, os);
+    };
+    auto old_deserialize = [&](std::istream& is) {
+        BinarySerialization::deserialize(dst.idx, is);
+        BinarySerialization::deserialize(dst.name, is);
+        deserialize_per_element(dst.data, is);
+    };
+
+    std::string wire;
+    double before = best_ms(reps, [&] { std::ostringstream os; old_serialize(os); wire = os.str(); });
+    double after = best_ms(reps, [&] { std::ostringstream os; BinarySerialization::serialize(src, os); wire = os.str(); });
+    report("UserDefinedType serialize", wire.size(), before, after);
+
+    before = best_ms(reps, [&] { std::istringstream is(wire); old_deserialize(is); });
+    after = best_ms(reps, [&] { std::istringstream is(wire); BinarySerialization::deserialize(dst, is); });
+    if (dst.data != src.data) std::printf("  round-trip mismatch for UserDefinedType\n");
+    report("UserDefinedType deserialize", wire.size(), before, after);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 10000000;
+    const int reps = 5;
+    std::printf("elements: %zu, best of %d\n", n, reps);
+    std::printf("%-28s %15s %15s %9s\n", "case", "per-element", "bulk", "speedup");
+    bench_vector<int>("vector<int>", n, reps);
+    bench_vector<float>("vector<float>", n, reps);
+    bench_vector<double>("vector<double>", n, reps);
+    bench_user_defined(n, reps);
+    return 0;
+}
@@ -0,0 +1,106 @@
+// 行式 vs 列式：std::vector<Record> 按普通格式（逐元素交错写出成员）与 serialize_columnar（每个成员一列）
+// 的大小、编码/全量解码耗时，以及只需要 idx 的扫描（行式必须整体解码，列式只解码 idx 一列）
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "binary_serialization.h"
+#include "binary_columnar.h"
+#include "bench_timing.h"
+
+struct Record {
+    int idx;
+    std::string name;
+    std::vector<double> data;
+    BINARY_SERIALIZABLE(idx, name, data)
+
+    bool operator==(const Record& other) const {
+        return idx == other.idx && name == other.name && data == other.data;
+    }
+};
+
+namespace {
+
+long long sum_idx(const std::vector<Record>& v) {
+    long long sum = 0;
+    for (const auto& r : v) sum += r.idx;
+    return sum;
+}
+
+volatile long long sink;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    using namespace BinarySerialization;
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const int reps = 5;
+    std::vector<Record> records(n);
+    for (size_t i = 0; i < n; ++i) {
+        records[i].idx = static_cast<int>(i);
+        records[i].name = "record-" + std::to_string(i);
+        records[i].data.assign(i % 8, 0.5 * static_cast<double>(i));
+    }
+    long long expected = sum_idx(records);
+
+    // 编码和解码每次都使用新的缓冲区 / vector，两种格式都不复用上一轮的容量
+    BufferWriter rows, columns, compactColumns;
+    double rowEncode = best_ms(reps, [&] {
+        BufferWriter out;
+        serialize(records, out);
+        rows = std::move(out);
+    });
+    double colEncode = best_ms(reps, [&] {
+        BufferWriter out;
+        serialize_columnar(records, out);
+        columns = std::move(out);
+    });
+    CompactWriter<BufferWriter> compact(compactColumns);
+    serialize_columnar(records, compact);
+
+    bool ok = true;
+    double rowDecode = best_ms(reps, [&] {
+        std::vector<Record> loaded;
+        BufferReader reader(rows.data(), rows.size());
+        deserialize(loaded, reader);
+        ok = ok && loaded == records;
+    });
+    double colDecode = best_ms(reps, [&] {
+        std::vector<Record> loaded;
+        BufferReader reader(columns.data(), columns.size());
+        deserialize_columnar(loaded, reader);
+        ok = ok && loaded == records;
+    });
+
+    double rowScan = best_ms(reps, [&] {
+        std::vector<Record> loaded;
+        BufferReader reader(rows.data(), rows.size());
+        deserialize(loaded, reader);
+        sink = sum_idx(loaded);
+        ok = ok && sink == expected;
+    });
+    double colScan = best_ms(reps, [&] {
+        std::vector<Record> loaded;
+        BufferReader reader(columns.data(), columns.size());
+        deserialize_columns(loaded, reader, &Record::idx);
+        sink = sum_idx(loaded);
+        ok = ok && sink == expected;
+    });
+    double compactScan = best_ms(reps, [&] {
+        std::vector<Record> loaded;
+        BufferReader reader(compactColumns.data(), compactColumns.size());
+        CompactReader<BufferReader> in(reader);
+        deserialize_columns(loaded, in, &Record::idx);
+        sink = sum_idx(loaded);
+        ok = ok && sink == expected;
+    });
+
+    std::printf("records: %zu, best of %d\n", n, reps);
+    std::printf("%-18s %10s %10s %12s %12s\n", "", "MB", "encode ms", "decode ms", "idx scan ms");
+    std::printf("%-18s %10.1f %10.1f %12.1f %12.1f\n", "row", rows.size() / 1048576.0, rowEncode, rowDecode, rowScan);
+    std::printf("%-18s %10.1f %10.1f %12.1f %12.1f\n", "columnar", columns.size() / 1048576.0, colEncode, colDecode,
+                colScan);
+    std::printf("%-18s %10.1f %10s %12s %12.1f\n", "columnar compact", compactColumns.size() / 1048576.0, "", "",
+                compactScan);
+    if (!ok) std::printf("round-trip mismatch\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+// 周期性检查点：每次写完整快照（serialize + 原子写）vs DeltaCheckpointer 只追加增量。
+// 每两次检查点之间修改一小部分状态，比较每次检查点的耗时与写盘字节数，以及最后从快照 + 增量恢复的耗时
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "binary_serialization.h"
+#include "binary_delta.h"
+#include "bench_timing.h"
+
+struct Account {
+    int64_t balance;
+    std::string owner;
+    std::vector<int> tags;
+    BINARY_SERIALIZABLE(balance, owner, tags)
+};
+
+struct State {
+    std::map<int, Account> accounts;
+    std::vector<double> prices;
+    BINARY_SERIALIZABLE(accounts, prices)
+};
+
+namespace {
+
+// 修改约 fraction 比例的账户余额与价格，并增删少量账户
+void mutate(State& s, double fraction, std::mt19937& rng) {
+    size_t n = s.accounts.size();
+    size_t changes = static_cast<size_t>(n * fraction) + 1;
+    for (size_t i = 0; i < changes; ++i) {
+        auto it = s.accounts.find(static_cast<int>(rng() % n));
+        if (it != s.accounts.end()) it->second.balance += 1;
+        s.prices[rng() % s.prices.size()] *= 1.001;
+    }
+    s.accounts.erase(static_cast<int>(rng() % n));
+    s.accounts[static_cast<int>(n + rng() % 1000)] = {0, "new", {}};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    using namespace BinarySerialization;
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 500000;
+    const int checkpoints = 20;
+    State state;
+    for (size_t i = 0; i < n; ++i) {
+        state.accounts[static_cast<int>(i)] = {static_cast<int64_t>(i) * 100, "owner-" + std::to_string(i),
+                                               std::vector<int>(i % 4, 7)};
+    }
+    state.prices.assign(n * 4, 1.0);
+    std::printf("state: %.1f MB, %d checkpoints\n", serialized_size(state) / 1048576.0, checkpoints);
+    std::printf("%-10s %-24s %12s %14s %12s\n", "changed", "", "avg ms", "avg bytes", "restore ms");
+
+    for (double fraction : {0.0001, 0.001, 0.01}) {
+        char label[16];
+        std::snprintf(label, sizeof(label), "%.2f%%", fraction * 100);
+
+        State full = state;
+        std::mt19937 rng(1);
+        double ms = 0;
+        size_t bytes = 0;
+        for (int c = 0; c < checkpoints; ++c) {
+            mutate(full, fraction, rng);
+            auto t0 = std::chrono::steady_clock::now();
+            BufferWriter buffer = serialize_to_buffer(full);
+            detail::write_file_atomically("bench_delta_full.data", buffer.data(), buffer.size());
+            ms += ms_since(t0);
+            bytes += buffer.size();
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        State restored;
+        deserialize(restored, "bench_delta_full.data");
+        double restoreMs = ms_since(t0);
+        std::printf("%-10s %-24s %12.2f %14zu %12.1f\n", label, "full snapshot", ms / checkpoints, bytes / checkpoints,
+                    restoreMs);
+
+        std::remove("bench_delta.data");
+        std::remove("bench_delta.data.delta");
+        State incremental = state;
+        rng.seed(1);
+        ms = 0;
+        bytes = 0;
+        {
+            DeltaCheckpointer<State> writer("bench_delta.data", checkpoints);
+            writer.checkpoint(incremental);
+            for (int c = 0; c < checkpoints; ++c) {
+                mutate(incremental, fraction, rng);
+                auto t1 = std::chrono::steady_clock::now();
+                writer.checkpoint(incremental);
+                ms += ms_since(t1);
+                bytes += writer.last_checkpoint_bytes();
+            }
+        }
+        t0 = std::chrono::steady_clock::now();
+        DeltaCheckpointer<State> reader("bench_delta.data");
+        State replayed;
+        reader.load(replayed);
+        restoreMs = ms_since(t0);
+        std::printf("%-10s %-24s %12.2f %14zu %12.1f\n", label, "DeltaCheckpointer", ms / checkpoints,
+                    bytes / checkpoints, restoreMs);
+        if (!delta_equal(replayed, incremental) || !delta_equal(restored, full)) {
+            std::printf("restore mismatch\n");
+            return 1;
+        }
+    }
+
+    std::remove("bench_delta_full.data");
+    std::remove("bench_delta.data");
+    std::remove("bench_delta.data.delta");
+    return 0;
+}
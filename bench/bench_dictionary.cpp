@@ -0,0 +1,134 @@
+// 重复字符串较多的数据（Zipf 分布的租户 ID / 指标名）：默认模式、紧凑模式与字典模式的编码大小、编码与解码耗时。
+// 解码分别读回拥有型的 std::string 与指向缓冲区/字典项的 std::string_view
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "binary_serialization.h"
+#include "bench_timing.h"
+
+namespace {
+
+using namespace BinarySerialization;
+
+// 取值 [0, n) 的 Zipf(s) 分布
+class Zipf {
+public:
+    Zipf(size_t n, double s) : cdf_(n) {
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) cdf_[i] = sum += 1.0 / std::pow(static_cast<double>(i + 1), s);
+        for (double& c : cdf_) c /= sum;
+    }
+
+    size_t operator()(std::mt19937_64& rng) {
+        double u = std::uniform_real_distribution<double>(0, 1)(rng);
+        return static_cast<size_t>(std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin()) % cdf_.size();
+    }
+
+private:
+    std::vector<double> cdf_;
+};
+
+enum Mode { Default, Compact, Dictionary, CompactDictionary };
+const char* kModeNames[] = {"default", "compact", "dictionary", "compact + dictionary"};
+
+template<typename T>
+void encode(const T& value, Mode mode, BufferWriter& out) {
+    CompactWriter<BufferWriter> compact(out);
+    if (mode == Default) {
+        serialize(value, out);
+    } else if (mode == Compact) {
+        serialize(value, compact);
+    } else if (mode == Dictionary) {
+        DictionaryWriter<BufferWriter> dict(out);
+        serialize(value, dict);
+    } else {
+        DictionaryWriter<CompactWriter<BufferWriter>> dict(compact);
+        serialize(value, dict);
+    }
+}
+
+template<typename T>
+void decode(T& value, Mode mode, BufferReader& in) {
+    CompactReader<BufferReader> compact(in);
+    if (mode == Default) {
+        deserialize(value, in);
+    } else if (mode == Compact) {
+        deserialize(value, compact);
+    } else if (mode == Dictionary) {
+        DictionaryReader<BufferReader> dict(in);
+        deserialize(value, dict);
+    } else {
+        DictionaryReader<CompactReader<BufferReader>> dict(compact);
+        deserialize(value, dict);
+    }
+}
+
+// Views：额外测一次解码到 string_view 的耗时（string_view 指向缓冲区或字典项，不分配）
+template<typename T, typename Views = void>
+bool run(const char* label, const T& value) {
+    bool ok = true;
+    for (Mode mode : {Default, Compact, Dictionary, CompactDictionary}) {
+        BufferWriter buffer;
+        double encodeMs = best_ms(3, [&] {
+            buffer.clear();
+            encode(value, mode, buffer);
+        });
+        T decoded;
+        double decodeMs = best_ms(3, [&] {
+            decoded = T();
+            BufferReader reader(buffer.data(), buffer.size());
+            decode(decoded, mode, reader);
+        });
+        ok = ok && decoded == value;
+        std::printf("%-34s %-22s %9.2f %10.1f %10.1f", label, kModeNames[mode], buffer.size() / 1048576.0, encodeMs,
+                    decodeMs);
+        if constexpr (!std::is_void<Views>::value) {
+            Views views;
+            double viewMs = best_ms(3, [&] {
+                views = Views();
+                BufferReader reader(buffer.data(), buffer.size());
+                decode(views, mode, reader);
+            });
+            std::printf(" %10.1f", viewMs);
+        }
+        std::printf("\n");
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    std::mt19937_64 rng(42);
+
+    std::vector<std::string> tenants(1000), metrics(500);
+    for (size_t i = 0; i < tenants.size(); ++i) tenants[i] = "tenant-" + std::to_string(100000 + i) + "-eu-west-1";
+    for (size_t i = 0; i < metrics.size(); ++i) metrics[i] = "http.server.requests.duration." + std::to_string(i);
+
+    Zipf tenantDist(tenants.size(), 1.1), metricDist(metrics.size(), 1.1);
+    std::vector<std::string> ids(n);
+    for (auto& id : ids) id = tenants[tenantDist(rng)];
+    std::vector<std::map<std::string, double>> rows(n / 10);
+    for (auto& row : rows) {
+        for (int k = 0; k < 8; ++k) row[metrics[metricDist(rng)]] = 1.0;
+    }
+    std::vector<std::set<std::string>> tagSets(n / 10);
+    for (auto& tags : tagSets) {
+        for (int k = 0; k < 4; ++k) tags.insert(tenants[tenantDist(rng)]);
+    }
+
+    std::printf("%-34s %-22s %9s %10s %10s %10s\n", "", "", "MB", "encode ms", "decode ms", "views ms");
+    bool ok = run<std::vector<std::string>, std::vector<std::string_view>>("vector<string> (2M tenant ids)", ids);
+    ok = run("vector<map<string, double>> (200k)", rows) && ok;
+    ok = run("vector<set<string>> (200k)", tagSets) && ok;
+    if (!ok) std::printf("round-trip mismatch\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+// 对象图序列化：
+// 1. 大量记录共享少量大对象（std::shared_ptr<Blob>）：按值复制（旧的变通做法）vs GraphWriter（每个对象只写一次）
+// 2. 随机 DAG（每个节点指向两个更早的节点）与单链表的编码 / 解码耗时随节点数的变化，检查是否为线性
+// 3. 指针表本身：开放寻址表（GraphWriter）vs std::unordered_map<const void*, uint64_t> 的插入 + 查找
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "binary_serialization.h"
+#include "bench_timing.h"
+
+namespace {
+
+using namespace BinarySerialization;
+
+struct Blob {
+    std::string name;
+    std::vector<double> samples;
+    BINARY_SERIALIZABLE(name, samples)
+};
+
+struct Record {
+    int id = 0;
+    std::shared_ptr<Blob> blob;
+    BINARY_SERIALIZABLE(id, blob)
+};
+
+// 旧的变通做法：把被指向的对象按值复制进记录
+struct RecordByValue {
+    int id = 0;
+    Blob blob;
+    BINARY_SERIALIZABLE(id, blob)
+};
+
+struct Node {
+    int64_t value = 0;
+    std::shared_ptr<Node> left;
+    std::shared_ptr<Node> right;
+    BINARY_SERIALIZABLE(value, left, right)
+};
+
+void shared_payloads(size_t records, size_t blobs) {
+    std::vector<std::shared_ptr<Blob>> pool(blobs);
+    for (size_t i = 0; i < blobs; ++i)
+        pool[i] = std::make_shared<Blob>(Blob{"blob-" + std::to_string(i), std::vector<double>(64, 0.5 * i)});
+    std::mt19937_64 rng(7);
+    std::vector<Record> shared(records);
+    std::vector<RecordByValue> copied(records);
+    for (size_t i = 0; i < records; ++i) {
+        shared[i] = {static_cast<int>(i), pool[rng() % blobs]};
+        copied[i] = {static_cast<int>(i), *shared[i].blob};
+    }
+
+    BufferWriter valueBuffer, graphBuffer;
+    double valueEncode = best_ms(3, [&] {
+        valueBuffer.clear();
+        serialize(copied, valueBuffer);
+    });
+    double graphEncode = best_ms(3, [&] {
+        graphBuffer.clear();
+        GraphWriter<BufferWriter> graph(graphBuffer);
+        serialize(shared, graph);
+    });
+    std::vector<RecordByValue> copiedBack;
+    double valueDecode = best_ms(3, [&] {
+        BufferReader reader(valueBuffer.data(), valueBuffer.size());
+        deserialize(copiedBack, reader);
+    });
+    std::vector<Record> sharedBack;
+    double graphDecode = best_ms(3, [&] {
+        BufferReader reader(graphBuffer.data(), graphBuffer.size());
+        GraphReader<BufferReader> graph(reader);
+        deserialize(sharedBack, graph);
+    });
+    bool ok = sharedBack.size() == records && sharedBack[0].blob->samples == shared[0].blob->samples;
+
+    std::printf("%zu records sharing %zu blobs (64 doubles each)\n", records, blobs);
+    std::printf("%-24s %10s %10s %10s\n", "", "MB", "encode ms", "decode ms");
+    std::printf("%-24s %10.1f %10.1f %10.1f\n", "copied by value", valueBuffer.size() / 1048576.0, valueEncode,
+                valueDecode);
+    std::printf("%-24s %10.1f %10.1f %10.1f%s\n\n", "shared_ptr + GraphWriter", graphBuffer.size() / 1048576.0,
+                graphEncode, graphDecode, ok ? "" : "  (mismatch)");
+}
+
+// 随机 DAG：节点 i 指向两个更早的节点。返回全部节点，最新的在前（从它开始写，大部分节点经由队列写出）；
+// 向量持有全部节点，析构时不会沿指针递归
+std::vector<std::shared_ptr<Node>> make_dag(size_t n) {
+    std::vector<std::shared_ptr<Node>> nodes(n);
+    std::mt19937_64 rng(11);
+    for (size_t i = 0; i < n; ++i) {
+        nodes[i] = std::make_shared<Node>();
+        nodes[i]->value = static_cast<int64_t>(i);
+        if (i > 0) {
+            nodes[i]->left = nodes[rng() % i];
+            nodes[i]->right = nodes[rng() % i];
+        }
+    }
+    return std::vector<std::shared_ptr<Node>>(nodes.rbegin(), nodes.rend());
+}
+
+// 单链表，头节点在前：每个节点的后继都在写前一个节点时第一次遇到
+std::vector<std::shared_ptr<Node>> make_chain(size_t n) {
+    std::vector<std::shared_ptr<Node>> nodes(n);
+    for (size_t i = n; i-- > 0;) {
+        nodes[i] = std::make_shared<Node>();
+        nodes[i]->value = static_cast<int64_t>(i);
+        if (i + 1 < n) nodes[i]->right = nodes[i + 1];
+    }
+    return nodes;
+}
+
+void scaling(const char* label, std::vector<std::shared_ptr<Node>> (*make)(size_t), size_t maxNodes) {
+    std::printf("%-8s %10s %10s %12s %12s\n", label, "nodes", "MB", "encode ns/n", "decode ns/n");
+    for (size_t n = maxNodes / 16; n <= maxNodes; n *= 4) {
+        std::vector<std::shared_ptr<Node>> roots = make(n);
+        BufferWriter buffer;
+        double encode = best_ms(2, [&] {
+            buffer.clear();
+            GraphWriter<BufferWriter> graph(buffer);
+            serialize(roots, graph);
+        });
+        std::vector<std::shared_ptr<Node>> back;
+        double decode = best_ms(2, [&] {
+            back.clear();
+            BufferReader reader(buffer.data(), buffer.size());
+            GraphReader<BufferReader> graph(reader);
+            deserialize(back, graph);
+        });
+        bool ok = back.size() == n && back.back()->value == roots.back()->value;
+        std::printf("%-8s %10zu %10.1f %12.1f %12.1f%s\n", "", n, buffer.size() / 1048576.0, encode * 1e6 / n,
+                    decode * 1e6 / n, ok ? "" : "  (mismatch)");
+    }
+    std::printf("\n");
+}
+
+void pointer_tables(size_t n) {
+    std::vector<std::unique_ptr<int64_t>> objects(n);
+    for (auto& p : objects) p.reset(new int64_t(0));
+    std::mt19937_64 rng(3);
+    std::vector<const void*> lookups(n * 2);
+    for (size_t i = 0; i < lookups.size(); ++i) lookups[i] = objects[i < n ? i : rng() % n].get();
+    const void* type = detail::graph_type_key<int64_t>();
+
+    double openAddressing = best_ms(3, [&] {
+        SizeCounter sink;
+        GraphWriter<SizeCounter> graph(sink);
+        for (const void* p : lookups) graph.write_pointer(p, type);
+    });
+    double unorderedMap = best_ms(3, [&] {
+        std::unordered_map<const void*, uint64_t> ids;
+        uint64_t checksum = 0;
+        for (const void* p : lookups) checksum += ids.emplace(p, ids.size()).first->second;
+        if (checksum == 1) std::printf(" ");
+    });
+    std::printf("pointer table, %zu objects, %zu lookups: open addressing %.1f ms, std::unordered_map %.1f ms\n", n,
+                lookups.size(), openAddressing, unorderedMap);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t maxNodes = argc > 1 ? std::stoul(argv[1]) : 4000000;
+    shared_payloads(1000000, 1000);
+    scaling("DAG", make_dag, maxNodes);
+    scaling("chain", make_chain, maxNodes);
+    pointer_tables(maxNodes);
+    return 0;
+}
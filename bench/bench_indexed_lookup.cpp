@@ -0,0 +1,99 @@
+// 大快照中的少量查找：整体 deserialize 后查 vs 带索引文件（IndexedMapReader / IndexedVectorReader）只解码访问到的条目
+// 每行包含打开（或整体加载）的时间和 1000 次随机查找的时间
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "binary_serialization.h"
+#include "binary_indexed.h"
+#include "bench_timing.h"
+
+int main(int argc, char** argv) {
+    using namespace BinarySerialization;
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t queries = 1000;
+    std::map<int, std::string> table;
+    std::vector<std::string> rows(n);
+    for (size_t i = 0; i < n; ++i) {
+        table.emplace(static_cast<int>(i * 2), "value-" + std::to_string(i));
+        rows[i] = "row-" + std::to_string(i) + std::string(i % 32, '.');
+    }
+    serialize(table, "bench_map_plain.data");
+    serialize_indexed(table, "bench_map_indexed.data");
+    serialize(rows, "bench_vec_plain.data");
+    serialize_indexed(rows, "bench_vec_indexed.data");
+
+    std::mt19937 rng(7);
+    std::vector<int> keys(queries);
+    std::vector<size_t> positions(queries);
+    for (size_t q = 0; q < queries; ++q) {
+        positions[q] = rng() % n;
+        keys[q] = static_cast<int>(positions[q] * 2 + (q % 4 == 0 ? 1 : 0));  // 四分之一查不到
+    }
+
+    bool ok = true;
+    size_t hits = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    std::map<int, std::string> loaded;
+    deserialize(loaded, "bench_map_plain.data");
+    double mapLoad = ms_since(t0);
+    t0 = std::chrono::steady_clock::now();
+    for (int key : keys) hits += loaded.count(key);
+    double mapLookup = ms_since(t0);
+
+    size_t indexedHits = 0;
+    t0 = std::chrono::steady_clock::now();
+    IndexedMapReader<int, std::string> mapReader("bench_map_indexed.data");
+    double mapOpen = ms_since(t0);
+    t0 = std::chrono::steady_clock::now();
+    std::string value;
+    for (int key : keys) {
+        if (mapReader.find(key, value)) {
+            ++indexedHits;
+            ok = ok && value == table[key];
+        }
+    }
+    double mapFind = ms_since(t0);
+    ok = ok && hits == indexedHits;
+
+    t0 = std::chrono::steady_clock::now();
+    std::vector<std::string> loadedRows;
+    deserialize(loadedRows, "bench_vec_plain.data");
+    double vecLoad = ms_since(t0);
+    t0 = std::chrono::steady_clock::now();
+    size_t bytes = 0;
+    for (size_t i : positions) bytes += loadedRows[i].size();
+    double vecLookup = ms_since(t0);
+
+    t0 = std::chrono::steady_clock::now();
+    IndexedVectorReader<std::string> vecReader("bench_vec_indexed.data");
+    double vecOpen = ms_since(t0);
+    t0 = std::chrono::steady_clock::now();
+    size_t indexedBytes = 0;
+    for (size_t i : positions) {
+        vecReader.read(i, value);
+        indexedBytes += value.size();
+    }
+    double vecFind = ms_since(t0);
+    ok = ok && bytes == indexedBytes;
+
+    std::printf("entries: %zu, queries: %zu (map: %zu hits)\n", n, queries, hits);
+    std::printf("%-24s %14s %14s %14s\n", "", "open/load ms", "queries ms", "us/query");
+    std::printf("%-24s %14.2f %14.3f %14.3f\n", "map: deserialize + find", mapLoad, mapLookup,
+                (mapLoad + mapLookup) * 1000.0 / queries);
+    std::printf("%-24s %14.3f %14.3f %14.3f\n", "map: IndexedMapReader", mapOpen, mapFind,
+                (mapOpen + mapFind) * 1000.0 / queries);
+    std::printf("%-24s %14.2f %14.3f %14.3f\n", "vector: deserialize + []", vecLoad, vecLookup,
+                (vecLoad + vecLookup) * 1000.0 / queries);
+    std::printf("%-24s %14.3f %14.3f %14.3f\n", "vector: IndexedVector", vecOpen, vecFind,
+                (vecOpen + vecFind) * 1000.0 / queries);
+
+    std::remove("bench_map_plain.data");
+    std::remove("bench_map_indexed.data");
+    std::remove("bench_vec_plain.data");
+    std::remove("bench_vec_indexed.data");
+    if (!ok) std::printf("lookup mismatch\n");
+    return ok ? 0 : 1;
+}
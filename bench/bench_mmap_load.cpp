@@ -0,0 +1,68 @@
+// 启动加载耗时：std::ifstream 逐字段读取 vs 内存映射解码到拥有型类型 vs 内存映射解码到视图类型
+// 注意：测的是页缓存命中时的耗时（文件刚写完），冷盘读取的差距取决于存储设备
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "binary_serialization.h"
+#include "bench_timing.h"
+
+struct Record {
+    int id;
+    std::string name;
+    std::vector<double> samples;
+    BINARY_SERIALIZABLE(id, name, samples)
+};
+
+// 与 Record 线上格式相同，字符串和数组直接指向映射区
+struct RecordView {
+    int id;
+    std::string_view name;
+    BinarySerialization::ArrayView<double> samples;
+    BINARY_SERIALIZABLE(id, name, samples)
+};
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const char* path = "bench_mmap_load.data";
+    const int reps = 5;
+
+    std::vector<Record> snapshot(n);
+    for (size_t i = 0; i < n; ++i) {
+        snapshot[i].id = static_cast<int>(i);
+        snapshot[i].name = "record-" + std::to_string(i);
+        snapshot[i].samples.assign(8 + i % 24, i * 0.5);
+    }
+    BinarySerialization::serialize(snapshot, path);
+    std::ifstream probe(path, std::ios::binary | std::ios::ate);
+    double mb = static_cast<double>(probe.tellg()) / (1024.0 * 1024.0);
+    probe.close();
+    std::printf("records: %zu, file: %.1f MB, best of %d (page cache warm)\n", n, mb, reps);
+
+    size_t checksum = 0;
+    double ifstreamMs = best_ms(reps, [&] {
+        std::vector<Record> loaded;
+        std::ifstream ifs(path, std::ios::binary);
+        BinarySerialization::deserialize(loaded, ifs);
+        checksum += loaded.size();
+    });
+    double mappedMs = best_ms(reps, [&] {
+        std::vector<Record> loaded;
+        BinarySerialization::deserialize(loaded, std::string(path));
+        checksum += loaded.size();
+    });
+    double viewMs = best_ms(reps, [&] {
+        BinarySerialization::MappedFile file(path);
+        std::vector<RecordView> loaded;
+        BinarySerialization::deserialize(loaded, file);
+        checksum += loaded.size();
+    });
+
+    std::printf("%-26s %10.1f ms %10.1f MB/s\n", "ifstream -> owning", ifstreamMs, mb / (ifstreamMs / 1000.0));
+    std::printf("%-26s %10.1f ms %10.1f MB/s\n", "mmap -> owning", mappedMs, mb / (mappedMs / 1000.0));
+    std::printf("%-26s %10.1f ms %10.1f MB/s\n", "mmap -> views", viewMs, mb / (viewMs / 1000.0));
+    std::printf("(checksum %zu)\n", checksum);
+    std::remove(path);
+    return 0;
+}
@@ -0,0 +1,123 @@
+// 节点容器反序列化的分配次数与耗时：旧实现（临时对象 + 无提示插入） vs 提示插入 + 移动 vs std::pmr 单 arena
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include "binary_serialization.h"
+
+// 替换后的 operator new/delete 都基于 malloc/free，GCC 内联后会误报 new/free 不匹配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace {
+
+size_t g_allocations = 0;
+
+} // namespace
+
+void* operator new(size_t size) {
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { ::operator delete(p); }
+
+namespace {
+
+using BinarySerialization::BufferReader;
+using BinarySerialization::BufferWriter;
+
+// 统计上游分配次数的 memory_resource
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t align) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// 旧实现：每个元素构造临时 key/value，再做一次完整查找插入
+template<typename K, typename V>
+void deserialize_map_baseline(std::map<K, V>& m, BufferReader& is) {
+    size_t size = BinarySerialization::read_length(is);
+    m.clear();
+    for (size_t i = 0; i < size; ++i) {
+        K key;
+        V value;
+        BinarySerialization::deserialize(key, is);
+        BinarySerialization::deserialize(value, is);
+        m.emplace(std::move(key), std::move(value));
+    }
+}
+
+void report(const char* label, size_t allocations, double ms, size_t n) {
+    std::printf("%-26s %14zu %10.2f %10.1f\n", label, allocations, double(allocations) / n, ms);
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 10000000;
+
+    BufferWriter wire;
+    {
+        std::map<int, std::string> source;
+        for (size_t i = 0; i < n; ++i) source.emplace_hint(source.end(), static_cast<int>(i), "tenant-metric-name-" + std::to_string(i));
+        BinarySerialization::serialize(source, wire);
+    }
+    std::printf("entries: %zu, wire: %.1f MB\n", n, wire.size() / (1024.0 * 1024.0));
+    std::printf("%-26s %14s %10s %10s\n", "decoder", "allocations", "per entry", "ms");
+
+    {
+        std::map<int, std::string> m;
+        BufferReader r(wire.data(), wire.size());
+        size_t before = g_allocations;
+        auto t0 = std::chrono::steady_clock::now();
+        deserialize_map_baseline(m, r);
+        report("temp + emplace (old)", g_allocations - before, elapsed_ms(t0), n);
+    }
+    {
+        std::map<int, std::string> m;
+        BufferReader r(wire.data(), wire.size());
+        size_t before = g_allocations;
+        auto t0 = std::chrono::steady_clock::now();
+        BinarySerialization::deserialize(m, r);
+        report("hinted + in-node", g_allocations - before, elapsed_ms(t0), n);
+    }
+    {
+        CountingResource upstream;
+        size_t before = g_allocations;
+        size_t arenaChunks = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        double decodeMs;
+        {
+            std::pmr::monotonic_buffer_resource arena(&upstream);
+            std::pmr::map<int, std::pmr::string> m(&arena);
+            BufferReader r(wire.data(), wire.size());
+            BinarySerialization::deserialize(m, r);
+            decodeMs = elapsed_ms(t0);
+            arenaChunks = upstream.allocations;
+        }
+        // arena 的上游块计入分配次数；析构时整块释放
+        report("pmr monotonic arena", g_allocations - before + arenaChunks, decodeMs, n);
+        std::printf("  (decode + single arena release: %.1f ms)\n", elapsed_ms(t0));
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+// 大容器并行分块编码/解码：普通单线程 serialize/deserialize vs serialize_chunked/deserialize_chunked，
+// 按线程数 1, 2, 4, 8, 16（不超过硬件并发数）给出耗时与相对单线程普通格式的加速比
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "binary_serialization.h"
+#include "binary_parallel.h"
+#include "bench_timing.h"
+
+struct Record {
+    int id;
+    std::string name;
+    std::vector<double> data;
+    BINARY_SERIALIZABLE(id, name, data)
+
+    bool operator==(const Record& other) const {
+        return id == other.id && name == other.name && data == other.data;
+    }
+};
+
+int main(int argc, char** argv) {
+    using namespace BinarySerialization;
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const int reps = 3;
+    std::vector<Record> records(n);
+    for (size_t i = 0; i < n; ++i) {
+        records[i].id = static_cast<int>(i);
+        records[i].name = "record-" + std::to_string(i);
+        records[i].data.assign(i % 8, 0.5 * static_cast<double>(i));
+    }
+
+    // 基线：普通格式，单线程
+    BufferWriter plain;
+    double plainEncode = best_ms(reps, [&] {
+        plain.clear();
+        serialize(records, plain);
+    });
+    std::vector<Record> loaded;
+    double plainDecode = best_ms(reps, [&] {
+        BufferReader reader(plain.data(), plain.size());
+        deserialize(loaded, reader);
+    });
+    bool ok = loaded == records;
+
+    unsigned hw = std::thread::hardware_concurrency();
+    std::printf("records: %zu, plain size %.1f MB, hardware threads: %u, best of %d\n",
+                n, plain.size() / 1048576.0, hw, reps);
+    std::printf("%-16s %10s %10s %10s %10s\n", "", "encode ms", "speedup", "decode ms", "speedup");
+    std::printf("%-16s %10.1f %10.2f %10.1f %10.2f\n", "plain", plainEncode, 1.0, plainDecode, 1.0);
+
+    for (size_t threads : {1, 2, 4, 8, 16}) {
+        if (threads > 1 && threads > hw) break;
+        ThreadPool pool(threads);
+        BufferWriter chunked;
+        double encode = best_ms(reps, [&] {
+            chunked.clear();
+            serialize_chunked(records, chunked, pool);
+        });
+        double decode = best_ms(reps, [&] {
+            BufferReader reader(chunked.data(), chunked.size());
+            deserialize_chunked(loaded, reader, pool);
+        });
+        ok = ok && loaded == records;
+        char label[32];
+        std::snprintf(label, sizeof(label), "chunked x%zu", threads);
+        std::printf("%-16s %10.1f %10.2f %10.1f %10.2f\n", label, encode, plainEncode / encode,
+                    decode, plainDecode / decode);
+    }
+
+    // 文件：编码并行、写入顺序；读取从内存映射并行解码
+    double fileEncode = best_ms(reps, [&] { serialize_chunked(records, "bench_chunked.data"); });
+    double fileDecode = best_ms(reps, [&] { deserialize_chunked(loaded, "bench_chunked.data"); });
+    ok = ok && loaded == records;
+    double plainFileEncode = best_ms(reps, [&] { serialize(records, "bench_plain.data"); });
+    double plainFileDecode = best_ms(reps, [&] { deserialize(loaded, "bench_plain.data"); });
+    std::printf("%-16s %10.1f %10s %10.1f\n", "file plain", plainFileEncode, "", plainFileDecode);
+    std::printf("%-16s %10.1f %10.2f %10.1f %10.2f\n", "file chunked", fileEncode, plainFileEncode / fileEncode,
+                fileDecode, plainFileDecode / fileDecode);
+
+    std::remove("bench_chunked.data");
+    std::remove("bench_plain.data");
+    if (!ok) std::printf("round-trip mismatch\n");
+    return ok ? 0 : 1;
+}
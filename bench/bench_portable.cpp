@@ -0,0 +1,98 @@
+// 可移植模式的吞吐：默认模式（原生表示）vs PortableWriter 小端（x86 上无需转换）vs PortableWriter 大端
+// （强制走字节序转换路径，模拟大端主机读写规范小端格式的开销），以及 byteswap_copy 与逐元素标量版本的对比。
+// 向量内核需要在构建时启用（-mssse3 / -mavx2 / -march=native），否则 byteswap_copy 使用标量循环
+#include <array>
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "binary_serialization.h"
+#include "bench_timing.h"
+
+namespace {
+
+using namespace BinarySerialization;
+
+const char* kernel_name() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSSE3__)
+    return "SSSE3";
+#elif defined(__ARM_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+enum Mode { Native, PortableLittle, PortableBig };
+const char* kModeNames[] = {"native", "portable little-endian", "portable big-endian"};
+
+template<typename T>
+bool run(const char* label, const T& value) {
+    bool ok = true;
+    for (Mode mode : {Native, PortableLittle, PortableBig}) {
+        BufferWriter buffer;
+        double encodeMs = best_ms(5, [&] {
+            buffer.clear();
+            if (mode == Native) {
+                serialize(value, buffer);
+            } else {
+                PortableWriter<BufferWriter> portable(buffer, mode == PortableBig ? ByteOrder::Big : ByteOrder::Little);
+                serialize(value, portable);
+            }
+        });
+        T decoded;
+        double decodeMs = best_ms(5, [&] {
+            BufferReader reader(buffer.data(), buffer.size());
+            if (mode == Native) {
+                deserialize(decoded, reader);
+            } else {
+                PortableReader<BufferReader> portable(reader);
+                deserialize(decoded, portable);
+            }
+        });
+        ok = ok && decoded == value;
+        double mb = buffer.size() / 1048576.0;
+        std::printf("%-28s %-24s %9.1f %12.0f %12.0f\n", label, kModeNames[mode], mb, mb / encodeMs * 1000,
+                    mb / decodeMs * 1000);
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 8000000;
+
+    std::vector<double> doubles(n);
+    std::vector<int32_t> ints(n * 2);
+    std::vector<uint16_t> shorts(n * 4);
+    std::vector<std::array<float, 3>> points(n / 2);
+    std::vector<std::pair<int32_t, double>> pairs(n / 4);
+    for (size_t i = 0; i < n; ++i) doubles[i] = 0.25 * static_cast<double>(i);
+    for (size_t i = 0; i < ints.size(); ++i) ints[i] = static_cast<int32_t>(i * 2654435761u);
+    for (size_t i = 0; i < shorts.size(); ++i) shorts[i] = static_cast<uint16_t>(i);
+    for (size_t i = 0; i < points.size(); ++i) points[i] = {{1.0f * i, 2.0f, 3.0f}};
+    for (size_t i = 0; i < pairs.size(); ++i) pairs[i] = {static_cast<int32_t>(i), 0.5 * i};
+
+    std::printf("byteswap kernel: %s\n", kernel_name());
+    std::printf("%-28s %-24s %9s %12s %12s\n", "", "", "MB", "encode MB/s", "decode MB/s");
+    bool ok = run("vector<double>", doubles);
+    ok = run("vector<int32_t>", ints) && ok;
+    ok = run("vector<uint16_t>", shorts) && ok;
+    ok = run("vector<array<float, 3>>", points) && ok;
+    ok = run("vector<pair<int32_t, double>>", pairs) && ok;
+
+    std::printf("\n%-28s %12s %12s\n", "byteswap_copy (64 MB)", "kernel MB/s", "scalar MB/s");
+    std::vector<char> src(64 << 20, 1), dst(src.size());
+    for (size_t width : {2, 4, 8}) {
+        size_t count = src.size() / width;
+        double kernel = best_ms(5, [&] { detail::byteswap_copy(dst.data(), src.data(), count, width); });
+        double scalar = best_ms(5, [&] { detail::byteswap_copy_scalar(dst.data(), src.data(), count, width); });
+        std::printf("width %-22zu %12.0f %12.0f\n", width, 64 / kernel * 1000, 64 / scalar * 1000);
+    }
+    if (!ok) std::printf("round-trip mismatch\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+// 编码到内存：自增长 BufferWriter（几何扩容并逐次拷贝）vs serialize_to_buffer（serialized_size 预计算后一次分配），
+// 以及 serialized_size 预计算本身的耗时
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include "binary_serialization.h"
+#include "bench_timing.h"
+
+struct Record {
+    int id;
+    std::string name;
+    std::vector<double> data;
+    BINARY_SERIALIZABLE(id, name, data)
+};
+
+namespace {
+
+volatile size_t sink;
+
+template<typename T>
+bool run(const char* label, const T& value) {
+    using namespace BinarySerialization;
+    size_t grownSize = 0, exactSize = 0;
+    double grow = best_ms(5, [&] {
+        BufferWriter writer;
+        serialize(value, writer);
+        grownSize = writer.size();
+    });
+    double exact = best_ms(5, [&] {
+        BufferWriter writer = serialize_to_buffer(value);
+        exactSize = writer.size();
+    });
+    double sizing = best_ms(5, [&] { sink = serialized_size(value); });
+    std::printf("%-28s %10.1f %12.2f %12.2f %12.2f\n", label, exactSize / 1048576.0, grow, exact, sizing);
+    return grownSize == exactSize;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    std::vector<double> doubles(n * 8, 1.5);
+    std::map<int, std::string> names;
+    for (size_t i = 0; i < n; ++i) names.emplace(static_cast<int>(i), "name-" + std::to_string(i));
+    std::vector<Record> records(n / 4);
+    for (size_t i = 0; i < records.size(); ++i) {
+        records[i].id = static_cast<int>(i);
+        records[i].name = "record-" + std::to_string(i);
+        records[i].data.assign(i % 16, 0.5 * static_cast<double>(i));
+    }
+    std::vector<std::array<int, 4>> fixed(n * 2);
+
+    std::printf("%-28s %10s %12s %12s %12s\n", "", "MB", "grow ms", "exact ms", "sizing ms");
+    bool ok = run("std::vector<double>", doubles);
+    ok = run("std::vector<std::array<int,4>>", fixed) && ok;
+    ok = run("std::map<int, std::string>", names) && ok;
+    ok = run("std::vector<Record>", records) && ok;
+    if (!ok) std::printf("size mismatch\n");
+    return ok ? 0 : 1;
+}
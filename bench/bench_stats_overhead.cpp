@@ -0,0 +1,49 @@
+// 序列化统计的开销：同一份代码分别编译为 bench_stats（未定义 SERIALIZATION_STATS，插桩为空）
+// 与 bench_stats_enabled（定义 SERIALIZATION_STATS），比较编码/解码耗时；后者最后输出统计表
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "binary_serialization.h"
+#include "bench_timing.h"
+
+struct Point {
+    float x, y, z;
+    BINARY_SERIALIZABLE(x, y, z)
+};
+
+struct Record {
+    int id;
+    std::string name;
+    Point position;
+    std::vector<double> data;
+    BINARY_SERIALIZABLE(id, name, position, data)
+};
+
+int main(int argc, char** argv) {
+    using namespace BinarySerialization;
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 500000;
+    std::vector<Record> records(n);
+    for (size_t i = 0; i < n; ++i) {
+        records[i].id = static_cast<int>(i);
+        records[i].name = "record-" + std::to_string(i);
+        records[i].position = {1.0f * i, 2.0f, 3.0f};
+        records[i].data.assign(i % 8, 0.5);
+    }
+
+    BufferWriter encoded;
+    double encode = best_ms(5, [&] {
+        BufferWriter writer;
+        serialize(records, writer);
+        encoded = std::move(writer);
+    });
+    std::vector<Record> decoded;
+    double decode = best_ms(5, [&] {
+        BufferReader reader(encoded.data(), encoded.size());
+        deserialize(decoded, reader);
+    });
+    std::printf("stats %s: %zu records, %.1f MB, encode %.2f ms, decode %.2f ms\n",
+                serialization_stats::enabled ? "enabled" : "disabled", n, encoded.size() / 1048576.0, encode, decode);
+    if (serialization_stats::enabled) serialization_stats::dump_table(std::cout);
+    return decoded.size() == records.size() ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+#ifndef BENCH_TIMING_H
+#define BENCH_TIMING_H
+
+// 各基准程序共用的计时工具
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+inline double ms_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// 执行 reps 次 fn，返回最快一次的毫秒数
+template<typename F>
+double best_ms(int reps, F&& fn) {
+    double best = 1e300;
+    for (int r = 0; r < reps; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        double ms = ms_since(t0);
+        if (ms < best) best = ms;
+    }
+    return best;
+}
+
+// 先倍增迭代次数直到一批耗时不少于 minMs，再取 3 批中最快的一批的平均值
+inline double ns_per_op(const std::function<void()>& op, double minMs) {
+    op();
+    size_t iters = 1;
+    auto batch = [&](size_t n) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n; ++i) op();
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(t1 - t0).count();
+    };
+    while (batch(iters) < minMs * 1e6 && iters < (size_t(1) << 30)) iters *= 2;
+    double best = 1e300;
+    for (int r = 0; r < 3; ++r) {
+        double ns = batch(iters) / static_cast<double>(iters);
+        if (ns < best) best = ns;
+    }
+    return best;
+}
+
+#endif // BENCH_TIMING_H
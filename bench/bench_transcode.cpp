@@ -0,0 +1,127 @@
+// 二进制 <-> XML 转码：先反序列化成对象再用另一端序列化（decode-then-encode）vs xml_transcode.h 的逐元素转码。
+// 数据为 N 条带字符串、数组与 map 成员的记录；两个方向都按文件到文件计时，
+// 每种方式在单独的子进程中运行，分别测得峰值 RSS（仅 POSIX），并检查两种方式的输出逐字节相同
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include "binary_serialization.h"
+#include "xml_stream_writer.h"
+#include "xml_stream_reader.h"
+#include "xml_transcode.h"
+
+struct Record {
+    int64_t id = 0;
+    std::string name;
+    std::vector<double> samples;
+    std::map<std::string, std::string> tags;
+    BINARY_SERIALIZABLE(id, name, samples, tags)
+    XML_SERIALIZABLE(id, name, samples, tags)
+};
+
+namespace {
+
+using Records = std::vector<Record>;
+
+struct Result {
+    double ms;
+    long peakKb;
+};
+
+// 在子进程中执行 f，返回耗时与子进程峰值 RSS
+template<typename F>
+Result run_isolated(F&& f) {
+    int fds[2];
+    if (pipe(fds) != 0) return {-1, -1};
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        ssize_t w = write(fds[1], &ms, sizeof(ms));
+        _exit(w == sizeof(ms) ? 0 : 1);
+    }
+    close(fds[1]);
+    double ms = -1;
+    if (read(fds[0], &ms, sizeof(ms)) != sizeof(ms)) ms = -1;
+    close(fds[0]);
+    int status = 0;
+    struct rusage ru {};
+    wait4(pid, &status, 0, &ru);
+    return {ms, ru.ru_maxrss};
+}
+
+std::string read_file(const char* path) {
+    std::ifstream ifs(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+double file_mb(const char* path) { return static_cast<double>(read_file(path).size()) / (1024.0 * 1024.0); }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 200000;
+    {
+        Records records(n);
+        for (size_t i = 0; i < n; ++i) {
+            Record& r = records[i];
+            r.id = static_cast<int64_t>(i) * 7919;
+            r.name = "record-" + std::to_string(i);
+            r.samples.assign(8, 0.5 * static_cast<double>(i));
+            r.tags = {{"region", i % 2 ? "eu-west" : "us-east"}, {"owner", "team-" + std::to_string(i % 37)}};
+        }
+        BinarySerialization::serialize(records, "bench_transcode.data");
+        xml_serialization::stream_serialize_xml(records, "records", "bench_transcode.xml");
+    }  // 子进程不继承原始数据，峰值 RSS 只反映转换本身
+
+    Result baseline = run_isolated([] {});
+    Result decodeToXml = run_isolated([] {
+        Records records;
+        BinarySerialization::deserialize(records, "bench_transcode.data");
+        xml_serialization::stream_serialize_xml(records, "records", "bench_transcode_dte.xml");
+    });
+    Result transcodeToXml = run_isolated([] {
+        xml_serialization::transcode_binary_to_xml<Records>("bench_transcode.data", "records", "bench_transcode_tc.xml");
+    });
+    Result decodeToBinary = run_isolated([] {
+        Records records;
+        xml_serialization::stream_deserialize_xml(records, "records", "bench_transcode.xml");
+        BinarySerialization::serialize(records, "bench_transcode_dte.data");
+    });
+    Result transcodeToBinary = run_isolated([] {
+        xml_serialization::transcode_xml_to_binary<Records>("bench_transcode.xml", "records", "bench_transcode_tc.data");
+    });
+
+    bool sameXml = read_file("bench_transcode_dte.xml") == read_file("bench_transcode_tc.xml") &&
+                   read_file("bench_transcode_tc.xml") == read_file("bench_transcode.xml");
+    bool sameBinary = read_file("bench_transcode_dte.data") == read_file("bench_transcode_tc.data") &&
+                      read_file("bench_transcode_tc.data") == read_file("bench_transcode.data");
+    double binaryMb = file_mb("bench_transcode.data");
+    double xmlMb = file_mb("bench_transcode.xml");
+
+    std::printf("%zu records: binary %.1f MB, XML %.1f MB, byte-identical: xml %s, binary %s\n", n, binaryMb, xmlMb,
+                sameXml ? "yes" : "NO", sameBinary ? "yes" : "NO");
+    std::printf("%-34s %10s %12s %16s\n", "", "ms", "XML MB/s", "peak RSS over base");
+    auto row = [&](const char* label, const Result& r) {
+        std::printf("%-34s %10.1f %12.1f %13.1f MB\n", label, r.ms, xmlMb / (r.ms / 1000.0),
+                    (r.peakKb - baseline.peakKb) / 1024.0);
+    };
+    row("binary -> XML, decode then encode", decodeToXml);
+    row("binary -> XML, transcode", transcodeToXml);
+    row("XML -> binary, decode then encode", decodeToBinary);
+    row("XML -> binary, transcode", transcodeToBinary);
+
+    for (const char* f : {"bench_transcode.data", "bench_transcode.xml", "bench_transcode_dte.xml", "bench_transcode_tc.xml",
+                          "bench_transcode_dte.data", "bench_transcode_tc.data"})
+        std::remove(f);
+    return sameXml && sameBinary ? 0 : 1;
+}
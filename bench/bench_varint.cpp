@@ -0,0 +1,120 @@
+// 定长格式 vs 紧凑（varint/zigzag）格式：输出字节数与编解码吞吐
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "binary_serialization.h"
+#include "bench_timing.h"
+
+struct Event {
+    int id;
+    long timestamp;
+    std::string tag;
+    std::vector<int> counters;
+    BINARY_SERIALIZABLE(id, timestamp, tag, counters)
+};
+
+namespace {
+
+using BinarySerialization::BufferReader;
+using BinarySerialization::BufferWriter;
+using BinarySerialization::CompactReader;
+using BinarySerialization::CompactWriter;
+
+template<typename T>
+void compare(const char* label, const T& value, int reps) {
+    BufferWriter fixed;
+    double fixedEnc = best_ms(reps, [&] { fixed.clear(); BinarySerialization::serialize(value, fixed); });
+    BufferWriter compact;
+    double compactEnc = best_ms(reps, [&] {
+        compact.clear();
+        CompactWriter<BufferWriter> cw(compact);
+        BinarySerialization::serialize(value, cw);
+    });
+
+    T out;
+    double fixedDec = best_ms(reps, [&] {
+        BufferReader r(fixed.data(), fixed.size());
+        BinarySerialization::deserialize(out, r);
+    });
+    double compactDec = best_ms(reps, [&] {
+        BufferReader r(compact.data(), compact.size());
+        CompactReader<BufferReader> cr(r);
+        BinarySerialization::deserialize(out, cr);
+    });
+
+    std::printf("%-22s %12zu %12zu %7.2fx | enc %8.1f / %8.1f ms | dec %8.1f / %8.1f ms\n",
+                label, fixed.size(), compact.size(), double(fixed.size()) / compact.size(),
+                fixedEnc, compactEnc, fixedDec, compactDec);
+}
+
+// 逐字节循环解码，作为快速解码路径的对照
+size_t decode_bytewise(const char* p, size_t n, int* out) {
+    size_t pos = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t v = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t b = static_cast<uint8_t>(p[pos++]);
+            v |= static_cast<uint64_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) break;
+        }
+        out[i] = static_cast<int>(BinarySerialization::zigzag_decode(v));
+    }
+    return pos;
+}
+
+void bench_varint_run(const char* label, const std::vector<int>& values, int reps) {
+    BufferWriter wire;
+    CompactWriter<BufferWriter> cw(wire);
+    cw.write_varints(values.data(), values.size());
+    std::vector<int> decoded(values.size());
+    double bytewise = best_ms(reps, [&] { decode_bytewise(wire.data(), decoded.size(), decoded.data()); });
+    double fast = best_ms(reps, [&] {
+        BufferReader r(wire.data(), wire.size());
+        CompactReader<BufferReader> cr(r);
+        cr.read_varints(decoded.data(), decoded.size());
+    });
+    if (decoded != values) std::printf("  varint run mismatch\n");
+    std::printf("varint run decode, %-12s (%.2f B/value): bytewise %.2f ns/value, fast path %.2f ns/value\n",
+                label, double(wire.size()) / values.size(),
+                bytewise * 1e6 / values.size(), fast * 1e6 / values.size());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const int reps = 5;
+    std::mt19937 rng(42);
+    std::geometric_distribution<int> small(0.05);
+
+    std::map<int, std::string> names;
+    for (size_t i = 0; i < n; ++i) names.emplace(static_cast<int>(i), "n" + std::to_string(rng() % 1000));
+
+    std::vector<int> counters(n);
+    for (auto& c : counters) c = (rng() & 1 ? 1 : -1) * small(rng);
+
+    std::vector<Event> events(n / 4);
+    for (size_t i = 0; i < events.size(); ++i) {
+        events[i] = {static_cast<int>(i), 1700000000L + static_cast<long>(i), "ev" + std::to_string(i % 50),
+                     std::vector<int>(rng() % 8, small(rng))};
+    }
+
+    std::printf("%-22s %12s %12s %8s | %-25s | %s\n", "payload", "fixed B", "compact B", "ratio",
+                "encode fixed / compact", "decode fixed / compact");
+    compare("map<int, string>", names, reps);
+    compare("vector<int> small", counters, reps);
+    compare("vector<Event>", events, reps);
+
+    // varint 串解码：逐字节循环 vs 单字节内联分支 + 8 字节加载掩码拼接
+    std::uniform_int_distribution<int> wide(-(1 << 27), 1 << 27);
+    std::vector<int> wideValues(n);
+    for (auto& w : wideValues) w = wide(rng);
+    std::vector<int> mixedValues(n);
+    for (auto& m : mixedValues) m = static_cast<int>(rng() >> (rng() % 32)) * (rng() & 1 ? 1 : -1);
+    bench_varint_run("small values", counters, reps);
+    bench_varint_run("wide values", wideValues, reps);
+    bench_varint_run("mixed widths", mixedValues, reps);
+    return 0;
+}
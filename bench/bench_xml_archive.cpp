@@ -0,0 +1,61 @@
+// 多值 XML：每个值单独一次 serialize_xml/deserialize_xml（各自建文档、写文件、解析）
+// vs XmlOutputArchive / XmlInputArchive（一个文档、一次写文件、一次解析）
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "xml_serialization.h"
+#include "bench_timing.h"
+
+struct ConfigEntry {
+    int id;
+    std::string owner;
+    std::vector<double> limits;
+    XML_SERIALIZABLE(id, owner, limits)
+};
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 200;
+    const int reps = 5;
+    std::vector<ConfigEntry> entries(n);
+    std::vector<std::string> names(n), files(n);
+    for (size_t i = 0; i < n; ++i) {
+        entries[i] = {static_cast<int>(i), "team-" + std::to_string(i % 7), {1.0 * i, 2.0 * i, 0.5}};
+        names[i] = "entry" + std::to_string(i);
+        files[i] = "bench_xml_archive_" + std::to_string(i) + ".xml";
+    }
+
+    // 旧方式下同名文件会被后一次调用覆盖，只能每个值一个文件
+    double perValueWrite = best_ms(reps, [&] {
+        for (size_t i = 0; i < n; ++i) xml_serialization::serialize_xml(entries[i], names[i], files[i]);
+    });
+    double perValueRead = best_ms(reps, [&] {
+        ConfigEntry e;
+        for (size_t i = 0; i < n; ++i) xml_serialization::deserialize_xml(e, names[i], files[i]);
+    });
+
+    double archiveWrite = best_ms(reps, [&] {
+        xml_serialization::XmlOutputArchive out("bench_xml_archive.xml");
+        for (size_t i = 0; i < n; ++i) out.save(names[i], entries[i]);
+        out.flush();
+    });
+    std::vector<ConfigEntry> loaded(n);
+    double archiveRead = best_ms(reps, [&] {
+        xml_serialization::XmlInputArchive in("bench_xml_archive.xml");
+        for (size_t i = 0; i < n; ++i) in.load(names[i], loaded[i]);
+    });
+    for (size_t i = 0; i < n; ++i) {
+        if (loaded[i].id != entries[i].id || loaded[i].limits != entries[i].limits) {
+            std::printf("  mismatch at %zu\n", i);
+            break;
+        }
+    }
+
+    std::printf("values: %zu, best of %d\n", n, reps);
+    std::printf("%-10s %14s %14s %9s\n", "", "per value ms", "archive ms", "speedup");
+    std::printf("%-10s %14.2f %14.2f %8.1fx\n", "write", perValueWrite, archiveWrite, perValueWrite / archiveWrite);
+    std::printf("%-10s %14.2f %14.2f %8.1fx\n", "read", perValueRead, archiveRead, perValueRead / archiveRead);
+
+    for (const auto& f : files) std::remove(f.c_str());
+    std::remove("bench_xml_archive.xml");
+    return 0;
+}
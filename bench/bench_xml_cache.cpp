@@ -0,0 +1,161 @@
+// 配置热加载：从同一个文件读取 10 个命名值。
+// 每个值一次 deserialize_xml（解析 10 次）vs 一个 XmlInputArchive + load_all（解析 1 次）
+// vs XmlDocumentCache（文件未变化时只做 stat），以及多线程共享缓存与"每 10 次加载改一次文件"的情形。
+// 输出每次加载的墙钟时间与进程 CPU 时间
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "xml_document_cache.h"
+
+struct Limit {
+    std::string key;
+    int burst;
+    double rate;
+    XML_SERIALIZABLE(key, burst, rate)
+};
+
+namespace {
+
+using namespace xml_serialization;
+
+constexpr int kValues = 10;
+
+struct Config {
+    std::vector<Limit> values[kValues];
+};
+
+std::string value_name(int i) { return "section" + std::to_string(i); }
+
+void write_config(const Config& config, const std::string& filename) {
+    XmlOutputArchive out(filename);
+    for (int i = 0; i < kValues; ++i) out.save(value_name(i), config.values[i]);
+    out.flush();
+}
+
+// 把修改时间调到一小时前，模拟长时间未变化的配置文件（否则缓存会把刚写出的文件当作不确定而比较内容）
+void age_file(const std::string& filename) {
+    std::filesystem::last_write_time(filename,
+                                     std::filesystem::file_time_type::clock::now() - std::chrono::hours(1));
+}
+
+struct Cost {
+    double wallUs;
+    double cpuUs;
+};
+
+template<typename F>
+Cost per_reload(int reloads, F&& reload) {
+    std::clock_t c0 = std::clock();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reloads; ++r) reload(r);
+    double wall = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    double cpu = 1e6 * static_cast<double>(std::clock() - c0) / CLOCKS_PER_SEC;
+    return {wall / reloads, cpu / reloads};
+}
+
+void report(const char* label, Cost cost) {
+    std::printf("%-44s %12.1f %12.1f\n", label, cost.wallUs, cost.cpuUs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t perValue = argc > 1 ? std::stoul(argv[1]) : 200;
+    int reloads = argc > 2 ? std::stoi(argv[2]) : 200;
+    const std::string filename = "bench_xml_cache.xml";
+
+    Config config;
+    for (int i = 0; i < kValues; ++i) {
+        for (size_t k = 0; k < perValue; ++k)
+            config.values[i].push_back({"tenant-" + std::to_string(k), static_cast<int>(k % 100), 0.5 * k});
+    }
+    write_config(config, filename);
+    age_file(filename);
+
+    Config loaded;
+    bool ok = true;
+    auto check = [&] {
+        for (int i = 0; i < kValues; ++i) ok = ok && loaded.values[i].size() == config.values[i].size();
+    };
+
+    std::printf("%d values x %zu records, %ju bytes, %d reloads\n", kValues, perValue,
+                static_cast<uintmax_t>(std::filesystem::file_size(filename)), reloads);
+    std::printf("%-44s %12s %12s\n", "", "wall us", "cpu us");
+
+    report("deserialize_xml per value (10 parses)", per_reload(reloads, [&](int) {
+        for (int i = 0; i < kValues; ++i) deserialize_xml(loaded.values[i], value_name(i), filename);
+    }));
+    check();
+
+    report("XmlInputArchive + load (1 parse)", per_reload(reloads, [&](int) {
+        XmlInputArchive in(filename);
+        for (int i = 0; i < kValues; ++i) in.load(value_name(i), loaded.values[i]);
+    }));
+    check();
+
+    XmlDocumentCache cache;
+    report("XmlDocumentCache, unchanged (stat only)", per_reload(reloads, [&](int) {
+        auto doc = cache.open(filename);
+        for (int i = 0; i < kValues; ++i) doc->load(value_name(i), loaded.values[i]);
+    }));
+    check();
+
+    // 热加载循环通常只在文档变化时重新应用配置：比较 open() 返回的指针即可
+    std::shared_ptr<const XmlInputArchive> current;
+    report("XmlDocumentCache, unchanged, skip if same", per_reload(reloads * 100, [&](int) {
+        auto doc = cache.open(filename);
+        if (doc == current) return;
+        current = doc;
+        for (int i = 0; i < kValues; ++i) doc->load(value_name(i), loaded.values[i]);
+    }));
+    check();
+
+    report("XmlDocumentCache, changed every 10th reload", per_reload(reloads, [&](int r) {
+        if (r % 10 == 0) {
+            config.values[0][0].burst = r;
+            write_config(config, filename);
+        }
+        auto doc = cache.open(filename);
+        for (int i = 0; i < kValues; ++i) doc->load(value_name(i), loaded.values[i]);
+    }));
+    check();
+    ok = ok && loaded.values[0][0].burst == config.values[0][0].burst;
+
+    // 刚写出的文件处于修改时间精度窗口内，每次打开都要读文件比较内容哈希
+    report("XmlDocumentCache, freshly written file", per_reload(reloads, [&](int) {
+        auto doc = cache.open(filename);
+        for (int i = 0; i < kValues; ++i) doc->load(value_name(i), loaded.values[i]);
+    }));
+    check();
+
+    age_file(filename);
+    std::vector<unsigned> threadCounts{1};
+    if (std::thread::hardware_concurrency() > 1) threadCounts.push_back(std::thread::hardware_concurrency());
+    for (unsigned t : threadCounts) {
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (unsigned w = 0; w < t; ++w) {
+            workers.emplace_back([&] {
+                std::shared_ptr<const XmlInputArchive> seen;
+                for (int r = 0; r < reloads * 100; ++r) {
+                    auto doc = cache.open(filename);
+                    if (doc != seen) seen = doc;
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        std::printf("shared cache, %2u threads: %10.0f opens/s\n", t, t * reloads * 100.0 / us * 1e6);
+    }
+
+    auto stats = cache.stats();
+    std::printf("cache: %llu hits, %llu misses, %llu reloads\n", static_cast<unsigned long long>(stats.hits),
+                static_cast<unsigned long long>(stats.misses), static_cast<unsigned long long>(stats.reloads));
+    std::filesystem::remove(filename);
+    if (!ok) std::printf("round-trip mismatch\n");
+    return ok ? 0 : 1;
+}
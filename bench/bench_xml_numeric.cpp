@@ -0,0 +1,127 @@
+// XML 数值路径：printf/strtod 风格格式化 vs std::to_chars/from_chars；
+// std::vector<double> 每值一个 <item> vs packed(...) base64 文本节点；base64 标量解码 vs 向量化解码
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "xml_serialization.h"
+#include "xml_stream_reader.h"
+#include "bench_timing.h"
+
+namespace {
+
+size_t file_size(const char* path) {
+    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+    return static_cast<size_t>(ifs.tellg());
+}
+
+volatile double sink;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const int reps = 5;
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+    std::vector<double> values(n);
+    for (auto& v : values) v = dist(rng);
+
+    // 1. 单个数值的文本转换（tinyxml2 的 SetAttribute/QueryAttribute 内部即 "%.17g" 与 sscanf/strtod）
+    std::vector<std::string> texts(n);
+    double printfMs = best_ms(reps, [&] {
+        char buf[64];
+        for (size_t i = 0; i < n; ++i) {
+            std::snprintf(buf, sizeof(buf), "%.17g", values[i]);
+            texts[i].assign(buf);
+        }
+    });
+    double strtodMs = best_ms(reps, [&] {
+        double sum = 0;
+        for (size_t i = 0; i < n; ++i) sum += std::strtod(texts[i].c_str(), nullptr);
+        sink = sum;
+    });
+    double toCharsMs = best_ms(reps, [&] {
+        char buf[xml_serialization::kNumberTextSize];
+        for (size_t i = 0; i < n; ++i) texts[i].assign(xml_serialization::format_number(values[i], buf));
+    });
+    double fromCharsMs = best_ms(reps, [&] {
+        double sum = 0, d = 0;
+        for (size_t i = 0; i < n; ++i) {
+            xml_serialization::parse_number(texts[i].c_str(), d);
+            sum += d;
+        }
+        sink = sum;
+    });
+
+    std::printf("doubles: %zu, best of %d\n", n, reps);
+    std::printf("%-22s %12s %12s\n", "number text", "format ns", "parse ns");
+    std::printf("%-22s %12.1f %12.1f\n", "%.17g / strtod", printfMs * 1e6 / n, strtodMs * 1e6 / n);
+    std::printf("%-22s %12.1f %12.1f\n", "to_chars / from_chars", toCharsMs * 1e6 / n, fromCharsMs * 1e6 / n);
+
+    // 2. 整个数组：每值一个 <item> vs 打包
+    std::vector<double> loaded;
+    double itemWrite = best_ms(reps, [&] {
+        xml_serialization::XmlOutputArchive out("bench_xml_items.xml");
+        out.save("values", values);
+        out.flush();
+    });
+    double itemRead = best_ms(reps, [&] {
+        xml_serialization::XmlInputArchive in("bench_xml_items.xml");
+        in.load("values", loaded);
+    });
+    bool itemOk = loaded == values;
+    double packedWrite = best_ms(reps, [&] {
+        xml_serialization::XmlOutputArchive out("bench_xml_packed.xml");
+        out.save("values", xml_serialization::packed(values));
+        out.flush();
+    });
+    double packedRead = best_ms(reps, [&] {
+        xml_serialization::XmlInputArchive in("bench_xml_packed.xml");
+        in.load("values", loaded);
+    });
+    bool packedOk = loaded == values;
+    double packedStreamRead = best_ms(reps, [&] {
+        xml_serialization::XmlStreamReader in("bench_xml_packed.xml");
+        in.load("values", loaded);
+    });
+    packedOk = packedOk && loaded == values;
+
+    double binaryBytes = static_cast<double>(n * sizeof(double));
+    std::printf("\n%-22s %12s %10s %12s %12s %6s\n", "vector<double>", "file MB", "x binary", "write ms", "read ms", "ok");
+    std::printf("%-22s %12.1f %10.2f %12.1f %12.1f %6s\n", "<item> per value",
+                file_size("bench_xml_items.xml") / 1048576.0, file_size("bench_xml_items.xml") / binaryBytes,
+                itemWrite, itemRead, itemOk ? "yes" : "NO");
+    std::printf("%-22s %12.1f %10.2f %12.1f %12.1f %6s\n", "packed (DOM)",
+                file_size("bench_xml_packed.xml") / 1048576.0, file_size("bench_xml_packed.xml") / binaryBytes,
+                packedWrite, packedRead, packedOk ? "yes" : "NO");
+    std::printf("%-22s %12s %10s %12s %12.1f\n", "packed (stream read)", "", "", "", packedStreamRead);
+
+    // 3. base64 解码内核
+    std::string encoded;
+    xml_serialization::base64_encode(reinterpret_cast<const char*>(values.data()), n * sizeof(double), encoded);
+    std::vector<char> out(n * sizeof(double) + 16);
+    double scalarMs = best_ms(reps, [&] {
+        size_t produced;
+        xml_serialization::base64_decode_scalar(encoded.data(), encoded.size(), out.data(), out.size(), produced);
+    });
+    double kernelMs = best_ms(reps, [&] {
+        size_t produced;
+        xml_serialization::base64_decode_quads(encoded.data(), encoded.size(), out.data(), out.size(), produced);
+    });
+    double mb = encoded.size() / 1048576.0;
+#if defined(__SSSE3__)
+    const char* kernel = "ssse3";
+#else
+    const char* kernel = "scalar (build with -mssse3)";
+#endif
+    std::printf("\n%-22s %12s\n", "base64 decode", "MB/s in");
+    std::printf("%-22s %12.0f\n", "scalar", mb / (scalarMs / 1000.0));
+    std::printf("%-22s %12.0f   %s\n", "base64_decode_quads", mb / (kernelMs / 1000.0), kernel);
+
+    std::remove("bench_xml_items.xml");
+    std::remove("bench_xml_packed.xml");
+    return 0;
+}
@@ -0,0 +1,119 @@
+// 大容器 XML 导出/导入：XmlOutputArchive（先建 DOM 再写）vs XmlStreamWriter（边遍历边写），
+// XmlInputArchive（整文件解析成 DOM）vs XmlStreamReader（边解析边填充）
+// 每种方式在单独的子进程中运行，以便分别测得峰值 RSS（仅 POSIX）
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include "xml_serialization.h"
+#include "xml_stream_writer.h"
+#include "xml_stream_reader.h"
+
+namespace {
+
+struct Result {
+    double ms;
+    long peakKb;
+};
+
+// 在子进程中执行 f，返回耗时与子进程峰值 RSS
+template<typename F>
+Result run_isolated(F&& f) {
+    int fds[2];
+    if (pipe(fds) != 0) return {-1, -1};
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        auto t0 = std::chrono::steady_clock::now();
+        f();
+        auto t1 = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        ssize_t w = write(fds[1], &ms, sizeof(ms));
+        _exit(w == sizeof(ms) ? 0 : 1);
+    }
+    close(fds[1]);
+    double ms = -1;
+    if (read(fds[0], &ms, sizeof(ms)) != sizeof(ms)) ms = -1;
+    close(fds[0]);
+    int status = 0;
+    struct rusage ru {};
+    wait4(pid, &status, 0, &ru);
+    return {ms, ru.ru_maxrss};
+}
+
+std::string read_file(const char* path) {
+    std::ifstream ifs(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    std::vector<double> samples(n);
+    std::map<int, std::string> index;
+    for (size_t i = 0; i < n; ++i) {
+        samples[i] = 0.25 * static_cast<double>(i);
+        if (i % 16 == 0) index.emplace(static_cast<int>(i), "row-" + std::to_string(i));
+    }
+
+    // 基线：只持有输入数据时的峰值 RSS
+    Result baseline = run_isolated([] {});
+    Result dom = run_isolated([&] {
+        xml_serialization::XmlOutputArchive out("bench_xml_dom.xml");
+        out.save("samples", samples).save("index", index);
+        out.flush();
+    });
+    Result stream = run_isolated([&] {
+        xml_serialization::XmlStreamWriter out("bench_xml_stream.xml");
+        out.save("samples", samples).save("index", index);
+        out.close();
+    });
+
+    // 读取在子进程中完成，结果只回报是否与原数据一致
+    auto check = [&](const std::vector<double>& s, const std::map<int, std::string>& m) {
+        if (s != samples || m != index) std::printf("  read mismatch\n");
+    };
+    Result domRead = run_isolated([&] {
+        std::vector<double> s;
+        std::map<int, std::string> m;
+        xml_serialization::XmlInputArchive in("bench_xml_dom.xml");
+        in.load("samples", s);
+        in.load("index", m);
+        check(s, m);
+    });
+    Result streamRead = run_isolated([&] {
+        std::vector<double> s;
+        std::map<int, std::string> m;
+        xml_serialization::XmlStreamReader in("bench_xml_dom.xml");
+        in.load("samples", s);
+        in.load("index", m);
+        check(s, m);
+    });
+
+    std::string domText = read_file("bench_xml_dom.xml");
+    bool same = domText == read_file("bench_xml_stream.xml");
+    double mb = static_cast<double>(domText.size()) / (1024.0 * 1024.0);
+
+    std::printf("elements: %zu + %zu map entries, output %.1f MB, byte-identical: %s\n",
+                n, index.size(), mb, same ? "yes" : "NO");
+    std::printf("%-14s %10s %10s %16s\n", "", "ms", "MB/s", "peak RSS over base");
+    auto row = [&](const char* label, const Result& r) {
+        std::printf("%-14s %10.1f %10.1f %13.1f MB\n", label, r.ms, mb / (r.ms / 1000.0),
+                    (r.peakKb - baseline.peakKb) / 1024.0);
+    };
+    row("write dom", dom);
+    row("write stream", stream);
+    row("read dom", domRead);
+    row("read stream", streamRead);
+
+    std::remove("bench_xml_dom.xml");
+    std::remove("bench_xml_stream.xml");
+    return same ? 0 : 1;
+}
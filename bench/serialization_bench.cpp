@@ -0,0 +1,310 @@
+// 序列化基准套件：每种类型族 × 多个规模 × 后端（binary / binary-compact / xml-dom / xml-stream）× 目标（内存 / 文件），
+// 报告编码与解码的 ns/op、MB/s、产出字节数和单次操作的分配次数，并可输出 JSON 便于对比不同版本。
+//
+// 用法：serialization_bench [--quick] [--filter 子串] [--min-ms 毫秒] [--json 文件]
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <new>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "binary_serialization.h"
+#include "xml_serialization.h"
+#include "xml_stream_reader.h"
+#include "xml_stream_writer.h"
+#include "bench_timing.h"
+
+// 替换后的 operator new/delete 都基于 malloc/free，GCC 内联后会误报 new/free 不匹配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace {
+
+size_t g_allocations = 0;
+
+} // namespace
+
+void* operator new(size_t size) {
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { ::operator delete(p); }
+
+struct BenchRecord {
+    int id = 0;
+    std::string name;
+    std::vector<double> data;
+    BINARY_SERIALIZABLE(id, name, data)
+    XML_SERIALIZABLE(id, name, data)
+
+    bool operator==(const BenchRecord& other) const {
+        return id == other.id && name == other.name && data == other.data;
+    }
+};
+
+namespace {
+
+using BinarySerialization::BufferReader;
+using BinarySerialization::BufferWriter;
+using BinarySerialization::CompactReader;
+using BinarySerialization::CompactWriter;
+
+const char* kTempFile = "serialization_bench.tmp";
+
+struct Options {
+    std::vector<size_t> sizes{16, 1024, 65536};
+    std::string filter;
+    std::string json;
+    double minMs = 20;
+};
+
+struct Result {
+    std::string family;
+    size_t size;
+    std::string backend;
+    std::string sink;
+    size_t bytes;
+    double encodeNs;
+    double decodeNs;
+    size_t encodeAllocs;
+    size_t decodeAllocs;
+    bool roundTrip;
+};
+
+size_t allocations_of(const std::function<void()>& op) {
+    size_t before = g_allocations;
+    op();
+    return g_allocations - before;
+}
+
+size_t file_size(const char* path) {
+    std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+    return static_cast<size_t>(ifs.tellg());
+}
+
+// 一个后端在一种目标上的编码/解码操作；encode 之后 bytes() 给出产出大小，decode 读回到 out
+template<typename T>
+struct Codec {
+    const char* backend;
+    const char* sink;
+    std::function<void(const T&)> encode;
+    std::function<void(T&)> decode;
+    std::function<size_t()> bytes;
+};
+
+template<typename T>
+std::vector<Codec<T>> make_codecs() {
+    std::vector<Codec<T>> codecs;
+    auto buffer = std::make_shared<BufferWriter>();
+    auto text = std::make_shared<std::string>();
+
+    codecs.push_back({"binary", "memory",
+                      [buffer](const T& v) {
+                          buffer->clear();
+                          BinarySerialization::serialize(v, *buffer);
+                      },
+                      [buffer](T& v) {
+                          BufferReader reader(buffer->data(), buffer->size());
+                          BinarySerialization::deserialize(v, reader);
+                      },
+                      [buffer] { return buffer->size(); }});
+    codecs.push_back({"binary-compact", "memory",
+                      [buffer](const T& v) {
+                          buffer->clear();
+                          CompactWriter<BufferWriter> writer(*buffer);
+                          BinarySerialization::serialize(v, writer);
+                      },
+                      [buffer](T& v) {
+                          BufferReader inner(buffer->data(), buffer->size());
+                          CompactReader<BufferReader> reader(inner);
+                          BinarySerialization::deserialize(v, reader);
+                      },
+                      [buffer] { return buffer->size(); }});
+    codecs.push_back({"xml-dom", "memory",
+                      [text](const T& v) {
+                          tinyxml2::XMLDocument doc;
+                          auto* root = doc.NewElement("serialization");
+                          doc.InsertFirstChild(root);
+                          auto* element = doc.NewElement("value");
+                          root->InsertEndChild(element);
+                          xml_serialization::serialize_xml(v, "value", element);
+                          tinyxml2::XMLPrinter printer;
+                          doc.Print(&printer);
+                          text->assign(printer.CStr(), printer.CStrSize() - 1);
+                      },
+                      [text](T& v) {
+                          tinyxml2::XMLDocument doc;
+                          doc.Parse(text->data(), text->size());
+                          const auto* root = doc.FirstChildElement("serialization");
+                          xml_serialization::deserialize_xml(v, "value", root ? root->FirstChildElement("value") : nullptr);
+                      },
+                      [text] { return text->size(); }});
+    codecs.push_back({"xml-stream", "memory",
+                      [text](const T& v) {
+                          xml_serialization::XmlStreamWriter writer;
+                          writer.save("value", v);
+                          writer.close();
+                          text->assign(writer.c_str(), writer.size());
+                      },
+                      [text](T& v) {
+                          auto reader = xml_serialization::XmlPullReader::from_buffer(text->data(), text->size());
+                          if (reader.next() && reader.next() && reader.event() == xml_serialization::XmlPullReader::StartElement) {
+                              xml_serialization::read_xml(v, reader);
+                          }
+                      },
+                      [text] { return text->size(); }});
+
+    codecs.push_back({"binary", "file",
+                      [](const T& v) { BinarySerialization::serialize(v, kTempFile); },
+                      [](T& v) { BinarySerialization::deserialize(v, kTempFile); },
+                      [] { return file_size(kTempFile); }});
+    codecs.push_back({"binary-compact", "file",
+                      [](const T& v) { BinarySerialization::serialize_compact(v, kTempFile); },
+                      [](T& v) { BinarySerialization::deserialize_compact(v, kTempFile); },
+                      [] { return file_size(kTempFile); }});
+    codecs.push_back({"xml-dom", "file",
+                      [](const T& v) { xml_serialization::serialize_xml(v, "value", kTempFile); },
+                      [](T& v) { xml_serialization::deserialize_xml(v, "value", kTempFile); },
+                      [] { return file_size(kTempFile); }});
+    codecs.push_back({"xml-stream", "file",
+                      [](const T& v) { xml_serialization::stream_serialize_xml(v, "value", kTempFile); },
+                      [](T& v) { xml_serialization::stream_deserialize_xml(v, "value", kTempFile); },
+                      [] { return file_size(kTempFile); }});
+    return codecs;
+}
+
+template<typename T>
+void run_family(const std::string& family, size_t size, const T& value, const Options& options,
+                std::vector<Result>& results) {
+    for (auto& codec : make_codecs<T>()) {
+        std::string label = family + "/" + std::to_string(size) + "/" + codec.backend + "/" + codec.sink;
+        if (!options.filter.empty() && label.find(options.filter) == std::string::npos) continue;
+
+        Result r{family, size, codec.backend, codec.sink, 0, 0, 0, 0, 0, false};
+        r.encodeNs = ns_per_op([&] { codec.encode(value); }, options.minMs);
+        r.encodeAllocs = allocations_of([&] { codec.encode(value); });
+        r.bytes = codec.bytes();
+        r.decodeNs = ns_per_op([&] { T out{}; codec.decode(out); }, options.minMs);
+        r.decodeAllocs = allocations_of([&] { T out{}; codec.decode(out); });
+        T out{};
+        codec.decode(out);
+        r.roundTrip = out == value;
+
+        std::printf("%-24s %7zu %-15s %-7s %10zu %12.1f %12.1f %9.1f %9.1f %6zu %6zu %s\n",
+                    family.c_str(), size, codec.backend, codec.sink, r.bytes, r.encodeNs, r.decodeNs,
+                    r.bytes / r.encodeNs * 1e3, r.bytes / r.decodeNs * 1e3, r.encodeAllocs, r.decodeAllocs,
+                    r.roundTrip ? "" : "ROUND-TRIP MISMATCH");
+        std::fflush(stdout);
+        results.push_back(std::move(r));
+    }
+}
+
+void run_all(const Options& options, std::vector<Result>& results) {
+    run_family("int", 1, 123456789, options, results);
+    run_family("double", 1, 3.14159265358979, options, results);
+    run_family("pair<int,double>", 1, std::make_pair(7, 2.5), options, results);
+
+    for (size_t n : options.sizes) {
+        run_family("string", n, std::string(n, 'x'), options, results);
+
+        std::vector<int> ints(n);
+        std::vector<double> doubles(n);
+        std::list<double> list;
+        std::set<int> set;
+        std::map<int, std::string> map;
+        std::vector<BenchRecord> records(n / 16 + 1);
+        for (size_t i = 0; i < n; ++i) {
+            ints[i] = static_cast<int>(i * 2654435761u);
+            doubles[i] = 0.5 * static_cast<double>(i);
+            list.push_back(1.25 * static_cast<double>(i));
+            set.insert(static_cast<int>(i * 7));
+            map.emplace(static_cast<int>(i), "value-" + std::to_string(i));
+        }
+        for (size_t i = 0; i < records.size(); ++i) {
+            records[i].id = static_cast<int>(i);
+            records[i].name = "record-" + std::to_string(i);
+            records[i].data.assign(16, 0.25 * static_cast<double>(i));
+        }
+
+        run_family("vector<int>", n, ints, options, results);
+        run_family("vector<double>", n, doubles, options, results);
+        run_family("list<double>", n, list, options, results);
+        run_family("set<int>", n, set, options, results);
+        run_family("map<int,string>", n, map, options, results);
+        run_family("vector<BenchRecord>", records.size(), records, options, results);
+    }
+}
+
+std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+bool write_json(const std::string& path, const std::vector<Result>& results) {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "[\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::fprintf(f,
+                     "  {\"family\": \"%s\", \"size\": %zu, \"backend\": \"%s\", \"sink\": \"%s\", \"bytes\": %zu, "
+                     "\"encode_ns\": %.1f, \"decode_ns\": %.1f, \"encode_mb_s\": %.2f, \"decode_mb_s\": %.2f, "
+                     "\"encode_allocs\": %zu, \"decode_allocs\": %zu, \"round_trip\": %s}%s\n",
+                     json_escape(r.family).c_str(), r.size, r.backend.c_str(), r.sink.c_str(), r.bytes, r.encodeNs,
+                     r.decodeNs, r.bytes / r.encodeNs * 1e3, r.bytes / r.decodeNs * 1e3, r.encodeAllocs,
+                     r.decodeAllocs, r.roundTrip ? "true" : "false", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "]\n");
+    return std::fclose(f) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            options.sizes = {16, 1024};
+            options.minMs = 5;
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-ms" && i + 1 < argc) {
+            options.minMs = std::atof(argv[++i]);
+        } else if (arg == "--json" && i + 1 < argc) {
+            options.json = argv[++i];
+        } else {
+            std::fprintf(stderr, "usage: %s [--quick] [--filter substring] [--min-ms ms] [--json file]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::printf("%-24s %7s %-15s %-7s %10s %12s %12s %9s %9s %6s %6s\n", "family", "size", "backend", "sink", "bytes",
+                "enc ns/op", "dec ns/op", "enc MB/s", "dec MB/s", "e.alc", "d.alc");
+    std::vector<Result> results;
+    run_all(options, results);
+    std::remove(kTempFile);
+
+    bool ok = true;
+    for (const auto& r : results) ok = ok && r.roundTrip;
+    if (!options.json.empty() && !write_json(options.json, results)) {
+        std::fprintf(stderr, "failed to write %s\n", options.json.c_str());
+        return 1;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,307 @@
+#ifndef BINARY_ARCHIVE_H
+#define BINARY_ARCHIVE_H
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_WIN32)
+#define BINARY_SERIALIZATION_LITTLE_ENDIAN 1
+#else
+#define BINARY_SERIALIZATION_LITTLE_ENDIAN 0
+#endif
+
+namespace BinarySerialization {
+
+// ========== Archive 概念 ==========
+// 写端只需提供 write(const char*, size_t)，读端只需提供 read(char*, size_t)。
+// std::ostream / std::istream 天然满足，可直接作为 Archive 使用。
+template<typename S, typename = void>
+struct is_output_archive : std::false_type {};
+
+template<typename S>
+struct is_output_archive<S, std::void_t<decltype(std::declval<S&>().write(std::declval<const char*>(), size_t()))>>
+    : std::true_type {};
+
+template<typename S, typename = void>
+struct is_input_archive : std::false_type {};
+
+template<typename S>
+struct is_input_archive<S, std::void_t<decltype(std::declval<S&>().read(std::declval<char*>(), size_t()))>>
+    : std::true_type {};
+
+// 支持零拷贝视图的读端：额外提供 consume(size_t)，返回指向底层数据的指针
+template<typename S, typename = void>
+struct is_view_archive : std::false_type {};
+
+template<typename S>
+struct is_view_archive<S, std::void_t<decltype(std::declval<const char*&>() = std::declval<S&>().consume(size_t()))>>
+    : std::true_type {};
+
+template<typename S>
+using enable_if_output_t = typename std::enable_if<is_output_archive<S>::value, void>::type;
+
+template<typename S>
+using enable_if_input_t = typename std::enable_if<is_input_archive<S>::value, void>::type;
+
+// ========== BufferWriter ==========
+// 内存写端：默认使用自增长的连续缓冲区；也可以写入调用方持有的固定缓冲区，写满时抛异常
+class BufferWriter {
+public:
+    BufferWriter() = default;
+
+    explicit BufferWriter(size_t reserveBytes) { reserve(reserveBytes); }
+
+    BufferWriter(char* data, size_t capacity) : data_(data), capacity_(capacity), fixed_(true) {}
+
+    BufferWriter(const BufferWriter&) = delete;
+    BufferWriter& operator=(const BufferWriter&) = delete;
+    BufferWriter(BufferWriter&& other) noexcept { *this = std::move(other); }
+
+    BufferWriter& operator=(BufferWriter&& other) noexcept {
+        owned_ = std::move(other.owned_);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, 0);
+        fixed_ = std::exchange(other.fixed_, false);
+        return *this;
+    }
+
+    void write(const char* p, size_t n) {
+        if (n > capacity_ - size_) grow(n);
+        if (n) std::memcpy(data_ + size_, p, n);
+        size_ += n;
+    }
+
+    void reserve(size_t bytes) {
+        if (bytes > capacity_) reallocate(bytes);
+    }
+
+    void clear() { size_ = 0; }
+
+    // 改写已写出的 [pos, pos + n)：先写占位的长度前缀，元素写完后回填
+    void overwrite(size_t pos, const char* p, size_t n) {
+        if (pos > size_ || n > size_ - pos) throw std::runtime_error("BufferWriter: overwrite past end of buffer");
+        std::memcpy(data_ + pos, p, n);
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+
+    std::string str() const { return std::string(data_, size_); }
+
+private:
+    void grow(size_t n) {
+        if (fixed_) throw std::runtime_error("BufferWriter: fixed buffer overflow");
+        size_t need = size_ + n;
+        size_t next = capacity_ * 2;
+        reallocate(next > need ? next : need);
+    }
+
+    void reallocate(size_t bytes) {
+        if (fixed_) throw std::runtime_error("BufferWriter: cannot resize a fixed buffer");
+        std::unique_ptr<char[]> next(new char[bytes]);
+        if (size_) std::memcpy(next.get(), data_, size_);
+        owned_ = std::move(next);
+        data_ = owned_.get();
+        capacity_ = bytes;
+    }
+
+    std::unique_ptr<char[]> owned_;
+    char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    bool fixed_ = false;
+};
+
+// ========== BufferReader ==========
+// 内存读端：不拥有数据，越界读取抛异常
+class BufferReader {
+public:
+    BufferReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    void read(char* p, size_t n) {
+        if (n > size_ - pos_) throw std::runtime_error("BufferReader: read past end of buffer");
+        if (n) std::memcpy(p, data_ + pos_, n);
+        pos_ += n;
+    }
+
+    // 零拷贝读取：返回指向底层数据的指针，有效期与底层数据相同
+    const char* consume(size_t n) {
+        if (n > size_ - pos_) throw std::runtime_error("BufferReader: read past end of buffer");
+        const char* p = data_ + pos_;
+        pos_ += n;
+        return p;
+    }
+
+    void skip(size_t n) {
+        if (n > size_ - pos_) throw std::runtime_error("BufferReader: read past end of buffer");
+        pos_ += n;
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t position() const { return pos_; }
+    size_t remaining() const { return size_ - pos_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+// ========== CopyingReader ==========
+// 不提供 consume 的内存读端：缓冲区在反序列化返回前就会释放时使用（文件接口的临时映射、解压缓冲区），
+// 经由它反序列化 std::string_view / ArrayView 等视图类型无法通过编译
+class CopyingReader {
+public:
+    CopyingReader(const char* data, size_t size) : in_(data, size) {}
+
+    void read(char* p, size_t n) { in_.read(p, n); }
+    void skip(size_t n) { in_.skip(n); }
+
+    const char* data() const { return in_.data(); }
+    size_t position() const { return in_.position(); }
+    size_t remaining() const { return in_.remaining(); }
+
+private:
+    BufferReader in_;
+};
+
+// ========== FileWriter ==========
+// 带缓冲的文件写端，与 BufferWriter 一样支持 size() / overwrite()，内存占用只有一个缓冲区。
+// 回填的位置仍在缓冲区中时直接改写，已写入文件时 fseek 回去改写再回到文件尾
+class FileWriter {
+public:
+    explicit FileWriter(const std::string& filename, size_t bufferBytes = 64 * 1024)
+        : file_(std::fopen(filename.c_str(), "wb")), buffer_(new char[bufferBytes]), capacity_(bufferBytes) {
+        if (!file_) throw std::runtime_error("Failed to open file for writing");
+    }
+
+    ~FileWriter() {
+        if (file_) {
+            flush_buffer();
+            std::fclose(file_);
+        }
+    }
+
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    void write(const char* p, size_t n) {
+        if (n > capacity_ - used_) {
+            flush();
+            if (n >= capacity_) {
+                put(p, n);
+                flushed_ += n;
+                return;
+            }
+        }
+        if (n) std::memcpy(buffer_.get() + used_, p, n);
+        used_ += n;
+    }
+
+    void overwrite(size_t pos, const char* p, size_t n) {
+        if (pos > size() || n > size() - pos) throw std::runtime_error("FileWriter: overwrite past end of file");
+        if (pos < flushed_) {
+            size_t inFile = flushed_ - pos < n ? flushed_ - pos : n;
+            if (std::fseek(file_, static_cast<long>(pos), SEEK_SET) != 0) throw std::runtime_error("Failed to write file");
+            put(p, inFile);
+            if (std::fseek(file_, 0, SEEK_END) != 0) throw std::runtime_error("Failed to write file");
+            pos += inFile;
+            p += inFile;
+            n -= inFile;
+        }
+        if (n) std::memcpy(buffer_.get() + (pos - flushed_), p, n);
+    }
+
+    size_t size() const { return flushed_ + used_; }
+
+    void flush() {
+        put(buffer_.get(), used_);
+        flushed_ += used_;
+        used_ = 0;
+    }
+
+    // 写出缓冲区并关闭文件；写入失败时抛异常
+    void close() {
+        if (!file_) return;
+        flush();
+        bool failed = std::ferror(file_) != 0;
+        failed = std::fclose(file_) != 0 || failed;
+        file_ = nullptr;
+        if (failed) throw std::runtime_error("Failed to write file");
+    }
+
+private:
+    void put(const char* p, size_t n) {
+        if (n && std::fwrite(p, 1, n, file_) != n) throw std::runtime_error("Failed to write file");
+    }
+
+    // 析构时不抛异常：未调用 close() 时尽量写出剩余数据
+    void flush_buffer() noexcept {
+        if (used_) std::fwrite(buffer_.get(), 1, used_, file_);
+        used_ = 0;
+    }
+
+    std::FILE* file_;
+    std::unique_ptr<char[]> buffer_;
+    size_t capacity_;
+    size_t used_ = 0;
+    size_t flushed_ = 0;
+};
+
+// ========== FileReader ==========
+// 带缓冲的顺序文件读端：内存占用只有一个缓冲区（MappedFile 读过的页会留在 RSS 中），越过文件尾读取抛异常
+class FileReader {
+public:
+    explicit FileReader(const std::string& filename, size_t bufferBytes = 64 * 1024)
+        : file_(std::fopen(filename.c_str(), "rb")), buffer_(new char[bufferBytes]), capacity_(bufferBytes) {
+        if (!file_) throw std::runtime_error("Failed to open file for reading");
+    }
+
+    ~FileReader() { std::fclose(file_); }
+
+    FileReader(const FileReader&) = delete;
+    FileReader& operator=(const FileReader&) = delete;
+
+    void read(char* p, size_t n) {
+        while (n > 0) {
+            if (pos_ == end_) {
+                if (n >= capacity_) {
+                    get(p, n);
+                    return;
+                }
+                end_ = std::fread(buffer_.get(), 1, capacity_, file_);
+                pos_ = 0;
+                if (end_ == 0) throw std::runtime_error("FileReader: read past end of file");
+            }
+            size_t k = end_ - pos_ < n ? end_ - pos_ : n;
+            std::memcpy(p, buffer_.get() + pos_, k);
+            pos_ += k;
+            p += k;
+            n -= k;
+        }
+    }
+
+private:
+    void get(char* p, size_t n) {
+        if (std::fread(p, 1, n, file_) != n) throw std::runtime_error("FileReader: read past end of file");
+    }
+
+    std::FILE* file_;
+    std::unique_ptr<char[]> buffer_;
+    size_t capacity_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+};
+
+} // namespace BinarySerialization
+
+#endif // BINARY_ARCHIVE_H
@@ -0,0 +1,231 @@
+#ifndef BINARY_ASYNC_H
+#define BINARY_ASYNC_H
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "binary_serialization.h"
+
+#if defined(_WIN32)
+#include <filesystem>
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace BinarySerialization {
+
+// ========== 原子写文件 ==========
+// 先写入同目录下的 filename.tmp，落盘后再 rename 覆盖目标文件：读者要么看到旧文件，要么看到完整的新文件
+namespace detail {
+
+#if defined(_WIN32)
+inline void write_file_atomically(const std::string& filename, const char* data, size_t size) {
+    std::string tmp = filename + ".tmp";
+    {
+        std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+        if (!ofs) throw std::runtime_error("Failed to open file for writing");
+        ofs.write(data, size);
+        if (!ofs.flush()) throw std::runtime_error("Failed to write file");
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, filename, ec);
+    if (ec) throw std::runtime_error("Failed to rename file");
+}
+#else
+inline void write_file_atomically(const std::string& filename, const char* data, size_t size) {
+    std::string tmp = filename + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::runtime_error("Failed to open file for writing");
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            ::close(fd);
+            ::unlink(tmp.c_str());
+            throw std::runtime_error("Failed to write file");
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    bool ok = ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if (!ok || std::rename(tmp.c_str(), filename.c_str()) != 0) {
+        ::unlink(tmp.c_str());
+        throw std::runtime_error("Failed to write file");
+    }
+}
+#endif
+
+} // namespace detail
+
+// ========== AsyncFileWriter ==========
+// 后台 I/O 线程按提交顺序把编码好的缓冲区原子地写入文件，调用线程只负责编码：
+//     BufferWriter buffer = writer.acquire();
+//     serialize(state, buffer);
+//     auto done = writer.submit(std::move(buffer), "state.data");
+// queueDepth 是尚未写完的提交数上限（含正在写的一个），达到上限时 submit 阻塞，形成反压。
+// 默认 2 即双缓冲：一个缓冲区在写盘，调用方同时编码下一个。写完的缓冲区保留容量回到池中，由 acquire 复用。
+class AsyncFileWriter {
+public:
+    using Callback = std::function<void(std::exception_ptr)>;
+
+    explicit AsyncFileWriter(size_t queueDepth = 2) : depth_(queueDepth ? queueDepth : 1) {
+        thread_ = std::thread([this] { run(); });
+    }
+
+    // 等待所有已提交的写入完成后退出
+    ~AsyncFileWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+    }
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    size_t queue_depth() const { return depth_; }
+
+    // 取一个空缓冲区：优先复用已写完的缓冲区（保留上次的容量），池空时新建
+    BufferWriter acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pool_.empty()) return BufferWriter();
+        BufferWriter buffer = std::move(pool_.back());
+        pool_.pop_back();
+        return buffer;
+    }
+
+    // 提交写入；写完（或失败）时 future 就绪，失败以异常形式从 get() 抛出
+    std::future<void> submit(BufferWriter&& buffer, const std::string& filename) {
+        auto promise = std::make_shared<std::promise<void>>();
+        std::future<void> future = promise->get_future();
+        enqueue(std::move(buffer), filename, [promise](std::exception_ptr error) {
+            if (error) {
+                promise->set_exception(error);
+            } else {
+                promise->set_value();
+            }
+        });
+        return future;
+    }
+
+    // 回调版本：在 I/O 线程上调用 done，成功时参数为空
+    void submit(BufferWriter&& buffer, const std::string& filename, Callback done) {
+        enqueue(std::move(buffer), filename, std::move(done));
+    }
+
+    // 阻塞到目前为止提交的写入全部完成
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+private:
+    struct Job {
+        BufferWriter buffer;
+        std::string filename;
+        Callback done;
+    };
+
+    void enqueue(BufferWriter&& buffer, const std::string& filename, Callback done) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return pending_ < depth_; });
+        ++pending_;
+        queue_.push_back(Job{std::move(buffer), filename, std::move(done)});
+        lock.unlock();
+        wake_.notify_all();
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) return;
+            Job job = std::move(queue_.front());
+            queue_.pop_front();
+            lock.unlock();
+
+            std::exception_ptr error;
+            try {
+                detail::write_file_atomically(job.filename, job.buffer.data(), job.buffer.size());
+            } catch (...) {
+                error = std::current_exception();
+            }
+            if (job.done) {
+                try {
+                    job.done(error);
+                } catch (...) {
+                    // 回调运行在 I/O 线程上，异常不能再向外传播
+                }
+            }
+            job.buffer.clear();
+
+            lock.lock();
+            if (pool_.size() < depth_) pool_.push_back(std::move(job.buffer));
+            --pending_;
+            idle_.notify_all();
+        }
+    }
+
+    size_t depth_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::deque<Job> queue_;
+    std::vector<BufferWriter> pool_;
+    size_t pending_ = 0;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+// 进程内共享的写入器，队列深度为 2
+inline AsyncFileWriter& default_async_writer() {
+    static AsyncFileWriter writer;
+    return writer;
+}
+
+// ========== 异步文件接口 ==========
+// 在调用线程上编码到池中的缓冲区，写盘交给后台线程；返回时 obj 已不再被引用，可以立即修改
+template<typename T>
+std::future<void> serialize_async(const T& obj, const std::string& filename,
+                                  AsyncFileWriter& writer = default_async_writer()) {
+    BufferWriter buffer = writer.acquire();
+    serialize(obj, buffer);
+    return writer.submit(std::move(buffer), filename);
+}
+
+template<typename T>
+void serialize_async(const T& obj, const std::string& filename, AsyncFileWriter::Callback done,
+                     AsyncFileWriter& writer = default_async_writer()) {
+    BufferWriter buffer = writer.acquire();
+    serialize(obj, buffer);
+    writer.submit(std::move(buffer), filename, std::move(done));
+}
+
+template<typename T>
+std::future<void> serialize_compact_async(const T& obj, const std::string& filename,
+                                          AsyncFileWriter& writer = default_async_writer()) {
+    BufferWriter buffer = writer.acquire();
+    CompactWriter<BufferWriter> compact(buffer);
+    serialize(obj, compact);
+    return writer.submit(std::move(buffer), filename);
+}
+
+} // namespace BinarySerialization
+
+#endif // BINARY_ASYNC_H
@@ -0,0 +1,324 @@
+#ifndef BINARY_COLUMNAR_H
+#define BINARY_COLUMNAR_H
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "binary_serialization.h"
+
+namespace BinarySerialization {
+
+// ========== 列式（struct-of-arrays）编码 ==========
+// 由 BINARY_SERIALIZABLE 类型组成的 std::vector 的另一种线上格式，每个成员单独成列：
+//     [元素个数 N][列数 C][每列字节数 × C][各列数据依次拼接]
+// 列的编码按成员类型选择：
+//   - 可整段拷贝的成员（算术类型、算术 std::array）：N 个值一次写出，紧凑模式下整数为 varint 串
+//   - 字符串、算术元素的 std::vector：偏移数组 + 数据块。偏移数组在默认模式下是 N 个 size_t 的累计结束位置
+//     （可移植模式下固定 8 字节），紧凑模式下是 N 个 varint 长度；数据块是各元素内容依次拼接
+//   - 其他成员：逐元素按普通格式编码
+// 各列字节数写在最前面，读取时可以只解码选中的列（deserialize_columns），其余列直接跳过。
+// 与普通 std::vector 格式不兼容，必须用 deserialize_columnar / deserialize_columns 读取。
+namespace detail {
+
+template<size_t I, typename T>
+using field_t = std::remove_cv_t<std::remove_reference_t<std::tuple_element_t<I, field_tuple_t<T>>>>;
+
+template<typename T>
+struct column_count : std::tuple_size<field_tuple_t<T>> {};
+
+// 偏移数组 + 数据块的列
+template<typename M>
+struct is_blob_column : std::false_type {};
+
+template<typename Traits, typename A>
+struct is_blob_column<std::basic_string<char, Traits, A>> : std::true_type {};
+
+template<typename U, typename A>
+struct is_blob_column<std::vector<U, A>> : is_bulk_vector_element<U> {};
+
+template<typename M>
+using blob_element_t = typename M::value_type;
+
+// 偏移数组的元素类型：可移植模式下固定为 8 字节，与平台的 size_t 宽度无关
+template<typename Stream>
+using column_offset_t = typename std::conditional<is_portable_archive<Stream>::value, uint64_t, size_t>::type;
+
+// 列值经 64 KiB 的暂存区分批收集后整段写出（或整段读入后分发），不为整列分配临时数组
+template<typename V, typename Stream, typename Get>
+void write_gathered(size_t n, Stream& os, Get&& get) {
+    constexpr size_t perChunk = kPairChunkBytes / sizeof(V);
+    std::vector<V> stage(n < perChunk ? n : perChunk);
+    for (size_t begin = 0; begin < n; begin += perChunk) {
+        size_t count = n - begin < perChunk ? n - begin : perChunk;
+        for (size_t i = 0; i < count; ++i) stage[i] = get(begin + i);
+        encode_range(stage.data(), count, os);
+    }
+}
+
+template<typename V, typename Stream, typename Put>
+void read_scattered(size_t n, Stream& is, Put&& put) {
+    constexpr size_t perChunk = kPairChunkBytes / sizeof(V);
+    std::vector<V> stage(n < perChunk ? n : perChunk);
+    for (size_t begin = 0; begin < n; begin += perChunk) {
+        size_t count = n - begin < perChunk ? n - begin : perChunk;
+        decode_range(stage.data(), count, is);
+        for (size_t i = 0; i < count; ++i) put(begin + i, stage[i]);
+    }
+}
+
+template<size_t I, typename T, typename A, typename Stream>
+void encode_column(const std::vector<T, A>& v, Stream& os) {
+    using M = field_t<I, T>;
+    size_t n = v.size();
+    if constexpr (is_bulk_vector_element<M>::value) {
+        write_gathered<M>(n, os, [&](size_t i) { return std::get<I>(field_refs(v[i])); });
+    } else if constexpr (is_blob_column<M>::value) {
+        using Offset = column_offset_t<Stream>;
+        Offset end = 0;
+        write_gathered<Offset>(n, os, [&](size_t i) {
+            Offset size = std::get<I>(field_refs(v[i])).size();
+            if constexpr (is_compact_archive<Stream>::value) return size;
+            return end += size;
+        });
+        for (size_t i = 0; i < n; ++i) {
+            const M& field = std::get<I>(field_refs(v[i]));
+            encode_range(field.data(), field.size(), os);
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) serialize(std::get<I>(field_refs(v[i])), os);
+    }
+}
+
+// bytes 为本列的字节数，用来在分配前校验偏移数组
+template<size_t I, typename T, typename A, typename Stream>
+void decode_column(std::vector<T, A>& v, Stream& is, size_t bytes) {
+    using M = field_t<I, T>;
+    size_t n = v.size();
+    if constexpr (is_bulk_vector_element<M>::value) {
+        read_scattered<M>(n, is, [&](size_t i, const M& value) { std::get<I>(field_refs(v[i])) = value; });
+    } else if constexpr (is_blob_column<M>::value) {
+        std::vector<column_offset_t<Stream>> offsets(n);
+        decode_range(offsets.data(), n, is);
+        if constexpr (!is_compact_archive<Stream>::value) {
+            for (size_t i = n; i-- > 1;) {
+                if (offsets[i] < offsets[i - 1]) throw std::runtime_error("deserialize_columnar: invalid offsets");
+                offsets[i] -= offsets[i - 1];
+            }
+        }
+        size_t total = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (offsets[i] > bytes / sizeof(blob_element_t<M>) - total) {
+                throw std::runtime_error("deserialize_columnar: invalid offsets");
+            }
+            total += static_cast<size_t>(offsets[i]);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            M& field = std::get<I>(field_refs(v[i]));
+            field.resize(static_cast<size_t>(offsets[i]));
+            decode_range(field.data(), offsets[i], is);
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) deserialize(std::get<I>(field_refs(v[i])), is);
+    }
+}
+
+// 整段拷贝列与偏移数组列中按值写出的元素
+template<typename M, bool = is_blob_column<M>::value>
+struct sized_column_element { using type = M; };
+
+template<typename M>
+struct sized_column_element<M, true> { using type = blob_element_t<M>; };
+
+// 默认模式下整段拷贝列与偏移数组列的字节数可以直接算出，这些列不经缓冲直接写到输出；
+// 可移植模式下还要求元素的线上宽度与内存宽度相同
+template<typename Stream, typename M>
+struct is_sized_column
+    : std::integral_constant<bool, !is_compact_archive<Stream>::value &&
+                                   (is_bulk_vector_element<M>::value || is_blob_column<M>::value) &&
+                                   !(is_portable_archive<Stream>::value &&
+                                     !is_portable_bulk<typename sized_column_element<M>::type>::value)> {};
+
+template<typename Stream, size_t I, typename T, typename A>
+size_t sized_column_bytes(const std::vector<T, A>& v) {
+    using M = field_t<I, T>;
+    if constexpr (is_bulk_vector_element<M>::value) {
+        return v.size() * sizeof(M);
+    } else {
+        size_t elements = 0;
+        for (const auto& item : v) elements += std::get<I>(field_refs(item)).size();
+        return v.size() * sizeof(column_offset_t<Stream>) + elements * sizeof(blob_element_t<M>);
+    }
+}
+
+// 其余列先编码到独立的内存缓冲区（模式与外层 Archive 相同，可移植模式不带格式头、沿用外层的字节序），
+// 得到字节数后再写出
+template<typename Stream, size_t I, typename T, typename A>
+size_t prepare_column(const std::vector<T, A>& v, BufferWriter& buffer, ByteOrder order) {
+    if constexpr (is_sized_column<Stream, field_t<I, T>>::value) {
+        return sized_column_bytes<Stream, I>(v);
+    } else if constexpr (is_compact_archive<Stream>::value) {
+        CompactWriter<BufferWriter> writer(buffer);
+        encode_column<I>(v, writer);
+        return buffer.size();
+    } else if constexpr (is_portable_archive<Stream>::value) {
+        PortableWriter<BufferWriter> writer(buffer, order, PortableNoHeader{});
+        encode_column<I>(v, writer);
+        return buffer.size();
+    } else {
+        encode_column<I>(v, buffer);
+        return buffer.size();
+    }
+}
+
+template<typename Stream, size_t I, typename T, typename A>
+void write_column(const std::vector<T, A>& v, const BufferWriter& buffer, Stream& os) {
+    if constexpr (is_sized_column<Stream, field_t<I, T>>::value) {
+        encode_column<I>(v, os);
+    } else {
+        os.write(buffer.data(), buffer.size());
+    }
+}
+
+template<typename Stream, size_t I, typename T, typename A>
+void decode_column_from(std::vector<T, A>& v, const char* data, size_t size, ByteOrder order) {
+    using Reader = segment_reader_t<Stream>;
+    Reader reader(data, size);
+    if constexpr (is_compact_archive<Stream>::value) {
+        CompactReader<Reader> compact(reader);
+        decode_column<I>(v, compact, size);
+    } else if constexpr (is_portable_archive<Stream>::value) {
+        PortableReader<Reader> portable(reader, order, PortableNoHeader{});
+        decode_column<I>(v, portable, size);
+    } else {
+        decode_column<I>(v, reader, size);
+    }
+    if (reader.remaining() != 0) throw std::runtime_error("deserialize_columnar: column size mismatch");
+}
+
+template<typename T, typename A, typename Stream, size_t... I>
+void encode_columns(const std::vector<T, A>& v, Stream& os, std::index_sequence<I...>) {
+    constexpr size_t columns = sizeof...(I);
+    std::array<BufferWriter, columns> buffers;
+    ByteOrder order = byte_order_of(os);
+    std::array<size_t, columns> sizes{{prepare_column<Stream, I>(v, buffers[I], order)...}};
+    write_length(os, v.size());
+    write_length(os, columns);
+    for (size_t size : sizes) write_length(os, size);
+    (write_column<Stream, I>(v, buffers[I], os), ...);
+}
+
+template<typename Stream, typename T, typename A, typename Offsets, typename Selected, size_t... I>
+void decode_columns(std::vector<T, A>& v, const char* base, const Offsets& offsets, const Selected& selected,
+                    ByteOrder order, std::index_sequence<I...>) {
+    ((selected[I] ? decode_column_from<Stream, I>(v, base + offsets[I], offsets[I + 1] - offsets[I], order) : void()),
+     ...);
+}
+
+template<typename T, typename A, typename Stream, typename Selected>
+void deserialize_selected(std::vector<T, A>& v, Stream& is, const Selected& selected) {
+    constexpr size_t columns = column_count<T>::value;
+    size_t n = read_length(is);
+    if (read_length(is) != columns) throw std::runtime_error("deserialize_columnar: column count mismatch");
+    std::array<size_t, columns + 1> offsets{};
+    for (size_t c = 0; c < columns; ++c) {
+        size_t size = read_length(is);
+        if (size > SIZE_MAX - offsets[c]) throw std::runtime_error("deserialize_columnar: invalid column size");
+        offsets[c + 1] = offsets[c] + size;
+    }
+    size_t total = offsets[columns];
+
+    // 读端支持 consume 时未选中的列不会被拷贝，成员可以是指向输入的视图；
+    // 否则整段读入内存再按列解码（CopyingReader 直接在其数据上解码），成员不能是视图类型
+    std::unique_ptr<char[]> owned;
+    const char* base = take_segments(is, total, owned);
+
+    v.resize(n);
+    decode_columns<Stream>(v, base, offsets, selected, byte_order_of(is), std::make_index_sequence<columns>{});
+}
+
+// 成员指针对应的列号：在一个默认构造的元素上比较成员地址
+template<typename T, typename... M>
+std::array<bool, column_count<T>::value> select_columns(M T::*... members) {
+    constexpr size_t columns = column_count<T>::value;
+    T probe{};
+    std::array<const void*, columns> addresses{};
+    std::apply([&](auto&... fields) {
+        size_t c = 0;
+        ((addresses[c++] = &fields), ...);
+    }, field_refs(probe));
+    std::array<bool, columns> selected{};
+    auto mark = [&](const void* address) {
+        for (size_t c = 0; c < columns; ++c) {
+            if (addresses[c] == address) {
+                selected[c] = true;
+                return;
+            }
+        }
+        throw std::runtime_error("deserialize_columns: member is not listed in BINARY_SERIALIZABLE");
+    };
+    (mark(&(probe.*members)), ...);
+    return selected;
+}
+
+} // namespace detail
+
+template<typename T, typename A, typename Stream>
+enable_if_output_t<Stream> serialize_columnar(const std::vector<T, A>& v, Stream& os) {
+    static_assert(detail::has_binary_fields<T>::value, "serialize_columnar requires a BINARY_SERIALIZABLE element type");
+    detail::encode_columns(v, os, std::make_index_sequence<detail::column_count<T>::value>{});
+}
+
+// 解码全部列
+template<typename T, typename A, typename Stream>
+enable_if_input_t<Stream> deserialize_columnar(std::vector<T, A>& v, Stream& is) {
+    static_assert(detail::has_binary_fields<T>::value, "deserialize_columnar requires a BINARY_SERIALIZABLE element type");
+    std::array<bool, detail::column_count<T>::value> selected;
+    selected.fill(true);
+    detail::deserialize_selected(v, is, selected);
+}
+
+// 只解码给出的成员，例如 deserialize_columns(rows, reader, &Row::idx)。
+// 元素个数按文件调整；未选中的成员保持原值（新增元素为默认值）
+template<typename T, typename A, typename Stream, typename... M>
+enable_if_input_t<Stream> deserialize_columns(std::vector<T, A>& v, Stream& is, M T::*... members) {
+    static_assert(detail::has_binary_fields<T>::value, "deserialize_columns requires a BINARY_SERIALIZABLE element type");
+    static_assert(sizeof...(M) > 0, "deserialize_columns requires at least one member");
+    detail::deserialize_selected(v, is, detail::select_columns<T>(members...));
+}
+
+// 文件接口
+template<typename T, typename A>
+void serialize_columnar(const std::vector<T, A>& v, const std::string& filename) {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) throw std::runtime_error("Failed to open file for writing");
+    BufferWriter writer;
+    serialize_columnar(v, writer);
+    ofs.write(writer.data(), writer.size());
+    if (!ofs) throw std::runtime_error("Failed to write file");
+}
+
+// 映射在返回时释放，成员不能是视图类型
+template<typename T, typename A>
+void deserialize_columnar(std::vector<T, A>& v, const std::string& filename) {
+    MappedFile file(filename);
+    CopyingReader reader(file.data(), file.size());
+    deserialize_columnar(v, reader);
+}
+
+template<typename T, typename A, typename... M>
+void deserialize_columns(std::vector<T, A>& v, const std::string& filename, M T::*... members) {
+    MappedFile file(filename);
+    CopyingReader reader(file.data(), file.size());
+    deserialize_columns(v, reader, members...);
+}
+
+} // namespace BinarySerialization
+
+#endif // BINARY_COLUMNAR_H
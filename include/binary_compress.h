@@ -0,0 +1,483 @@
+#ifndef BINARY_COMPRESS_H
+#define BINARY_COMPRESS_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "binary_serialization.h"
+#include "binary_parallel.h"
+#include "binary_lz.h"
+
+#if defined(BINARY_SERIALIZATION_WITH_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace BinarySerialization {
+
+// ========== 块压缩编解码器 ==========
+// 压缩阶段位于编码之后、写出之前，按固定大小的原始字节块独立压缩。
+// 编解码器通过 id 登记，读端按文件中记录的 id 找回对应实现：
+//     0  不压缩（所有块原样存储）
+//     1  内置 LZ（binary_lz.h），速度优先
+//     2  zlib（定义 BINARY_SERIALIZATION_WITH_ZLIB 并链接 zlib 时可用），压缩率优先
+// 自定义编解码器继承 BlockCodec，使用 2 以上未占用的 id，并在读写之前 register_codec。
+class BlockCodec {
+public:
+    virtual ~BlockCodec() = default;
+
+    virtual uint32_t id() const = 0;
+    virtual const char* name() const = 0;
+
+    // n 字节输入压缩后的最大可能大小
+    virtual size_t bound(size_t n) const = 0;
+
+    // 返回压缩后的字节数；capacity 不够或无法压缩时返回 0（该块将原样存储）
+    virtual size_t compress(const char* src, size_t n, char* dst, size_t capacity) const = 0;
+
+    // 解压出恰好 rawSize 字节；输入损坏时返回 false
+    virtual bool decompress(const char* src, size_t n, char* dst, size_t rawSize) const = 0;
+};
+
+class StoreCodec : public BlockCodec {
+public:
+    uint32_t id() const override { return 0; }
+    const char* name() const override { return "store"; }
+    size_t bound(size_t) const override { return 0; }
+    size_t compress(const char*, size_t, char*, size_t) const override { return 0; }
+    bool decompress(const char*, size_t, char*, size_t) const override { return false; }
+};
+
+class LzCodec : public BlockCodec {
+public:
+    uint32_t id() const override { return 1; }
+    const char* name() const override { return "lz"; }
+    size_t bound(size_t n) const override { return lz_compress_bound(n); }
+
+    size_t compress(const char* src, size_t n, char* dst, size_t capacity) const override {
+        return lz_compress(src, n, dst, capacity);
+    }
+
+    bool decompress(const char* src, size_t n, char* dst, size_t rawSize) const override {
+        return lz_decompress(src, n, dst, rawSize);
+    }
+};
+
+#if defined(BINARY_SERIALIZATION_WITH_ZLIB)
+// level 只影响写端；读端不需要知道压缩级别，因此所有级别共用 id 2
+class ZlibCodec : public BlockCodec {
+public:
+    explicit ZlibCodec(int level = Z_DEFAULT_COMPRESSION) : level_(level) {}
+
+    uint32_t id() const override { return 2; }
+    const char* name() const override { return "zlib"; }
+    size_t bound(size_t n) const override { return compressBound(static_cast<uLong>(n)); }
+
+    size_t compress(const char* src, size_t n, char* dst, size_t capacity) const override {
+        uLongf size = static_cast<uLongf>(capacity);
+        int rc = compress2(reinterpret_cast<Bytef*>(dst), &size, reinterpret_cast<const Bytef*>(src),
+                           static_cast<uLong>(n), level_);
+        return rc == Z_OK ? static_cast<size_t>(size) : 0;
+    }
+
+    bool decompress(const char* src, size_t n, char* dst, size_t rawSize) const override {
+        uLongf size = static_cast<uLongf>(rawSize);
+        int rc = uncompress(reinterpret_cast<Bytef*>(dst), &size, reinterpret_cast<const Bytef*>(src),
+                            static_cast<uLong>(n));
+        return rc == Z_OK && size == rawSize;
+    }
+
+private:
+    int level_;
+};
+#endif
+
+namespace detail {
+
+struct CodecRegistry {
+    std::mutex mutex;
+    std::vector<const BlockCodec*> codecs;
+
+    CodecRegistry() {
+        static const StoreCodec store;
+        static const LzCodec lz;
+        codecs = {&store, &lz};
+#if defined(BINARY_SERIALIZATION_WITH_ZLIB)
+        static const ZlibCodec zlib;
+        codecs.push_back(&zlib);
+#endif
+    }
+};
+
+inline CodecRegistry& codec_registry() {
+    static CodecRegistry registry;
+    return registry;
+}
+
+} // namespace detail
+
+// 登记（或替换）一个编解码器；codec 须在之后的所有读写期间存活
+inline void register_codec(const BlockCodec& codec) {
+    auto& registry = detail::codec_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto& c : registry.codecs) {
+        if (c->id() == codec.id()) {
+            c = &codec;
+            return;
+        }
+    }
+    registry.codecs.push_back(&codec);
+}
+
+// 按 id 查找；未登记时返回 nullptr
+inline const BlockCodec* find_codec(uint32_t id) {
+    auto& registry = detail::codec_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const BlockCodec* c : registry.codecs) {
+        if (c->id() == id) return c;
+    }
+    return nullptr;
+}
+
+inline const BlockCodec& default_codec() { return *find_codec(1); }
+
+// ========== 压缩容器格式 ==========
+// 原始字节按 blockSize 切块，每块独立压缩，因此可以并行解压，也可以只解压某一块（随机访问）：
+//     [块 0][块 1]...[块 B-1]
+//     [块表：每块 原始大小（uint32）、存储大小（uint32）]
+//     [尾部：原始总字节数（uint64）、块数（uint64）、blockSize（uint32）、编解码器 id（uint32）、魔数（uint32）]
+// 存储大小等于原始大小的块是原样存储的（压缩后不更小）。
+namespace detail {
+
+constexpr uint32_t kCompressMagic = 0x504D4342; // "BCMP"
+constexpr size_t kCompressFooterSize = 2 * sizeof(uint64_t) + 3 * sizeof(uint32_t);
+constexpr size_t kCompressIndexEntrySize = 2 * sizeof(uint32_t);
+
+struct BlockEntry {
+    uint64_t offset;
+    uint32_t rawSize;
+    uint32_t storedSize;
+};
+
+// 压缩一块写入 dst，返回写入的字节数；压缩后不更小时原样拷贝。dst 至少 compressed_capacity(codec, n) 字节
+inline size_t compressed_capacity(const BlockCodec& codec, size_t n) {
+    size_t b = codec.bound(n);
+    return b > n ? b : n;
+}
+
+inline size_t compress_block(const BlockCodec& codec, const char* src, size_t n, char* dst, size_t capacity) {
+    size_t c = codec.compress(src, n, dst, capacity);
+    if (c == 0 || c >= n) {
+        std::memcpy(dst, src, n);
+        return n;
+    }
+    return c;
+}
+
+inline void check_block_size(size_t blockSize) {
+    if (blockSize == 0 || blockSize > UINT32_MAX) throw std::invalid_argument("compress: invalid block size");
+}
+
+template<typename Stream>
+void write_compressed_trailer(Stream& os, const std::vector<BlockEntry>& blocks, uint64_t rawTotal,
+                              size_t blockSize, uint32_t codecId) {
+    BufferWriter trailer(blocks.size() * kCompressIndexEntrySize + kCompressFooterSize);
+    for (const auto& b : blocks) {
+        trailer.write(reinterpret_cast<const char*>(&b.rawSize), sizeof(b.rawSize));
+        trailer.write(reinterpret_cast<const char*>(&b.storedSize), sizeof(b.storedSize));
+    }
+    uint64_t count = blocks.size();
+    uint32_t bs = static_cast<uint32_t>(blockSize);
+    uint32_t magic = kCompressMagic;
+    trailer.write(reinterpret_cast<const char*>(&rawTotal), sizeof(rawTotal));
+    trailer.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    trailer.write(reinterpret_cast<const char*>(&bs), sizeof(bs));
+    trailer.write(reinterpret_cast<const char*>(&codecId), sizeof(codecId));
+    trailer.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    os.write(trailer.data(), trailer.size());
+}
+
+} // namespace detail
+
+constexpr size_t kDefaultCompressBlock = 256 << 10;
+
+// ========== CompressedWriter ==========
+// 输出 Archive 适配器：写入的字节攒满一块就压缩写出，finish() 写出最后一块和块表。
+// 析构时若尚未 finish 会自动调用（异常被吞掉，需要错误信息时显式调用 finish）。
+//     std::ofstream ofs("snapshot.bin", std::ios::binary);
+//     CompressedWriter<std::ofstream> out(ofs);
+//     serialize(obj, out);
+//     out.finish();
+// 可以再套一层 CompactWriter 使用紧凑模式。
+template<typename Out>
+class CompressedWriter {
+public:
+    explicit CompressedWriter(Out& out, const BlockCodec& codec = default_codec(),
+                              size_t blockSize = kDefaultCompressBlock)
+        : out_(out), codec_(codec), blockSize_(blockSize) {
+        detail::check_block_size(blockSize);
+        block_.reset(new char[blockSize]);
+        capacity_ = detail::compressed_capacity(codec, blockSize);
+        scratch_.reset(new char[capacity_]);
+    }
+
+    ~CompressedWriter() {
+        try {
+            finish();
+        } catch (...) {
+        }
+    }
+
+    CompressedWriter(const CompressedWriter&) = delete;
+    CompressedWriter& operator=(const CompressedWriter&) = delete;
+
+    void write(const char* p, size_t n) {
+        if (finished_) throw std::logic_error("CompressedWriter: write after finish");
+        while (n > 0) {
+            size_t room = blockSize_ - fill_;
+            size_t k = n < room ? n : room;
+            std::memcpy(block_.get() + fill_, p, k);
+            fill_ += k;
+            p += k;
+            n -= k;
+            if (fill_ == blockSize_) emit();
+        }
+    }
+
+    void finish() {
+        if (finished_) return;
+        finished_ = true;
+        if (fill_ > 0) emit();
+        detail::write_compressed_trailer(out_, blocks_, rawTotal_, blockSize_, codec_.id());
+    }
+
+    // 至今写入的原始字节数
+    uint64_t raw_size() const { return rawTotal_ + fill_; }
+
+private:
+    void emit() {
+        size_t stored = detail::compress_block(codec_, block_.get(), fill_, scratch_.get(), capacity_);
+        out_.write(scratch_.get(), stored);
+        blocks_.push_back({offset_, static_cast<uint32_t>(fill_), static_cast<uint32_t>(stored)});
+        offset_ += stored;
+        rawTotal_ += fill_;
+        fill_ = 0;
+    }
+
+    Out& out_;
+    const BlockCodec& codec_;
+    size_t blockSize_;
+    size_t capacity_;
+    std::unique_ptr<char[]> block_;
+    std::unique_ptr<char[]> scratch_;
+    size_t fill_ = 0;
+    uint64_t offset_ = 0;
+    uint64_t rawTotal_ = 0;
+    std::vector<detail::BlockEntry> blocks_;
+    bool finished_ = false;
+};
+
+// 把 [data, data + size) 整段按块并行压缩后写入 os，格式与 CompressedWriter 相同
+template<typename Stream>
+enable_if_output_t<Stream> compress_blocks(const char* data, size_t size, Stream& os,
+                                           const BlockCodec& codec = default_codec(),
+                                           size_t blockSize = kDefaultCompressBlock,
+                                           ThreadPool& pool = default_thread_pool()) {
+    detail::check_block_size(blockSize);
+    size_t count = (size + blockSize - 1) / blockSize;
+    size_t capacity = detail::compressed_capacity(codec, blockSize);
+    std::vector<std::unique_ptr<char[]>> buffers(count);
+    std::vector<detail::BlockEntry> blocks(count);
+    pool.parallel_for(count, [&](size_t i) {
+        size_t begin = i * blockSize;
+        size_t n = size - begin < blockSize ? size - begin : blockSize;
+        buffers[i].reset(new char[capacity]);
+        blocks[i].rawSize = static_cast<uint32_t>(n);
+        blocks[i].storedSize = static_cast<uint32_t>(detail::compress_block(codec, data + begin, n, buffers[i].get(), capacity));
+    });
+    uint64_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        blocks[i].offset = offset;
+        offset += blocks[i].storedSize;
+        os.write(buffers[i].get(), blocks[i].storedSize);
+    }
+    detail::write_compressed_trailer(os, blocks, size, blockSize, codec.id());
+}
+
+// ========== CompressedReader ==========
+// 输入 Archive：按需解压当前块，顺序读取时内存占用只有一块。
+// seek(rawOffset) 跳到原始字节流的任意位置，只解压目标所在的块；
+// decompress_all 在线程池上并行解压全部块。
+// 构造时校验尾部与块表，数据损坏或编解码器未登记时抛异常。
+class CompressedReader {
+public:
+    explicit CompressedReader(const std::string& filename)
+        : file_(new MappedFile(filename)) {
+        open(file_->data(), file_->size());
+    }
+
+    CompressedReader(const char* data, size_t size) { open(data, size); }
+
+    void read(char* p, size_t n) {
+        while (n > 0) {
+            if (pos_ == current_.rawSize) {
+                if (next_ >= blocks_.size()) throw std::runtime_error("CompressedReader: read past end");
+                load(next_);
+            }
+            size_t avail = current_.rawSize - pos_;
+            size_t k = n < avail ? n : avail;
+            std::memcpy(p, block_.get() + pos_, k);
+            pos_ += k;
+            p += k;
+            n -= k;
+        }
+    }
+
+    // 定位到原始字节流的 rawOffset 处；rawOffset == raw_size() 表示末尾
+    void seek(uint64_t rawOffset) {
+        if (rawOffset > rawSize_) throw std::runtime_error("CompressedReader: seek past end");
+        size_t i = static_cast<size_t>(rawOffset / blockSize_);
+        if (i == blocks_.size()) {
+            current_ = {0, 0, 0};
+            pos_ = 0;
+            next_ = blocks_.size();
+            return;
+        }
+        if (loaded_ != i) load(i);
+        current_ = blocks_[i];
+        next_ = i + 1;
+        pos_ = static_cast<size_t>(rawOffset - static_cast<uint64_t>(i) * blockSize_);
+    }
+
+    uint64_t raw_size() const { return rawSize_; }
+    size_t block_count() const { return blocks_.size(); }
+    const BlockCodec& codec() const { return *codec_; }
+
+    // 解压全部块到 dst（至少 raw_size() 字节），不影响当前读取位置
+    void decompress_all(char* dst, ThreadPool& pool = default_thread_pool()) const {
+        pool.parallel_for(blocks_.size(), [&](size_t i) {
+            decode(i, dst + static_cast<uint64_t>(i) * blockSize_);
+        });
+    }
+
+private:
+    void open(const char* data, size_t size) {
+        using namespace detail;
+        data_ = data;
+        if (size < kCompressFooterSize) throw std::runtime_error("CompressedReader: invalid footer");
+        const char* footer = data + size - kCompressFooterSize;
+        uint64_t count;
+        uint32_t blockSize, codecId, magic;
+        std::memcpy(&rawSize_, footer, sizeof(rawSize_));
+        std::memcpy(&count, footer + 8, sizeof(count));
+        std::memcpy(&blockSize, footer + 16, sizeof(blockSize));
+        std::memcpy(&codecId, footer + 20, sizeof(codecId));
+        std::memcpy(&magic, footer + 24, sizeof(magic));
+        if (magic != kCompressMagic || blockSize == 0) throw std::runtime_error("CompressedReader: invalid footer");
+        if (count > (size - kCompressFooterSize) / kCompressIndexEntrySize) {
+            throw std::runtime_error("CompressedReader: invalid footer");
+        }
+        codec_ = find_codec(codecId);
+        if (!codec_) throw std::runtime_error("CompressedReader: unknown codec");
+        blockSize_ = blockSize;
+
+        size_t tableSize = static_cast<size_t>(count) * kCompressIndexEntrySize;
+        size_t payload = size - kCompressFooterSize - tableSize;
+        const char* table = data + payload;
+        blocks_.resize(static_cast<size_t>(count));
+        uint64_t offset = 0, raw = 0;
+        for (size_t i = 0; i < blocks_.size(); ++i) {
+            BlockEntry& b = blocks_[i];
+            std::memcpy(&b.rawSize, table + i * kCompressIndexEntrySize, sizeof(b.rawSize));
+            std::memcpy(&b.storedSize, table + i * kCompressIndexEntrySize + 4, sizeof(b.storedSize));
+            bool last = i + 1 == blocks_.size();
+            if (b.rawSize == 0 || (last ? b.rawSize > blockSize : b.rawSize != blockSize) ||
+                b.storedSize > b.rawSize || b.storedSize > payload - offset) {
+                throw std::runtime_error("CompressedReader: invalid block table");
+            }
+            b.offset = offset;
+            offset += b.storedSize;
+            raw += b.rawSize;
+        }
+        if (offset != payload || raw != rawSize_) throw std::runtime_error("CompressedReader: invalid block table");
+        block_.reset(new char[blockSize_]);
+    }
+
+    void decode(size_t i, char* dst) const {
+        const detail::BlockEntry& b = blocks_[i];
+        const char* src = data_ + b.offset;
+        if (b.storedSize == b.rawSize) {
+            std::memcpy(dst, src, b.rawSize);
+        } else if (!codec_->decompress(src, b.storedSize, dst, b.rawSize)) {
+            throw std::runtime_error("CompressedReader: corrupt block");
+        }
+    }
+
+    void load(size_t i) {
+        loaded_ = SIZE_MAX;
+        decode(i, block_.get());
+        loaded_ = i;
+        current_ = blocks_[i];
+        pos_ = 0;
+        next_ = i + 1;
+    }
+
+    std::unique_ptr<MappedFile> file_;
+    const char* data_ = nullptr;
+    const BlockCodec* codec_ = nullptr;
+    uint64_t rawSize_ = 0;
+    size_t blockSize_ = 0;
+    std::vector<detail::BlockEntry> blocks_;
+    std::unique_ptr<char[]> block_;
+    detail::BlockEntry current_{0, 0, 0};
+    size_t loaded_ = SIZE_MAX;
+    size_t pos_ = 0;
+    size_t next_ = 0;
+};
+
+// ========== 压缩序列化接口 ==========
+// 先编码到内存，再并行按块压缩写出；读取时并行解压全部块后解码。
+// 解码不产生视图：string_view / ArrayView 成员无法指向压缩数据，需用拥有型成员
+template<typename T, typename Stream>
+enable_if_output_t<Stream> serialize_compressed(const T& obj, Stream& os, const BlockCodec& codec = default_codec(),
+                                                size_t blockSize = kDefaultCompressBlock,
+                                                ThreadPool& pool = default_thread_pool()) {
+    BufferWriter raw = serialize_to_buffer(obj);
+    compress_blocks(raw.data(), raw.size(), os, codec, blockSize, pool);
+}
+
+template<typename T>
+void serialize_compressed(const T& obj, const std::string& filename, const BlockCodec& codec = default_codec(),
+                          size_t blockSize = kDefaultCompressBlock, ThreadPool& pool = default_thread_pool()) {
+    BufferWriter buffer;
+    serialize_compressed(obj, buffer, codec, blockSize, pool);
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) throw std::runtime_error("Failed to open file for writing");
+    ofs.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!ofs) throw std::runtime_error("Failed to write file");
+}
+
+template<typename T>
+void deserialize_compressed(T& obj, const char* data, size_t size, ThreadPool& pool = default_thread_pool()) {
+    CompressedReader reader(data, size);
+    size_t rawSize = static_cast<size_t>(reader.raw_size());
+    std::unique_ptr<char[]> raw(new char[rawSize ? rawSize : 1]);
+    reader.decompress_all(raw.get(), pool);
+    CopyingReader in(raw.get(), rawSize);
+    deserialize(obj, in);
+    if (in.remaining() != 0) throw std::runtime_error("deserialize_compressed: size mismatch");
+}
+
+template<typename T>
+void deserialize_compressed(T& obj, const std::string& filename, ThreadPool& pool = default_thread_pool()) {
+    MappedFile file(filename);
+    deserialize_compressed(obj, file.data(), file.size(), pool);
+}
+
+} // namespace BinarySerialization
+
+#endif // BINARY_COMPRESS_H
@@ -0,0 +1,59 @@
+#ifndef BINARY_CRC32C_H
+#define BINARY_CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+namespace BinarySerialization {
+
+// ========== CRC32C ==========
+// Castagnoli 多项式（反射形式 0x82F63B78），与 iSCSI / ext4 / LevelDB 使用的校验和相同。
+// crc 参数为前一段的结果，可以分段计算：crc32c(b, nb, crc32c(a, na)) == crc32c(a + b)
+inline const uint32_t* crc32c_table() {
+    static const struct Table {
+        uint32_t v[256];
+        Table() {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1u)));
+                v[i] = c;
+            }
+        }
+    } table;
+    return table.v;
+}
+
+// 查表实现，每字节一次查表
+inline uint32_t crc32c_scalar(const char* data, size_t n, uint32_t crc = 0) {
+    const uint32_t* table = crc32c_table();
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// 与 crc32c_scalar 结果相同；SSE4.2 下用 crc32 指令每次处理 8 字节
+inline uint32_t crc32c(const char* data, size_t n, uint32_t crc = 0) {
+#if defined(__SSE4_2__)
+    uint64_t c = ~crc;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        c = _mm_crc32_u64(c, word);
+    }
+    uint32_t c32 = static_cast<uint32_t>(c);
+    for (; i < n; ++i) c32 = _mm_crc32_u8(c32, static_cast<uint8_t>(data[i]));
+    return ~c32;
+#else
+    return crc32c_scalar(data, n, crc);
+#endif
+}
+
+} // namespace BinarySerialization
+
+#endif // BINARY_CRC32C_H
@@ -0,0 +1,493 @@
+#ifndef BINARY_DELTA_H
+#define BINARY_DELTA_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "binary_serialization.h"
+#include "binary_async.h"
+#include "binary_record_log.h"
+
+namespace BinarySerialization {
+
+// ========== 增量编码 ==========
+// serialize_delta(base, current, os) 只写出 current 相对 base 的变化，apply_delta(state, is) 把它应用到 state
+// （state 须与编码时的 base 相同），之后 state 与 current 相同。按类型：
+//   - std::map：[删除的键][新增的键值对][值有变化的键 + 值的增量]，值的增量递归编码
+//   - std::set：[删除的元素][新增的元素]
+//   - std::vector：[新长度][变化区间：起点、个数、元素]；尾部新增的元素算作一个区间，缩短时只写新长度
+//   - BINARY_SERIALIZABLE 类型：[变化成员的位掩码（uint64）][各变化成员的增量]，成员增量递归编码
+//   - 其他类型（算术、字符串、list、pair、array、vector<bool> 等）：完整的新值
+// 长度与整数字段随 Archive 的模式（默认 / 紧凑）编码。
+// 比较不依赖 operator==：算术类型按字节比较，BINARY_SERIALIZABLE 类型逐成员比较，
+// 既没有 operator== 也不是 BINARY_SERIALIZABLE 的类型比较两者的编码。
+template<typename T> bool delta_equal(const T& a, const T& b);
+template<typename T1, typename T2> bool delta_equal(const std::pair<T1, T2>& a, const std::pair<T1, T2>& b);
+template<typename T, size_t N> bool delta_equal(const std::array<T, N>& a, const std::array<T, N>& b);
+template<typename T, typename A> bool delta_equal(const std::vector<T, A>& a, const std::vector<T, A>& b);
+template<typename T, typename A> bool delta_equal(const std::list<T, A>& a, const std::list<T, A>& b);
+template<typename T, typename C, typename A> bool delta_equal(const std::set<T, C, A>& a, const std::set<T, C, A>& b);
+template<typename K, typename V, typename C, typename A>
+bool delta_equal(const std::map<K, V, C, A>& a, const std::map<K, V, C, A>& b);
+
+template<typename T, typename Stream>
+enable_if_output_t<Stream> serialize_delta(const T& base, const T& current, Stream& os);
+template<typename T, typename A, typename Stream>
+enable_if_output_t<Stream> serialize_delta(const std::vector<T, A>& base, const std::vector<T, A>& current, Stream& os);
+template<typename T, typename C, typename A, typename Stream>
+enable_if_output_t<Stream> serialize_delta(const std::set<T, C, A>& base, const std::set<T, C, A>& current, Stream& os);
+template<typename K, typename V, typename C, typename A, typename Stream>
+enable_if_output_t<Stream> serialize_delta(const std::map<K, V, C, A>& base, const std::map<K, V, C, A>& current,
+                                           Stream& os);
+
+template<typename T, typename Stream> enable_if_input_t<Stream> apply_delta(T& state, Stream& is);
+template<typename T, typename A, typename Stream> enable_if_input_t<Stream> apply_delta(std::vector<T, A>& state, Stream& is);
+template<typename T, typename C, typename A, typename Stream>
+enable_if_input_t<Stream> apply_delta(std::set<T, C, A>& state, Stream& is);
+template<typename K, typename V, typename C, typename A, typename Stream>
+enable_if_input_t<Stream> apply_delta(std::map<K, V, C, A>& state, Stream& is);
+
+namespace detail {
+
+template<typename T, typename = void>
+struct has_equal : std::false_type {};
+
+template<typename T>
+struct has_equal<T, std::void_t<decltype(bool(std::declval<const T&>() == std::declval<const T&>()))>>
+    : std::true_type {};
+
+template<typename T, size_t... I>
+bool fields_equal(const T& a, const T& b, std::index_sequence<I...>) {
+    auto fa = field_refs(a);
+    auto fb = field_refs(b);
+    return (true && ... && delta_equal(std::get<I>(fa), std::get<I>(fb)));
+}
+
+template<typename T, size_t... I, typename Stream>
+void write_fields_delta(const T& base, const T& current, Stream& os, std::index_sequence<I...>) {
+    static_assert(sizeof...(I) <= 64, "serialize_delta supports at most 64 members");
+    auto fb = field_refs(base);
+    auto fc = field_refs(current);
+    uint64_t mask = 0;
+    ((mask |= delta_equal(std::get<I>(fb), std::get<I>(fc)) ? 0 : uint64_t(1) << I), ...);
+    serialize(mask, os);
+    ((mask >> I & 1 ? serialize_delta(std::get<I>(fb), std::get<I>(fc), os) : void()), ...);
+}
+
+template<typename T, size_t... I, typename Stream>
+void apply_fields_delta(T& state, Stream& is, std::index_sequence<I...>) {
+    uint64_t mask;
+    deserialize(mask, is);
+    if (sizeof...(I) < 64 && mask >> sizeof...(I)) throw std::runtime_error("apply_delta: invalid member mask");
+    auto fs = field_refs(state);
+    ((mask >> I & 1 ? apply_delta(std::get<I>(fs), is) : void()), ...);
+}
+
+template<typename T>
+using field_index_t = std::make_index_sequence<std::tuple_size<field_tuple_t<T>>::value>;
+
+// 两段之间不超过这么多未变元素时合并为一个区间，省去区间头
+constexpr size_t kDeltaMergeGap = 8;
+// 可整段比较的元素先按块 memcmp，整块相同时跳过
+constexpr size_t kDeltaScanBlock = 256;
+
+template<typename T, typename A>
+std::vector<std::pair<size_t, size_t>> changed_ranges(const std::vector<T, A>& base, const std::vector<T, A>& current) {
+    std::vector<std::pair<size_t, size_t>> ranges;
+    auto mark = [&](size_t begin, size_t end) {
+        if (!ranges.empty() && begin - (ranges.back().first + ranges.back().second) <= kDeltaMergeGap) {
+            ranges.back().second = end - ranges.back().first;
+        } else {
+            ranges.emplace_back(begin, end - begin);
+        }
+    };
+    size_t common = base.size() < current.size() ? base.size() : current.size();
+    for (size_t i = 0; i < common;) {
+        if constexpr (is_bulk_vector_element<T>::value) {
+            size_t n = common - i < kDeltaScanBlock ? common - i : kDeltaScanBlock;
+            if (std::memcmp(base.data() + i, current.data() + i, n * sizeof(T)) == 0) {
+                i += n;
+                continue;
+            }
+        }
+        if (delta_equal(base[i], current[i])) {
+            ++i;
+            continue;
+        }
+        size_t begin = i++;
+        while (i < common && !delta_equal(base[i], current[i])) ++i;
+        mark(begin, i);
+    }
+    if (current.size() > common) mark(common, current.size());
+    return ranges;
+}
+
+} // namespace detail
+
+// ---------- delta_equal ----------
+template<typename T>
+bool delta_equal(const T& a, const T& b) {
+    if constexpr (std::is_arithmetic<T>::value) {
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    } else if constexpr (detail::has_binary_fields<const T>::value) {
+        return detail::fields_equal(a, b, detail::field_index_t<const T>{});
+    } else if constexpr (detail::has_equal<T>::value) {
+        return a == b;
+    } else {
+        BufferWriter x, y;
+        serialize(a, x);
+        serialize(b, y);
+        return x.size() == y.size() && std::memcmp(x.data(), y.data(), x.size()) == 0;
+    }
+}
+
+template<typename T1, typename T2>
+bool delta_equal(const std::pair<T1, T2>& a, const std::pair<T1, T2>& b) {
+    return delta_equal(a.first, b.first) && delta_equal(a.second, b.second);
+}
+
+template<typename T, size_t N>
+bool delta_equal(const std::array<T, N>& a, const std::array<T, N>& b) {
+    for (size_t i = 0; i < N; ++i) {
+        if (!delta_equal(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+template<typename T, typename A>
+bool delta_equal(const std::vector<T, A>& a, const std::vector<T, A>& b) {
+    if (a.size() != b.size()) return false;
+    if constexpr (is_bulk_vector_element<T>::value) {
+        return a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+    } else {
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (!delta_equal(static_cast<const T&>(a[i]), static_cast<const T&>(b[i]))) return false;
+        }
+        return true;
+    }
+}
+
+template<typename T, typename A>
+bool delta_equal(const std::list<T, A>& a, const std::list<T, A>& b) {
+    if (a.size() != b.size()) return false;
+    for (auto i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j) {
+        if (!delta_equal(*i, *j)) return false;
+    }
+    return true;
+}
+
+template<typename T, typename C, typename A>
+bool delta_equal(const std::set<T, C, A>& a, const std::set<T, C, A>& b) {
+    if (a.size() != b.size()) return false;
+    for (auto i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j) {
+        if (!delta_equal(*i, *j)) return false;
+    }
+    return true;
+}
+
+template<typename K, typename V, typename C, typename A>
+bool delta_equal(const std::map<K, V, C, A>& a, const std::map<K, V, C, A>& b) {
+    if (a.size() != b.size()) return false;
+    for (auto i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j) {
+        if (!delta_equal(i->first, j->first) || !delta_equal(i->second, j->second)) return false;
+    }
+    return true;
+}
+
+// ---------- serialize_delta / apply_delta ----------
+template<typename T, typename Stream>
+enable_if_output_t<Stream> serialize_delta(const T& base, const T& current, Stream& os) {
+    if constexpr (detail::has_binary_fields<const T>::value) {
+        detail::write_fields_delta(base, current, os, detail::field_index_t<const T>{});
+    } else {
+        serialize(current, os);
+    }
+}
+
+template<typename T, typename Stream>
+enable_if_input_t<Stream> apply_delta(T& state, Stream& is) {
+    if constexpr (detail::has_binary_fields<T>::value) {
+        detail::apply_fields_delta(state, is, detail::field_index_t<T>{});
+    } else {
+        deserialize(state, is);
+    }
+}
+
+template<typename T, typename A, typename Stream>
+enable_if_output_t<Stream> serialize_delta(const std::vector<T, A>& base, const std::vector<T, A>& current, Stream& os) {
+    if constexpr (std::is_same<T, bool>::value) {
+        serialize(current, os);
+    } else {
+        auto ranges = detail::changed_ranges(base, current);
+        write_length(os, current.size());
+        write_length(os, ranges.size());
+        for (const auto& r : ranges) {
+            write_length(os, r.first);
+            write_length(os, r.second);
+            detail::encode_range(current.data() + r.first, r.second, os);
+        }
+    }
+}
+
+template<typename T, typename A, typename Stream>
+enable_if_input_t<Stream> apply_delta(std::vector<T, A>& state, Stream& is) {
+    if constexpr (std::is_same<T, bool>::value) {
+        deserialize(state, is);
+    } else {
+        size_t size = read_length(is);
+        size_t count = read_length(is);
+        state.resize(size);
+        for (size_t i = 0; i < count; ++i) {
+            size_t begin = read_length(is);
+            size_t n = read_length(is);
+            if (begin > size || n > size - begin) throw std::runtime_error("apply_delta: invalid range");
+            detail::decode_range(state.data() + begin, n, is);
+        }
+    }
+}
+
+template<typename T, typename C, typename A, typename Stream>
+enable_if_output_t<Stream> serialize_delta(const std::set<T, C, A>& base, const std::set<T, C, A>& current, Stream& os) {
+    auto less = current.key_comp();
+    std::vector<const T*> erased, inserted;
+    for (auto b = base.begin(), c = current.begin(); b != base.end() || c != current.end();) {
+        if (c == current.end() || (b != base.end() && less(*b, *c))) {
+            erased.push_back(&*b++);
+        } else if (b == base.end() || less(*c, *b)) {
+            inserted.push_back(&*c++);
+        } else {
+            ++b;
+            ++c;
+        }
+    }
+    write_length(os, erased.size());
+    for (const T* item : erased) serialize(*item, os);
+    write_length(os, inserted.size());
+    for (const T* item : inserted) serialize(*item, os);
+}
+
+template<typename T, typename C, typename A, typename Stream>
+enable_if_input_t<Stream> apply_delta(std::set<T, C, A>& state, Stream& is) {
+    size_t erased = read_length(is);
+    for (size_t i = 0; i < erased; ++i) {
+        T item = make_element<T>(state.get_allocator());
+        deserialize(item, is);
+        state.erase(item);
+    }
+    size_t inserted = read_length(is);
+    for (size_t i = 0; i < inserted; ++i) {
+        T item = make_element<T>(state.get_allocator());
+        deserialize(item, is);
+        state.insert(std::move(item));
+    }
+}
+
+template<typename K, typename V, typename C, typename A, typename Stream>
+enable_if_output_t<Stream> serialize_delta(const std::map<K, V, C, A>& base, const std::map<K, V, C, A>& current,
+                                           Stream& os) {
+    auto less = current.key_comp();
+    std::vector<const K*> erased;
+    std::vector<const std::pair<const K, V>*> inserted;
+    std::vector<std::pair<const V*, const std::pair<const K, V>*>> changed;
+    for (auto b = base.begin(), c = current.begin(); b != base.end() || c != current.end();) {
+        if (c == current.end() || (b != base.end() && less(b->first, c->first))) {
+            erased.push_back(&b->first);
+            ++b;
+        } else if (b == base.end() || less(c->first, b->first)) {
+            inserted.push_back(&*c);
+            ++c;
+        } else {
+            if (!delta_equal(b->second, c->second)) changed.emplace_back(&b->second, &*c);
+            ++b;
+            ++c;
+        }
+    }
+    write_length(os, erased.size());
+    for (const K* key : erased) serialize(*key, os);
+    write_length(os, inserted.size());
+    for (const auto* kv : inserted) {
+        serialize(kv->first, os);
+        serialize(kv->second, os);
+    }
+    write_length(os, changed.size());
+    for (const auto& change : changed) {
+        serialize(change.second->first, os);
+        serialize_delta(*change.first, change.second->second, os);
+    }
+}
+
+template<typename K, typename V, typename C, typename A, typename Stream>
+enable_if_input_t<Stream> apply_delta(std::map<K, V, C, A>& state, Stream& is) {
+    size_t erased = read_length(is);
+    for (size_t i = 0; i < erased; ++i) {
+        K key = make_element<K>(state.get_allocator());
+        deserialize(key, is);
+        state.erase(key);
+    }
+    size_t inserted = read_length(is);
+    for (size_t i = 0; i < inserted; ++i) {
+        K key = make_element<K>(state.get_allocator());
+        deserialize(key, is);
+        deserialize(state.try_emplace(std::move(key)).first->second, is);
+    }
+    size_t changed = read_length(is);
+    for (size_t i = 0; i < changed; ++i) {
+        K key = make_element<K>(state.get_allocator());
+        deserialize(key, is);
+        auto it = state.find(key);
+        if (it == state.end()) throw std::runtime_error("apply_delta: missing key");
+        apply_delta(it->second, is);
+    }
+}
+
+// ========== DeltaCheckpointer ==========
+// 周期性检查点：第一次写完整快照，之后每次只追加与上一次检查点的增量，写盘量与变化量成正比。
+//     DeltaCheckpointer<State> checkpoints("state.data");
+//     checkpoints.load(state);          // 启动时：基准快照 + 依次应用增量
+//     ...
+//     checkpoints.checkpoint(state);    // 每隔几秒
+// 文件：
+//     path          基准快照 [代号（uint64）][状态的普通格式编码]，原子写入（临时文件 + fsync + rename）
+//     path.delta    增量记录日志（binary_record_log.h），每条记录为 [代号][增量]，追加后 fsync
+// 增量条数达到 maxDeltas，或增量累计字节数超过基准快照的 maxDeltaRatio 倍时自动压实：
+// 写出新的完整快照（代号加一）并清空增量日志。代号与快照不符的增量在载入时被忽略，
+// 因此压实在写完快照、清空日志之前崩溃也不会把旧增量用到新快照上。
+// 每条增量都相对上一次检查点，载入时遇到日志中间的损坏就停下，只恢复到损坏之前的最后一个检查点，
+// 下一次检查点随即写出完整快照，不把新增量追加在读不到的位置之后。
+// 检查点之间保存上一次的状态作为比较基准（内存占用一份状态），
+// 每次检查点把增量应用到这份副本上，而不是整体复制。
+template<typename T>
+class DeltaCheckpointer {
+public:
+    explicit DeltaCheckpointer(std::string path, size_t maxDeltas = 32, double maxDeltaRatio = 0.5)
+        : path_(std::move(path)), logPath_(path_ + ".delta"), maxDeltas_(maxDeltas), maxDeltaRatio_(maxDeltaRatio) {
+        // 沿用已有快照的代号继续递增，即使没有 load 也不会与日志中的旧增量撞号
+        if (exists(path_)) {
+            MappedFile file(path_);
+            if (file.size() >= sizeof(uint64_t)) std::memcpy(&generation_, file.data(), sizeof(generation_));
+        }
+    }
+
+    // 载入基准快照并应用属于它的全部增量；没有快照文件时返回 false，state 不变
+    bool load(T& state) {
+        if (!exists(path_)) return false;
+        {
+            MappedFile file(path_);
+            BufferReader reader = file.reader();
+            deserialize(generation_, reader);
+            deserialize(state, reader);
+            baseBytes_ = file.size();
+        }
+        deltas_ = 0;
+        deltaBytes_ = 0;
+        bool damaged = false;
+        if (exists(logPath_)) {
+            RecordLogReader log(logPath_);
+            BufferReader payload(nullptr, 0);
+            while (log.next_frame(payload)) {
+                // 跳过了字节说明前面丢了增量，之后的增量都无法正确应用
+                if (log.skipped_bytes() != 0) {
+                    damaged = true;
+                    break;
+                }
+                uint64_t generation;
+                deserialize(generation, payload);
+                if (generation != generation_) continue;
+                size_t length = read_length(payload);
+                size_t begin = payload.position();
+                apply_delta(state, payload);
+                if (payload.position() - begin != length) throw std::runtime_error("DeltaCheckpointer: delta size mismatch");
+                ++deltas_;
+                deltaBytes_ += length;
+            }
+        }
+        last_ = state;
+        hasBase_ = !damaged;
+        log_.reset(new RecordLogWriter(logPath_, 0));
+        return true;
+    }
+
+    void checkpoint(const T& state) {
+        if (!hasBase_ || deltas_ >= maxDeltas_) {
+            compact(state);
+            return;
+        }
+        delta_.clear();
+        serialize_delta(last_, state, delta_);
+        if (deltaBytes_ + delta_.size() > maxDeltaRatio_ * baseBytes_) {
+            compact(state);
+            return;
+        }
+        log_->append(std::make_pair(generation_, std::string_view(delta_.data(), delta_.size())));
+        log_->sync();
+        BufferReader reader(delta_.data(), delta_.size());
+        apply_delta(last_, reader);
+        ++deltas_;
+        deltaBytes_ += delta_.size();
+        lastBytes_ = delta_.size();
+    }
+
+    // 立即写出完整快照并清空增量日志
+    void compact(const T& state) {
+        uint64_t generation = generation_ + 1;
+        BufferWriter base(sizeof(generation) + serialized_size(state));
+        serialize(generation, base);
+        serialize(state, base);
+        detail::write_file_atomically(path_, base.data(), base.size());
+        generation_ = generation;
+        log_.reset();
+        std::remove(logPath_.c_str());
+        log_.reset(new RecordLogWriter(logPath_, 0));
+        last_ = state;
+        hasBase_ = true;
+        baseBytes_ = base.size();
+        deltas_ = 0;
+        deltaBytes_ = 0;
+        lastBytes_ = base.size();
+    }
+
+    // 当前快照之后的增量条数
+    size_t delta_count() const { return deltas_; }
+
+    uint64_t generation() const { return generation_; }
+
+    // 最近一次检查点写出的字节数（增量或完整快照）
+    size_t last_checkpoint_bytes() const { return lastBytes_; }
+
+private:
+    static bool exists(const std::string& filename) {
+        std::FILE* probe = std::fopen(filename.c_str(), "rb");
+        if (!probe) return false;
+        std::fclose(probe);
+        return true;
+    }
+
+    std::string path_;
+    std::string logPath_;
+    size_t maxDeltas_;
+    double maxDeltaRatio_;
+    T last_{};
+    bool hasBase_ = false;
+    uint64_t generation_ = 0;
+    size_t baseBytes_ = 0;
+    size_t deltas_ = 0;
+    size_t deltaBytes_ = 0;
+    size_t lastBytes_ = 0;
+    BufferWriter delta_;
+    std::unique_ptr<RecordLogWriter> log_;
+};
+
+} // namespace BinarySerialization
+
+#endif // BINARY_DELTA_H
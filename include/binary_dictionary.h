@@ -0,0 +1,262 @@
+#ifndef BINARY_DICTIONARY_H
+#define BINARY_DICTIONARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "binary_archive.h"
+#include "binary_varint.h"
+
+namespace BinarySerialization {
+
+// ========== 字典模式 Archive ==========
+// 包装任意 Archive；经由它序列化的 std::string / std::string_view 只在第一次出现时写出内容，
+// 之后写它在本 Archive 字符串表中的编号。其余类型原样交给被包装的 Archive（包括紧凑模式的 varint）：
+//     BufferWriter buffer;
+//     CompactWriter<BufferWriter> compact(buffer);
+//     DictionaryWriter<CompactWriter<BufferWriter>> dict(compact);
+//     serialize(rows, dict);
+// 每个字符串编码为一个 varint 标记：
+//   0     不进字典的字面量，后跟 varint 长度与内容（超过 maxStringLength 的字符串）
+//   1     新字典项，后跟 varint 长度与内容，编号为当前字典大小
+//   k>=2  引用编号为 k-2 的字典项
+// 读端反序列化到 std::string 时从字典拷贝；反序列化到 std::string_view 时直接指向字典项，
+// 同一字符串的所有出现共享一份内容。底层支持 consume（BufferReader、MappedFile::reader()）时字典项指向输入缓冲区，
+// 视图与输入缓冲区同生命周期；否则字典项拷贝到 DictionaryReader 自己的内存中，视图与 DictionaryReader 同生命周期。
+constexpr size_t kDefaultDictionaryStringLength = 256;
+
+namespace detail {
+
+// 只追加的字符串存储；已返回的视图在 StringArena 析构前一直有效
+class StringArena {
+public:
+    char* allocate(size_t n) {
+        constexpr size_t kChunk = 64 * 1024;
+        if (n > kChunk / 4) {
+            chunks_.emplace_back(new char[n]);
+            return chunks_.back().get();
+        }
+        if (n > capacity_ - used_) {
+            chunks_.emplace_back(new char[kChunk]);
+            current_ = chunks_.back().get();
+            capacity_ = kChunk;
+            used_ = 0;
+        }
+        char* p = current_ + used_;
+        used_ += n;
+        return p;
+    }
+
+    std::string_view store(const char* p, size_t n) {
+        char* dst = allocate(n);
+        if (n) std::memcpy(dst, p, n);
+        return std::string_view(dst, n);
+    }
+
+private:
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    char* current_ = nullptr;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+};
+
+} // namespace detail
+
+template<typename Out>
+class DictionaryWriter {
+public:
+    explicit DictionaryWriter(Out& out, size_t maxStringLength = kDefaultDictionaryStringLength)
+        : out_(out), maxStringLength_(maxStringLength) {}
+
+    void write(const char* p, size_t n) { out_.write(p, n); }
+
+    void write_string(const char* p, size_t n) {
+        if (n <= maxStringLength_) {
+            std::string_view s(p, n);
+            size_t h = std::hash<std::string_view>()(s);
+            uint32_t tag = slot_tag(h);
+            size_t mask = slots_.size() - 1;
+            for (size_t i = h & mask;; i = (i + 1) & mask) {
+                Slot& slot = slots_[i];
+                if (slot.tag == 0) break;
+                if (slot.tag == tag && strings_[slot.id] == s) {
+                    write_tag(uint64_t(slot.id) + 2);
+                    return;
+                }
+            }
+            insert(h, arena_.store(p, n));
+            write_tag(1);
+        } else {
+            write_tag(0);
+        }
+        write_tag(n);
+        out_.write(p, n);
+    }
+
+    // 被包装的是紧凑模式 Archive 时，整数与长度前缀照常写 varint
+    template<typename O = Out>
+    auto write_varint(uint64_t v) -> decltype(std::declval<O&>().write_varint(v)) { out_.write_varint(v); }
+
+    template<typename T, typename O = Out>
+    auto write_varints(const T* p, size_t n) -> decltype(std::declval<O&>().write_varints(p, n)) {
+        out_.write_varints(p, n);
+    }
+
+    // 被包装的是可移植模式 Archive 时，算术值照常按固定字节序写出
+    template<typename T, typename O = Out>
+    auto write_values(const T* p, size_t n) -> decltype(std::declval<O&>().write_values(p, n)) {
+        out_.write_values(p, n);
+    }
+
+    template<typename O = Out>
+    auto swaps() const -> decltype(std::declval<const O&>().swaps()) { return out_.swaps(); }
+    template<typename O = Out>
+    auto byte_order() const -> decltype(std::declval<const O&>().byte_order()) { return out_.byte_order(); }
+
+    size_t dictionary_size() const { return strings_.size(); }
+    Out& inner() { return out_; }
+
+private:
+    // 开放寻址表（装载率不超过 1/2）：tag 取哈希的高位并把最低位置 1，0 表示空槽；tag 相同时再比较内容
+    struct Slot {
+        uint32_t tag = 0;
+        uint32_t id = 0;
+    };
+
+    static uint32_t slot_tag(size_t h) { return static_cast<uint32_t>(static_cast<uint64_t>(h) >> 32) | 1; }
+
+    void insert(size_t h, std::string_view s) {
+        if (strings_.size() == UINT32_MAX) throw std::runtime_error("DictionaryWriter: too many strings");
+        strings_.push_back(s);
+        hashes_.push_back(h);
+        if (strings_.size() * 2 > slots_.size()) {
+            slots_.assign(slots_.size() * 2, Slot());
+            for (uint32_t id = 0; id < strings_.size(); ++id) place(hashes_[id], id);
+        } else {
+            place(h, static_cast<uint32_t>(strings_.size() - 1));
+        }
+    }
+
+    void place(size_t h, uint32_t id) {
+        size_t mask = slots_.size() - 1;
+        size_t i = h & mask;
+        while (slots_[i].tag != 0) i = (i + 1) & mask;
+        slots_[i] = {slot_tag(h), id};
+    }
+
+    void write_tag(uint64_t v) {
+        char buf[kMaxVarintBytes];
+        out_.write(buf, encode_varint(v, buf));
+    }
+
+    Out& out_;
+    size_t maxStringLength_;
+    detail::StringArena arena_;
+    std::vector<std::string_view> strings_;
+    std::vector<size_t> hashes_;
+    std::vector<Slot> slots_ = std::vector<Slot>(64);
+};
+
+template<typename In>
+class DictionaryReader {
+public:
+    explicit DictionaryReader(In& in) : in_(in) {}
+
+    void read(char* p, size_t n) { in_.read(p, n); }
+
+    template<typename I = In>
+    auto consume(size_t n) -> decltype(std::declval<I&>().consume(n)) { return in_.consume(n); }
+
+    std::string_view read_string() {
+        uint64_t tag = read_tag();
+        if (tag >= 2) {
+            if (tag - 2 >= table_.size()) throw std::runtime_error("DictionaryReader: invalid string reference");
+            return table_[tag - 2];
+        }
+        size_t n = static_cast<size_t>(read_tag());
+        std::string_view s;
+        if constexpr (is_view_archive<In>::value) {
+            s = std::string_view(in_.consume(n), n);
+        } else {
+            char* p = arena_.allocate(n);
+            in_.read(p, n);
+            s = std::string_view(p, n);
+        }
+        if (tag == 1) table_.push_back(s);
+        return s;
+    }
+
+    template<typename I = In>
+    auto read_varint() -> decltype(std::declval<I&>().read_varint()) { return in_.read_varint(); }
+
+    template<typename T, typename I = In>
+    auto read_varints(T* out, size_t n) -> decltype(std::declval<I&>().read_varints(out, n)) {
+        in_.read_varints(out, n);
+    }
+
+    template<typename T, typename I = In>
+    auto read_values(T* out, size_t n) -> decltype(std::declval<I&>().read_values(out, n)) {
+        in_.read_values(out, n);
+    }
+
+    template<typename I = In>
+    auto swaps() const -> decltype(std::declval<const I&>().swaps()) { return in_.swaps(); }
+    template<typename I = In>
+    auto byte_order() const -> decltype(std::declval<const I&>().byte_order()) { return in_.byte_order(); }
+
+    size_t dictionary_size() const { return table_.size(); }
+    In& inner() { return in_; }
+
+private:
+    uint64_t read_tag() {
+        if constexpr (is_compact_archive<In>::value) {
+            return in_.read_varint();
+        } else {
+            return CompactReader<In>(in_).read_varint();
+        }
+    }
+
+    In& in_;
+    detail::StringArena arena_;
+    std::vector<std::string_view> table_;
+};
+
+template<typename S>
+struct is_dictionary_archive : std::false_type {};
+
+template<typename Out>
+struct is_dictionary_archive<DictionaryWriter<Out>> : std::true_type {};
+
+template<typename In>
+struct is_dictionary_archive<DictionaryReader<In>> : std::true_type {};
+
+// 读端能否把 string_view 指向字典项：底层为 CopyingReader 时读端只在反序列化期间存在，字典随之释放，不借出视图
+template<typename S>
+struct lends_dictionary_views : is_dictionary_archive<S> {};
+
+template<>
+struct lends_dictionary_views<DictionaryReader<CopyingReader>> : std::false_type {};
+
+// 长度前缀与整数的编码跟随被包装的 Archive
+template<typename Out>
+struct is_compact_archive<DictionaryWriter<Out>> : is_compact_archive<Out> {};
+
+template<typename In>
+struct is_compact_archive<DictionaryReader<In>> : is_compact_archive<In> {};
+
+template<typename Out>
+struct is_portable_archive<DictionaryWriter<Out>> : is_portable_archive<Out> {};
+
+template<typename In>
+struct is_portable_archive<DictionaryReader<In>> : is_portable_archive<In> {};
+
+} // namespace BinarySerialization
+
+#endif // BINARY_DICTIONARY_H
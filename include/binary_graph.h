@@ -0,0 +1,312 @@
+#ifndef BINARY_GRAPH_H
+#define BINARY_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "binary_archive.h"
+#include "binary_varint.h"
+#include "binary_dictionary.h"
+#include "binary_portable.h"
+
+namespace BinarySerialization {
+
+// ========== 对象图 Archive ==========
+// std::shared_ptr / std::weak_ptr 需要经由 GraphWriter / GraphReader 序列化：每个被指向的对象只写一次，
+// 之后再遇到同一对象只写编号，读回后共享关系与环都得到恢复：
+//     BufferWriter buffer;
+//     GraphWriter<BufferWriter> graph(buffer);
+//     serialize(roots, graph);
+// 每个指针编码为一个 varint 标记：
+//   0     空指针
+//   1     新对象，编号为当前对象表大小；对象内容随后写出
+//   k>=2  引用编号为 k-2 的对象
+// 对象按指针的静态类型写出（多态类型的动态类型与静态类型不同时抛异常），身份由地址与静态类型共同确定。
+// 为了让很长的指针链（链表、深层树）不受调用栈深度限制，最外层指针的对象立即写出，
+// 写对象内容时遇到的新对象先排队，外层对象写完后按先后顺序逐个写出；读端以相同顺序先建对象、后填内容。
+// 读回的对象由 GraphReader 的对象表持有到 GraphReader 析构，因此只被 weak_ptr 引用的对象在读取期间也有效。
+// GraphWriter / GraphReader 可以包装紧凑、字典、可移植模式的 Archive，但自身须位于最外层。
+namespace detail {
+
+// 每个类型一个唯一地址，用作对象表中的类型标识
+template<typename T>
+const void* graph_type_key() {
+    static const char key = 0;
+    return &key;
+}
+
+} // namespace detail
+
+template<typename Out>
+class GraphWriter {
+public:
+    using BodyWriter = void (*)(const void*, GraphWriter&);
+
+    // expectedObjects：预计的对象数，用于预先分配指针表
+    explicit GraphWriter(Out& out, size_t expectedObjects = 0) : out_(out) {
+        size_t slots = 64;
+        while (slots < expectedObjects * 2) slots *= 2;
+        slots_.resize(slots);
+        shift_ = 64 - log2(slots);
+    }
+
+    void write(const char* p, size_t n) { out_.write(p, n); }
+
+    template<typename O = Out>
+    auto write_varint(uint64_t v) -> decltype(std::declval<O&>().write_varint(v)) { out_.write_varint(v); }
+
+    template<typename T, typename O = Out>
+    auto write_varints(const T* p, size_t n) -> decltype(std::declval<O&>().write_varints(p, n)) {
+        out_.write_varints(p, n);
+    }
+
+    template<typename T, typename O = Out>
+    auto write_values(const T* p, size_t n) -> decltype(std::declval<O&>().write_values(p, n)) {
+        out_.write_values(p, n);
+    }
+
+    template<typename O = Out>
+    auto write_string(const char* p, size_t n) -> decltype(std::declval<O&>().write_string(p, n)) {
+        out_.write_string(p, n);
+    }
+
+    template<typename O = Out>
+    auto swaps() const -> decltype(std::declval<const O&>().swaps()) { return out_.swaps(); }
+    template<typename O = Out>
+    auto byte_order() const -> decltype(std::declval<const O&>().byte_order()) { return out_.byte_order(); }
+
+    // 写出指向 object 的指针标记；第一次遇到该对象时返回 true，调用方随后交给 write_object 写出内容
+    bool write_pointer(const void* object, const void* type) {
+        if (!object) {
+            write_tag(0);
+            return false;
+        }
+        uint32_t typeIndex = type_index(type);
+        uint64_t h = hash(object, typeIndex);
+        size_t mask = slots_.size() - 1;
+        for (size_t i = static_cast<size_t>(h >> shift_);; i = (i + 1) & mask) {
+            Slot& slot = slots_[i];
+            if (!slot.object) break;
+            if (slot.object == object && slot.type == typeIndex) {
+                write_tag(uint64_t(slot.id) + 2);
+                return false;
+            }
+        }
+        insert(object, typeIndex, h);
+        write_tag(1);
+        return true;
+    }
+
+    // 最外层指针的对象立即写出，并写完期间排队的全部对象；嵌套的新对象只排队
+    void write_object(const void* object, BodyWriter body) {
+        if (depth_ > 0) {
+            pending_.push_back({object, body});
+            return;
+        }
+        depth_ = 1;
+        body(object, *this);
+        for (size_t i = 0; i < pending_.size(); ++i) pending_[i].body(pending_[i].object, *this);
+        pending_.clear();
+        depth_ = 0;
+    }
+
+    size_t object_count() const { return count_; }
+    Out& inner() { return out_; }
+
+private:
+    // 开放寻址表（装载率不超过 1/2）：Fibonacci 哈希取高位定位，线性探测；object 为空表示空槽。
+    // 类型以 types_ 中的下标保存，每个槽 16 字节，大图的指针表尽量少占缓存
+    struct Slot {
+        const void* object = nullptr;
+        uint32_t id = 0;
+        uint32_t type = 0;
+    };
+
+    struct Pending {
+        const void* object;
+        BodyWriter body;
+    };
+
+    static unsigned log2(size_t n) {
+        unsigned bits = 0;
+        while ((size_t(1) << bits) < n) ++bits;
+        return bits;
+    }
+
+    static uint64_t hash(const void* object, uint32_t type) {
+        return (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(object)) ^ type) * 0x9E3779B97F4A7C15ull;
+    }
+
+    // 图中的类型通常很少，且连续的指针多为同一类型
+    uint32_t type_index(const void* type) {
+        if (type == lastType_) return lastTypeIndex_;
+        uint32_t i = 0;
+        while (i < types_.size() && types_[i] != type) ++i;
+        if (i == types_.size()) types_.push_back(type);
+        lastType_ = type;
+        lastTypeIndex_ = i;
+        return i;
+    }
+
+    void insert(const void* object, uint32_t type, uint64_t h) {
+        if (count_ == UINT32_MAX) throw std::runtime_error("GraphWriter: too many objects");
+        if ((size_t(count_) + 1) * 2 > slots_.size()) {
+            std::vector<Slot> old(slots_.size() * 2);
+            old.swap(slots_);
+            --shift_;
+            for (const Slot& slot : old) {
+                if (slot.object) place(slot, hash(slot.object, slot.type));
+            }
+        }
+        place({object, count_++, type}, h);
+    }
+
+    void place(const Slot& entry, uint64_t h) {
+        size_t mask = slots_.size() - 1;
+        size_t i = static_cast<size_t>(h >> shift_);
+        while (slots_[i].object) i = (i + 1) & mask;
+        slots_[i] = entry;
+    }
+
+    void write_tag(uint64_t v) {
+        char buf[kMaxVarintBytes];
+        out_.write(buf, encode_varint(v, buf));
+    }
+
+    Out& out_;
+    std::vector<Slot> slots_;
+    unsigned shift_ = 0;
+    uint32_t count_ = 0;
+    std::vector<const void*> types_;
+    const void* lastType_ = nullptr;
+    uint32_t lastTypeIndex_ = 0;
+    std::vector<Pending> pending_;
+    int depth_ = 0;
+};
+
+template<typename In>
+class GraphReader {
+public:
+    using BodyReader = void (*)(void*, GraphReader&);
+
+    explicit GraphReader(In& in) : in_(in) {}
+
+    void read(char* p, size_t n) { in_.read(p, n); }
+
+    template<typename I = In>
+    auto consume(size_t n) -> decltype(std::declval<I&>().consume(n)) { return in_.consume(n); }
+
+    template<typename I = In>
+    auto read_varint() -> decltype(std::declval<I&>().read_varint()) { return in_.read_varint(); }
+
+    template<typename T, typename I = In>
+    auto read_varints(T* out, size_t n) -> decltype(std::declval<I&>().read_varints(out, n)) {
+        in_.read_varints(out, n);
+    }
+
+    template<typename T, typename I = In>
+    auto read_values(T* out, size_t n) -> decltype(std::declval<I&>().read_values(out, n)) {
+        in_.read_values(out, n);
+    }
+
+    template<typename I = In>
+    auto read_string() -> decltype(std::declval<I&>().read_string()) { return in_.read_string(); }
+
+    template<typename I = In>
+    auto swaps() const -> decltype(std::declval<const I&>().swaps()) { return in_.swaps(); }
+    template<typename I = In>
+    auto byte_order() const -> decltype(std::declval<const I&>().byte_order()) { return in_.byte_order(); }
+
+    // 读出指针标记：0 空指针，1 新对象，k>=2 已有对象 k-2
+    uint64_t read_pointer() {
+        if constexpr (is_compact_archive<In>::value) {
+            return in_.read_varint();
+        } else {
+            return CompactReader<In>(in_).read_varint();
+        }
+    }
+
+    template<typename T>
+    std::shared_ptr<T> object(uint64_t id) const {
+        if (id >= objects_.size()) throw std::runtime_error("GraphReader: invalid object reference");
+        if (objects_[id].type != detail::graph_type_key<T>())
+            throw std::runtime_error("GraphReader: object referenced with a different type");
+        return std::static_pointer_cast<T>(objects_[id].object);
+    }
+
+    template<typename T>
+    void add_object(std::shared_ptr<T> object) {
+        objects_.push_back({std::move(object), detail::graph_type_key<T>()});
+    }
+
+    // 与 GraphWriter::write_object 顺序相同：最外层立即读，嵌套的对象排队
+    void read_object(void* object, BodyReader body) {
+        if (depth_ > 0) {
+            pending_.push_back({object, body});
+            return;
+        }
+        depth_ = 1;
+        body(object, *this);
+        for (size_t i = 0; i < pending_.size(); ++i) pending_[i].body(pending_[i].object, *this);
+        pending_.clear();
+        depth_ = 0;
+    }
+
+    size_t object_count() const { return objects_.size(); }
+    In& inner() { return in_; }
+
+private:
+    struct Entry {
+        std::shared_ptr<void> object;
+        const void* type;
+    };
+
+    struct Pending {
+        void* object;
+        BodyReader body;
+    };
+
+    In& in_;
+    std::vector<Entry> objects_;
+    std::vector<Pending> pending_;
+    int depth_ = 0;
+};
+
+template<typename S>
+struct is_graph_archive : std::false_type {};
+
+template<typename Out>
+struct is_graph_archive<GraphWriter<Out>> : std::true_type {};
+
+template<typename In>
+struct is_graph_archive<GraphReader<In>> : std::true_type {};
+
+// 其余编码跟随被包装的 Archive
+template<typename Out>
+struct is_compact_archive<GraphWriter<Out>> : is_compact_archive<Out> {};
+
+template<typename In>
+struct is_compact_archive<GraphReader<In>> : is_compact_archive<In> {};
+
+template<typename Out>
+struct is_dictionary_archive<GraphWriter<Out>> : is_dictionary_archive<Out> {};
+
+template<typename In>
+struct is_dictionary_archive<GraphReader<In>> : is_dictionary_archive<In> {};
+
+template<typename In>
+struct lends_dictionary_views<GraphReader<In>> : lends_dictionary_views<In> {};
+
+template<typename Out>
+struct is_portable_archive<GraphWriter<Out>> : is_portable_archive<Out> {};
+
+template<typename In>
+struct is_portable_archive<GraphReader<In>> : is_portable_archive<In> {};
+
+} // namespace BinarySerialization
+
+#endif // BINARY_GRAPH_H
@@ -0,0 +1,254 @@
+#ifndef BINARY_INDEXED_H
+#define BINARY_INDEXED_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "binary_serialization.h"
+
+namespace BinarySerialization {
+
+// ========== 带索引的容器文件 ==========
+// 可随机访问的 std::vector / std::map 格式，末尾是偏移表：
+//     [条目 0][条目 1]...[条目 N-1][偏移表：N 个 uint64][尾部：N、偏移表位置（uint64），类型、魔数（uint32）]
+// vector 的条目是一个元素；map 的条目是键后紧跟值，按键升序排列，查找时在偏移表上二分。
+// 条目内部使用普通格式。读端从内存映射按偏移只解码访问到的条目，打开文件不随条目数增长。
+// 与普通容器格式不兼容，必须用 IndexedVectorReader / IndexedMapReader 读取。
+namespace detail {
+
+constexpr uint32_t kIndexedMagic = 0x58444942;  // "BIDX"
+constexpr uint32_t kIndexedVector = 1;
+constexpr uint32_t kIndexedMap = 2;
+constexpr size_t kIndexedFooterSize = 2 * sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+// 记录已写出字节数的写端包装，条目偏移相对于索引块起点
+template<typename Stream>
+class CountingWriter {
+public:
+    explicit CountingWriter(Stream& os) : os_(os) {}
+
+    void write(const char* p, size_t n) {
+        os_.write(p, n);
+        size_ += n;
+    }
+
+    size_t size() const { return size_; }
+
+private:
+    Stream& os_;
+    size_t size_ = 0;
+};
+
+template<typename Stream>
+void write_index(CountingWriter<Stream>& out, const std::vector<uint64_t>& offsets, uint32_t kind) {
+    uint64_t table = out.size();
+    uint64_t count = offsets.size();
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(&table), sizeof(table));
+    out.write(reinterpret_cast<const char*>(&kind), sizeof(kind));
+    out.write(reinterpret_cast<const char*>(&kIndexedMagic), sizeof(kIndexedMagic));
+}
+
+// 解析并校验尾部与偏移表，之后按下标取条目的字节区间
+class IndexedBlock {
+public:
+    IndexedBlock(const char* data, size_t size, uint32_t kind) : data_(data) {
+        if (size < kIndexedFooterSize) throw std::runtime_error("Indexed file: missing footer");
+        const char* footer = data + size - kIndexedFooterSize;
+        uint64_t count, table;
+        uint32_t storedKind, magic;
+        std::memcpy(&count, footer, sizeof(count));
+        std::memcpy(&table, footer + 8, sizeof(table));
+        std::memcpy(&storedKind, footer + 16, sizeof(storedKind));
+        std::memcpy(&magic, footer + 20, sizeof(magic));
+        if (magic != kIndexedMagic) throw std::runtime_error("Indexed file: bad magic");
+        if (storedKind != kind) throw std::runtime_error("Indexed file: container kind mismatch");
+        size_t tableBytes = size - kIndexedFooterSize;
+        if (table > tableBytes || count != (tableBytes - table) / sizeof(uint64_t) ||
+            (tableBytes - table) % sizeof(uint64_t) != 0) {
+            throw std::runtime_error("Indexed file: corrupt offset table");
+        }
+        count_ = static_cast<size_t>(count);
+        end_ = static_cast<size_t>(table);
+        table_ = data + table;
+    }
+
+    size_t size() const { return count_; }
+
+    BufferReader entry(size_t i) const {
+        uint64_t begin = offset(i);
+        uint64_t end = i + 1 < count_ ? offset(i + 1) : end_;
+        if (begin > end || end > end_) throw std::runtime_error("Indexed file: corrupt offset table");
+        return BufferReader(data_ + begin, static_cast<size_t>(end - begin));
+    }
+
+private:
+    uint64_t offset(size_t i) const {
+        uint64_t value;
+        std::memcpy(&value, table_ + i * sizeof(uint64_t), sizeof(value));
+        return value;
+    }
+
+    const char* data_;
+    const char* table_ = nullptr;
+    size_t count_ = 0;
+    size_t end_ = 0;
+};
+
+// 二分查找时解码键所用的类型：std::string 键直接比较映射区中的 string_view，不分配内存
+template<typename K>
+struct indexed_probe_key {
+    using type = K;
+};
+
+template<typename A>
+struct indexed_probe_key<std::basic_string<char, std::char_traits<char>, A>> {
+    using type = std::string_view;
+};
+
+} // namespace detail
+
+template<typename T, typename A, typename Stream>
+enable_if_output_t<Stream> serialize_indexed(const std::vector<T, A>& v, Stream& os) {
+    static_assert(!std::is_same<T, bool>::value, "serialize_indexed does not support std::vector<bool>");
+    detail::CountingWriter<Stream> out(os);
+    std::vector<uint64_t> offsets(v.size());
+    for (size_t i = 0; i < v.size(); ++i) {
+        offsets[i] = out.size();
+        serialize(v[i], out);
+    }
+    detail::write_index(out, offsets, detail::kIndexedVector);
+}
+
+// 读端按 operator< 二分，map 必须使用默认比较器
+template<typename K, typename V, typename C, typename A, typename Stream>
+enable_if_output_t<Stream> serialize_indexed(const std::map<K, V, C, A>& m, Stream& os) {
+    static_assert(std::is_same<C, std::less<K>>::value, "serialize_indexed requires std::less ordering");
+    detail::CountingWriter<Stream> out(os);
+    std::vector<uint64_t> offsets;
+    offsets.reserve(m.size());
+    for (const auto& kv : m) {
+        offsets.push_back(out.size());
+        serialize(kv.first, out);
+        serialize(kv.second, out);
+    }
+    detail::write_index(out, offsets, detail::kIndexedMap);
+}
+
+template<typename Container>
+void serialize_indexed(const Container& c, const std::string& filename) {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) throw std::runtime_error("Failed to open file for writing");
+    BufferWriter writer;
+    serialize_indexed(c, writer);
+    ofs.write(writer.data(), writer.size());
+    if (!ofs) throw std::runtime_error("Failed to write file");
+}
+
+// ========== IndexedVectorReader ==========
+// 按下标解码单个元素。从文件名构造时持有内存映射；从 (data, size) 构造时数据由调用方保证存活。
+// T 可以是视图类型（如 std::string_view），此时结果指向映射区，只在读端存活期间有效
+template<typename T>
+class IndexedVectorReader {
+public:
+    explicit IndexedVectorReader(const std::string& filename)
+        : file_(new MappedFile(filename, MappedFile::Random)),
+          block_(file_->data(), file_->size(), detail::kIndexedVector) {}
+
+    IndexedVectorReader(const char* data, size_t size) : block_(data, size, detail::kIndexedVector) {}
+
+    size_t size() const { return block_.size(); }
+
+    void read(size_t i, T& out) const {
+        if (i >= size()) throw std::out_of_range("IndexedVectorReader: index out of range");
+        BufferReader reader = block_.entry(i);
+        deserialize(out, reader);
+        if (reader.remaining() != 0) throw std::runtime_error("IndexedVectorReader: element size mismatch");
+    }
+
+    T at(size_t i) const {
+        T out{};
+        read(i, out);
+        return out;
+    }
+
+private:
+    std::unique_ptr<MappedFile> file_;
+    detail::IndexedBlock block_;
+};
+
+// ========== IndexedMapReader ==========
+// 按键二分查找，每一步只解码一个键；命中后解码对应的值
+template<typename K, typename V>
+class IndexedMapReader {
+public:
+    explicit IndexedMapReader(const std::string& filename)
+        : file_(new MappedFile(filename, MappedFile::Random)),
+          block_(file_->data(), file_->size(), detail::kIndexedMap) {}
+
+    IndexedMapReader(const char* data, size_t size) : block_(data, size, detail::kIndexedMap) {}
+
+    size_t size() const { return block_.size(); }
+
+    // key 可以是任何能与 K（std::string 键时为 std::string_view）用 < 比较的类型
+    template<typename Key>
+    bool find(const Key& key, V& out) const {
+        BufferReader reader(nullptr, 0);
+        if (!locate(key, reader)) return false;
+        deserialize(out, reader);
+        if (reader.remaining() != 0) throw std::runtime_error("IndexedMapReader: entry size mismatch");
+        return true;
+    }
+
+    template<typename Key>
+    bool contains(const Key& key) const {
+        BufferReader reader(nullptr, 0);
+        return locate(key, reader);
+    }
+
+    // 按键的升序遍历第 i 个条目
+    void read(size_t i, K& key, V& value) const {
+        if (i >= size()) throw std::out_of_range("IndexedMapReader: index out of range");
+        BufferReader reader = block_.entry(i);
+        deserialize(key, reader);
+        deserialize(value, reader);
+        if (reader.remaining() != 0) throw std::runtime_error("IndexedMapReader: entry size mismatch");
+    }
+
+private:
+    // 找到时 reader 停在该条目的值上
+    template<typename Key>
+    bool locate(const Key& key, BufferReader& reader) const {
+        size_t lo = 0, hi = size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            BufferReader entry = block_.entry(mid);
+            typename detail::indexed_probe_key<K>::type probe{};
+            deserialize(probe, entry);
+            if (probe < key) {
+                lo = mid + 1;
+            } else if (key < probe) {
+                hi = mid;
+            } else {
+                reader = entry;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::unique_ptr<MappedFile> file_;
+    detail::IndexedBlock block_;
+};
+
+} // namespace BinarySerialization
+
+#endif // BINARY_INDEXED_H
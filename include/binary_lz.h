@@ -0,0 +1,180 @@
+#ifndef BINARY_LZ_H
+#define BINARY_LZ_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace BinarySerialization {
+
+// ========== LZ 块压缩 ==========
+// LZ77 家族的字节序列格式（与 LZ4 块格式同构）：
+//     [token：高 4 位字面量长度，低 4 位匹配长度 - 4][字面量长度扩展][字面量][偏移（uint16 小端）][匹配长度扩展]
+// 长度字段为 15 时后跟扩展字节，每个 255 表示继续。最后一个序列只有字面量。
+// 压缩用 4 字节哈希表贪心匹配，窗口 64 KiB；不匹配时步长随连续失败次数增大，不可压缩的数据很快略过。
+namespace detail {
+
+constexpr int kLzHashBits = 14;
+constexpr size_t kLzMinMatch = 4;
+constexpr size_t kLzMaxOffset = 65535;
+// 末尾这么多字节只作为字面量输出，保证匹配扩展时的 8 字节比较不越界
+constexpr size_t kLzTailLiterals = 12;
+
+inline uint32_t lz_load32(const char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t lz_load64(const char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t lz_hash(uint32_t v) { return (v * 2654435761u) >> (32 - kLzHashBits); }
+
+// 写长度扩展字节；空间不足返回 false
+inline bool lz_put_length(char*& op, const char* oend, size_t len) {
+    for (; len >= 255; len -= 255) {
+        if (op == oend) return false;
+        *op++ = static_cast<char>(255);
+    }
+    if (op == oend) return false;
+    *op++ = static_cast<char>(len);
+    return true;
+}
+
+inline bool lz_get_length(const char*& ip, const char* iend, size_t& len) {
+    uint8_t b;
+    do {
+        if (ip == iend) return false;
+        b = static_cast<uint8_t>(*ip++);
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+inline bool lz_put_sequence(char*& op, const char* oend, const char* literals, size_t litLen, size_t offset,
+                            size_t matchLen) {
+    if (op == oend) return false;
+    char* token = op++;
+    uint8_t t = static_cast<uint8_t>((litLen < 15 ? litLen : 15) << 4);
+    if (litLen >= 15 && !lz_put_length(op, oend, litLen - 15)) return false;
+    if (litLen > static_cast<size_t>(oend - op)) return false;
+    std::memcpy(op, literals, litLen);
+    op += litLen;
+    if (matchLen) {
+        if (oend - op < 2) return false;
+        op[0] = static_cast<char>(offset & 0xFF);
+        op[1] = static_cast<char>(offset >> 8);
+        op += 2;
+        size_t m = matchLen - kLzMinMatch;
+        t |= static_cast<uint8_t>(m < 15 ? m : 15);
+        if (m >= 15 && !lz_put_length(op, oend, m - 15)) return false;
+    }
+    *token = static_cast<char>(t);
+    return true;
+}
+
+} // namespace detail
+
+// 最坏情况（完全不可压缩）下的输出大小
+inline size_t lz_compress_bound(size_t n) { return n + n / 255 + 16; }
+
+// 返回压缩后的字节数；capacity 不够时返回 0
+inline size_t lz_compress(const char* src, size_t n, char* dst, size_t capacity) {
+    using namespace detail;
+    uint32_t table[1 << kLzHashBits] = {};
+    const char* ip = src;
+    const char* anchor = src;
+    const char* end = src + n;
+    char* op = dst;
+    const char* oend = dst + capacity;
+    if (n > kLzTailLiterals) {
+        const char* limit = end - kLzTailLiterals;
+        size_t misses = 0;
+        while (ip < limit) {
+            uint32_t seq = lz_load32(ip);
+            uint32_t h = lz_hash(seq);
+            const char* ref = src + table[h];
+            table[h] = static_cast<uint32_t>(ip - src);
+            if (ref >= ip || static_cast<size_t>(ip - ref) > kLzMaxOffset || lz_load32(ref) != seq) {
+                ip += 1 + (misses++ >> 5);
+                continue;
+            }
+            misses = 0;
+            size_t len = kLzMinMatch;
+            while (ip + len + 8 <= limit && lz_load64(ip + len) == lz_load64(ref + len)) len += 8;
+            while (ip + len < limit && ip[len] == ref[len]) ++len;
+            if (!lz_put_sequence(op, oend, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - ref), len)) {
+                return 0;
+            }
+            ip += len;
+            anchor = ip;
+            if (ip - 2 > src) table[lz_hash(lz_load32(ip - 2))] = static_cast<uint32_t>(ip - 2 - src);
+        }
+    }
+    if (!lz_put_sequence(op, oend, anchor, static_cast<size_t>(end - anchor), 0, 0)) return 0;
+    return static_cast<size_t>(op - dst);
+}
+
+// 解压到恰好 rawSize 字节；输入损坏（越界、偏移非法、长度不符）时返回 false
+inline bool lz_decompress(const char* src, size_t n, char* dst, size_t rawSize) {
+    using namespace detail;
+    const char* ip = src;
+    const char* iend = src + n;
+    char* op = dst;
+    char* oend = dst + rawSize;
+    while (true) {
+        if (ip == iend) return false;
+        uint8_t token = static_cast<uint8_t>(*ip++);
+        size_t litLen = token >> 4;
+        // 快速路径：字面量不超过 14 字节、匹配不超过 16 字节且两端余量充足时，固定拷贝 16 字节（多写的部分随后被覆盖）
+        bool shortSequence = litLen < 15 && (token & 15) <= 12 && iend - ip >= 32 && oend - op >= 32;
+        if (shortSequence) {
+            std::memcpy(op, ip, 16);
+            ip += litLen;
+            op += litLen;
+        } else {
+            if (litLen == 15 && !lz_get_length(ip, iend, litLen)) return false;
+            if (litLen > static_cast<size_t>(iend - ip) || litLen > static_cast<size_t>(oend - op)) return false;
+            std::memcpy(op, ip, litLen);
+            ip += litLen;
+            op += litLen;
+            if (ip == iend) return op == oend;
+            if (iend - ip < 2) return false;
+        }
+
+        size_t offset = static_cast<uint8_t>(ip[0]) | static_cast<size_t>(static_cast<uint8_t>(ip[1])) << 8;
+        ip += 2;
+        size_t matchLen = token & 15;
+        if (shortSequence && offset >= 16 && offset <= static_cast<size_t>(op - dst)) {
+            std::memcpy(op, op - offset, 16);
+            op += matchLen + kLzMinMatch;
+            continue;
+        }
+        if (matchLen == 15 && !lz_get_length(ip, iend, matchLen)) return false;
+        matchLen += kLzMinMatch;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst) || matchLen > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+        const char* match = op - offset;
+        if (offset >= matchLen) {
+            std::memcpy(op, match, matchLen);
+        } else if (offset >= 8) {
+            // 重叠但间距不小于 8：按 8 字节分段拷贝，每段的源都已写好
+            for (size_t i = 0; i < matchLen; i += 8) {
+                size_t chunk = matchLen - i < 8 ? matchLen - i : 8;
+                std::memcpy(op + i, match + i, chunk);
+            }
+        } else {
+            for (size_t i = 0; i < matchLen; ++i) op[i] = match[i];
+        }
+        op += matchLen;
+    }
+}
+
+} // namespace BinarySerialization
+
+#endif // BINARY_LZ_H
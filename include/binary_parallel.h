@@ -0,0 +1,262 @@
+#ifndef BINARY_PARALLEL_H
+#define BINARY_PARALLEL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "binary_serialization.h"
+
+namespace BinarySerialization {
+
+// ========== ThreadPool ==========
+// 固定数量的工作线程；parallel_for 把 [0, n) 的任务下标放进一个原子计数器，
+// 调用线程和所有工作线程各自抢下一个下标执行，先做完的线程自然多拿，适合长短不一的分块任务。
+// 同一时刻只执行一个 parallel_for，多个调用方会依次排队。
+class ThreadPool {
+public:
+    // threads 为参与计算的线程总数（含调用线程），0 表示使用硬件并发数
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 1;
+        for (size_t i = 1; i < threads; ++i) workers_.emplace_back([this] { work(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size() + 1; }
+
+    // 并行执行 fn(i)，i ∈ [0, n)，全部完成后返回。
+    // 任一任务抛出异常时，尚未开始的任务不再执行，第一个异常在返回前重新抛出
+    template<typename F>
+    void parallel_for(size_t n, F&& fn) {
+        if (n == 0) return;
+        if (workers_.empty() || n == 1) {
+            for (size_t i = 0; i < n; ++i) fn(i);
+            return;
+        }
+        std::lock_guard<std::mutex> serial(callMutex_);
+        Job job;
+        job.fn = [&fn](size_t i) { fn(i); };
+        job.n = n;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &job;
+            ++generation_;
+        }
+        wake_.notify_all();
+        run(job);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&] { return job.active == 0; });
+        job_ = nullptr;
+        lock.unlock();
+        if (job.error) std::rethrow_exception(job.error);
+    }
+
+private:
+    struct Job {
+        std::function<void(size_t)> fn;
+        size_t n = 0;
+        std::atomic<size_t> next{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        size_t active = 0;
+    };
+
+    void run(Job& job) {
+        while (!job.failed.load(std::memory_order_relaxed)) {
+            size_t i = job.next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= job.n) break;
+            try {
+                job.fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!job.error) job.error = std::current_exception();
+                job.failed = true;
+            }
+        }
+    }
+
+    void work() {
+        size_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            Job* job = job_;
+            if (!job) continue;
+            ++job->active;
+            lock.unlock();
+            run(*job);
+            lock.lock();
+            if (--job->active == 0) done_.notify_all();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex callMutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    Job* job_ = nullptr;
+    size_t generation_ = 0;
+    bool stop_ = false;
+};
+
+// 进程内共享的线程池，线程数等于硬件并发数
+inline ThreadPool& default_thread_pool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+// ========== 分块容器编码 ==========
+// std::vector 的另一种线上格式，每块可以独立编码/解码：
+//     [元素个数 N][每块元素数 K][每块字节数 × ceil(N/K)][各块数据依次拼接]
+// 块内元素的编码与普通格式相同；长度字段随 Archive 的模式（默认 / 紧凑 / 可移植）编码。
+// 与普通 std::vector 格式不兼容，必须用 deserialize_chunked 读取。
+namespace detail {
+
+// 块内使用与外层相同模式的内存 Archive（可移植模式不带格式头，沿用外层的字节序）；
+// 默认模式下先求出块的编码大小，一次分配
+template<typename Stream, typename T>
+void encode_chunk(const T* first, size_t count, BufferWriter& out, ByteOrder order) {
+    if constexpr (is_compact_archive<Stream>::value) {
+        CompactWriter<BufferWriter> writer(out);
+        encode_range(first, count, writer);
+    } else if constexpr (is_portable_archive<Stream>::value) {
+        PortableWriter<BufferWriter> writer(out, order, PortableNoHeader{});
+        encode_range(first, count, writer);
+    } else {
+        size_t bytes = 0;
+        for (size_t i = 0; i < count; ++i) bytes += serialized_size(first[i]);
+        out.reserve(bytes);
+        encode_range(first, count, out);
+    }
+}
+
+// 块内读端见 segment_reader_t：只有外层支持 consume 时才允许视图类型的元素
+template<typename Stream, typename T>
+void decode_chunk(T* first, size_t count, const char* data, size_t size, ByteOrder order) {
+    using Reader = segment_reader_t<Stream>;
+    Reader reader(data, size);
+    if constexpr (is_compact_archive<Stream>::value) {
+        CompactReader<Reader> compact(reader);
+        decode_range(first, count, compact);
+    } else if constexpr (is_portable_archive<Stream>::value) {
+        PortableReader<Reader> portable(reader, order, PortableNoHeader{});
+        decode_range(first, count, portable);
+    } else {
+        decode_range(first, count, reader);
+    }
+    if (reader.remaining() != 0) throw std::runtime_error("deserialize_chunked: chunk size mismatch");
+}
+
+// 未指定块大小时，让块数约为线程数的 4 倍，且每块不少于 256 个元素
+inline size_t default_chunk_elements(size_t n, size_t threads) {
+    size_t target = threads * 4;
+    size_t k = (n + target - 1) / target;
+    return k < 256 ? 256 : k;
+}
+
+} // namespace detail
+
+template<typename T, typename A, typename Stream>
+enable_if_output_t<Stream> serialize_chunked(const std::vector<T, A>& v, Stream& os, ThreadPool& pool,
+                                             size_t elementsPerChunk = 0) {
+    static_assert(!std::is_same<T, bool>::value, "serialize_chunked does not support std::vector<bool>");
+    size_t n = v.size();
+    size_t k = n == 0 ? 0 : (elementsPerChunk ? elementsPerChunk : detail::default_chunk_elements(n, pool.size()));
+    size_t chunks = n == 0 ? 0 : (n + k - 1) / k;
+    std::vector<BufferWriter> encoded(chunks);
+    ByteOrder order = byte_order_of(os);
+    pool.parallel_for(chunks, [&](size_t c) {
+        size_t begin = c * k;
+        size_t end = begin + k < n ? begin + k : n;
+        detail::encode_chunk<Stream>(v.data() + begin, end - begin, encoded[c], order);
+    });
+    write_length(os, n);
+    write_length(os, k);
+    for (const auto& chunk : encoded) write_length(os, chunk.size());
+    for (const auto& chunk : encoded) os.write(chunk.data(), chunk.size());
+}
+
+// 先按 N 调整输出大小（与普通格式一样复用已有元素），再并行把各块解码到各自的下标区间。
+// 读端支持 consume（BufferReader / MappedFile）时直接在底层数据上解码，元素可以是指向它的视图；
+// 否则先把所有块读入内存（CopyingReader 直接在其数据上解码），元素不能是视图类型
+template<typename T, typename A, typename Stream>
+enable_if_input_t<Stream> deserialize_chunked(std::vector<T, A>& v, Stream& is, ThreadPool& pool) {
+    static_assert(!std::is_same<T, bool>::value, "deserialize_chunked does not support std::vector<bool>");
+    size_t n = read_length(is);
+    size_t k = read_length(is);
+    if (n > 0 && k == 0) throw std::runtime_error("deserialize_chunked: invalid chunk size");
+    size_t chunks = n == 0 ? 0 : (n - 1) / k + 1;
+    std::vector<size_t> offsets(chunks + 1, 0);
+    for (size_t c = 0; c < chunks; ++c) {
+        size_t size = read_length(is);
+        if (size > SIZE_MAX - offsets[c]) throw std::runtime_error("deserialize_chunked: invalid chunk size");
+        offsets[c + 1] = offsets[c] + size;
+    }
+    size_t total = offsets[chunks];
+
+    std::unique_ptr<char[]> owned;
+    const char* base = detail::take_segments(is, total, owned);
+
+    v.resize(n);
+    ByteOrder order = byte_order_of(is);
+    pool.parallel_for(chunks, [&](size_t c) {
+        size_t begin = c * k;
+        size_t end = begin + k < n ? begin + k : n;
+        detail::decode_chunk<Stream>(v.data() + begin, end - begin, base + offsets[c], offsets[c + 1] - offsets[c],
+                                     order);
+    });
+}
+
+template<typename T, typename A, typename Stream>
+enable_if_output_t<Stream> serialize_chunked(const std::vector<T, A>& v, Stream& os) {
+    serialize_chunked(v, os, default_thread_pool());
+}
+
+template<typename T, typename A, typename Stream>
+enable_if_input_t<Stream> deserialize_chunked(std::vector<T, A>& v, Stream& is) {
+    deserialize_chunked(v, is, default_thread_pool());
+}
+
+// 文件接口：各块编码完成后依次写入文件；读取时从内存映射并行解码，映射在返回时释放，元素不能是视图类型
+template<typename T, typename A>
+void serialize_chunked(const std::vector<T, A>& v, const std::string& filename, ThreadPool& pool = default_thread_pool(),
+                       size_t elementsPerChunk = 0) {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) throw std::runtime_error("Failed to open file for writing");
+    serialize_chunked(v, ofs, pool, elementsPerChunk);
+    if (!ofs) throw std::runtime_error("Failed to write file");
+}
+
+template<typename T, typename A>
+void deserialize_chunked(std::vector<T, A>& v, const std::string& filename, ThreadPool& pool = default_thread_pool()) {
+    MappedFile file(filename);
+    CopyingReader reader(file.data(), file.size());
+    deserialize_chunked(v, reader, pool);
+}
+
+} // namespace BinarySerialization
+
+#endif // BINARY_PARALLEL_H
@@ -0,0 +1,315 @@
+#ifndef BINARY_PORTABLE_H
+#define BINARY_PORTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "binary_archive.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+namespace BinarySerialization {
+
+// ========== 可移植模式 Archive ==========
+// 默认模式写原生内存表示（字节序、long / size_t 宽度随平台而变），快照只能在同类机器之间交换。
+// PortableWriter / PortableReader 包装任意 Archive，线上格式固定为：
+//   - 开头 8 字节格式头："BSPF"、版本、字节序（0 小端 / 1 大端）、2 字节保留
+//   - 算术类型按各自宽度、以格式头记录的字节序写出；long / unsigned long 固定 8 字节
+//     （在 32 位平台读入时检查范围），长度前缀固定为 8 字节无符号整数
+//   - long double 与 wchar_t 在各平台上的表示不同，不能在可移植模式中使用
+// 默认写小端；在小端 64 位主机（x86-64、AArch64 Linux/macOS）上与默认模式逐字节相同（仅多出格式头），
+// 批量数组仍整段拷贝。需要转换时，算术数组经由 byteswap_copy 按块转换（AVX2 / SSSE3 / NEON，否则逐元素）。
+// 读端按格式头中的字节序转换，因此也能读回以 ByteOrder::Big 写出的数据：
+//     PortableWriter<BufferWriter> out(buffer);                  // 小端
+//     PortableWriter<BufferWriter> big(buffer, ByteOrder::Big);  // 大端（在小端主机上走转换路径）
+// 分块（serialize_chunked）与列式（serialize_columnar）写在可移植 Archive 上时，各块 / 各列按同一字节序编码，
+// 只有外层带格式头；索引、记录日志等容器格式自身的头部仍是原生格式，可移植模式只作用于 serialize / deserialize 的编码。
+enum class ByteOrder : uint8_t { Little = 0, Big = 1 };
+
+constexpr ByteOrder kHostByteOrder = BINARY_SERIALIZATION_LITTLE_ENDIAN ? ByteOrder::Little : ByteOrder::Big;
+
+constexpr char kPortableMagic[4] = {'B', 'S', 'P', 'F'};
+constexpr uint8_t kPortableVersion = 1;
+constexpr size_t kPortableHeaderSize = 8;
+
+// 线上宽度：long / unsigned long 在 LP64 与 LLP64 / 32 位平台上宽度不同，统一写 8 字节
+template<typename T>
+struct portable_width : std::integral_constant<size_t, sizeof(T)> {};
+
+template<>
+struct portable_width<long> : std::integral_constant<size_t, 8> {};
+
+template<>
+struct portable_width<unsigned long> : std::integral_constant<size_t, 8> {};
+
+template<typename T>
+struct is_portable_type
+    : std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, long double>::value &&
+                                   !std::is_same<T, wchar_t>::value> {};
+
+namespace detail {
+
+inline uint16_t byteswap16(uint16_t v) {
+#if defined(_MSC_VER)
+    return _byteswap_ushort(v);
+#else
+    return __builtin_bswap16(v);
+#endif
+}
+
+inline uint32_t byteswap32(uint32_t v) {
+#if defined(_MSC_VER)
+    return _byteswap_ulong(v);
+#else
+    return __builtin_bswap32(v);
+#endif
+}
+
+inline uint64_t byteswap64(uint64_t v) {
+#if defined(_MSC_VER)
+    return _byteswap_uint64(v);
+#else
+    return __builtin_bswap64(v);
+#endif
+}
+
+// count 个宽度为 width（1/2/4/8）的元素逐个反转字节序；dst 与 src 可以相同
+inline void byteswap_copy_scalar(char* dst, const char* src, size_t count, size_t width) {
+    switch (width) {
+    case 2:
+        for (size_t i = 0; i < count; ++i) {
+            uint16_t v;
+            std::memcpy(&v, src + i * 2, 2);
+            v = byteswap16(v);
+            std::memcpy(dst + i * 2, &v, 2);
+        }
+        break;
+    case 4:
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t v;
+            std::memcpy(&v, src + i * 4, 4);
+            v = byteswap32(v);
+            std::memcpy(dst + i * 4, &v, 4);
+        }
+        break;
+    case 8:
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t v;
+            std::memcpy(&v, src + i * 8, 8);
+            v = byteswap64(v);
+            std::memcpy(dst + i * 8, &v, 8);
+        }
+        break;
+    default:
+        if (dst != src) std::memmove(dst, src, count * width);
+        break;
+    }
+}
+
+// 与 byteswap_copy_scalar 语义相同；向量路径每次处理 32（AVX2）或 16（SSSE3 / NEON）字节，
+// 用 pshufb / vrev 在每个元素内部反转字节，尾部交给标量循环
+inline void byteswap_copy(char* dst, const char* src, size_t count, size_t width) {
+    if (width < 2) {
+        byteswap_copy_scalar(dst, src, count, width);
+        return;
+    }
+    size_t bytes = count * width;
+    size_t i = 0;
+#if defined(__AVX2__) || defined(__SSSE3__)
+    alignas(16) char order[16];
+    for (size_t k = 0; k < 16; ++k) order[k] = static_cast<char>(k / width * width + (width - 1 - k % width));
+    __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(order));
+#if defined(__AVX2__)
+    __m256i mask2 = _mm256_broadcastsi128_si256(mask);
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(v, mask2));
+    }
+#endif
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, mask));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= bytes; i += 16) {
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+        v = width == 2 ? vrev16q_u8(v) : width == 4 ? vrev32q_u8(v) : vrev64q_u8(v);
+        vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), v);
+    }
+#endif
+    byteswap_copy_scalar(dst + i, src + i, (bytes - i) / width, width);
+}
+
+constexpr size_t kPortableChunkBytes = 16 * 1024;
+
+template<typename T>
+using portable_wide_t = typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::type;
+
+} // namespace detail
+
+// 构造标签：不写 / 不读格式头，按给定字节序编码。用于外层可移植 Archive 内部另开的子缓冲区（块、列）
+struct PortableNoHeader {};
+
+template<typename Out>
+class PortableWriter {
+public:
+    explicit PortableWriter(Out& out, ByteOrder order = ByteOrder::Little)
+        : out_(out), order_(order), swap_(order != kHostByteOrder) {
+        char header[kPortableHeaderSize] = {kPortableMagic[0], kPortableMagic[1], kPortableMagic[2], kPortableMagic[3],
+                                            static_cast<char>(kPortableVersion), static_cast<char>(order), 0, 0};
+        out_.write(header, sizeof(header));
+    }
+
+    PortableWriter(Out& out, ByteOrder order, PortableNoHeader)
+        : out_(out), order_(order), swap_(order != kHostByteOrder) {}
+
+    void write(const char* p, size_t n) { out_.write(p, n); }
+
+    template<typename T>
+    void write_values(const T* p, size_t n) {
+        static_assert(is_portable_type<T>::value, "type has no portable representation");
+        constexpr size_t width = portable_width<T>::value;
+        if constexpr (width == sizeof(T)) {
+            if (!swap_) {
+                out_.write(reinterpret_cast<const char*>(p), n * sizeof(T));
+                return;
+            }
+        }
+        char buf[detail::kPortableChunkBytes];
+        constexpr size_t perChunk = sizeof(buf) / width;
+        while (n > 0) {
+            size_t count = n < perChunk ? n : perChunk;
+            if constexpr (width == sizeof(T)) {
+                detail::byteswap_copy(buf, reinterpret_cast<const char*>(p), count, width);
+            } else {
+                for (size_t i = 0; i < count; ++i) {
+                    detail::portable_wide_t<T> wide = p[i];
+                    std::memcpy(buf + i * width, &wide, width);
+                }
+                if (swap_) detail::byteswap_copy(buf, buf, count, width);
+            }
+            out_.write(buf, count * width);
+            p += count;
+            n -= count;
+        }
+    }
+
+    bool swaps() const { return swap_; }
+    ByteOrder byte_order() const { return order_; }
+    Out& inner() { return out_; }
+
+private:
+    Out& out_;
+    ByteOrder order_;
+    bool swap_;
+};
+
+template<typename In>
+class PortableReader {
+public:
+    explicit PortableReader(In& in) : in_(in) {
+        char header[kPortableHeaderSize];
+        in_.read(header, sizeof(header));
+        if (std::memcmp(header, kPortableMagic, sizeof(kPortableMagic)) != 0)
+            throw std::runtime_error("PortableReader: not a portable archive");
+        if (static_cast<uint8_t>(header[4]) != kPortableVersion)
+            throw std::runtime_error("PortableReader: unsupported format version");
+        if (static_cast<uint8_t>(header[5]) > static_cast<uint8_t>(ByteOrder::Big))
+            throw std::runtime_error("PortableReader: invalid byte order");
+        order_ = static_cast<ByteOrder>(header[5]);
+        swap_ = order_ != kHostByteOrder;
+    }
+
+    PortableReader(In& in, ByteOrder order, PortableNoHeader)
+        : in_(in), order_(order), swap_(order != kHostByteOrder) {}
+
+    void read(char* p, size_t n) { in_.read(p, n); }
+
+    template<typename I = In>
+    auto consume(size_t n) -> decltype(std::declval<I&>().consume(n)) { return in_.consume(n); }
+
+    template<typename T>
+    void read_values(T* p, size_t n) {
+        static_assert(is_portable_type<T>::value, "type has no portable representation");
+        constexpr size_t width = portable_width<T>::value;
+        if constexpr (width == sizeof(T)) {
+            // 底层支持 consume 时直接从输入缓冲区转换到目标，少一次拷贝
+            if constexpr (is_view_archive<In>::value) {
+                const char* src = in_.consume(n * sizeof(T));
+                if (swap_) {
+                    detail::byteswap_copy(reinterpret_cast<char*>(p), src, n, width);
+                } else if (n) {
+                    std::memcpy(p, src, n * sizeof(T));
+                }
+            } else {
+                in_.read(reinterpret_cast<char*>(p), n * sizeof(T));
+                if (swap_) detail::byteswap_copy(reinterpret_cast<char*>(p), reinterpret_cast<char*>(p), n, width);
+            }
+        } else {
+            char buf[detail::kPortableChunkBytes];
+            constexpr size_t perChunk = sizeof(buf) / width;
+            while (n > 0) {
+                size_t count = n < perChunk ? n : perChunk;
+                in_.read(buf, count * width);
+                if (swap_) detail::byteswap_copy(buf, buf, count, width);
+                for (size_t i = 0; i < count; ++i) {
+                    detail::portable_wide_t<T> wide;
+                    std::memcpy(&wide, buf + i * width, width);
+                    if (wide < static_cast<detail::portable_wide_t<T>>(std::numeric_limits<T>::min()) ||
+                        wide > static_cast<detail::portable_wide_t<T>>(std::numeric_limits<T>::max()))
+                        throw std::runtime_error("PortableReader: value out of range for this platform");
+                    p[i] = static_cast<T>(wide);
+                }
+                p += count;
+                n -= count;
+            }
+        }
+    }
+
+    // 需要转换字节序时为 true；此时不能把输入缓冲区直接当作算术数组的视图（ArrayView）
+    bool swaps() const { return swap_; }
+    ByteOrder byte_order() const { return order_; }
+    In& inner() { return in_; }
+
+private:
+    In& in_;
+    ByteOrder order_;
+    bool swap_;
+};
+
+template<typename S>
+struct is_portable_archive : std::false_type {};
+
+template<typename Out>
+struct is_portable_archive<PortableWriter<Out>> : std::true_type {};
+
+template<typename In>
+struct is_portable_archive<PortableReader<In>> : std::true_type {};
+
+// Archive 编码使用的字节序；非可移植模式为主机字节序
+template<typename Stream>
+ByteOrder byte_order_of(const Stream& s) {
+    if constexpr (is_portable_archive<Stream>::value) {
+        return s.byte_order();
+    } else {
+        return kHostByteOrder;
+    }
+}
+
+} // namespace BinarySerialization
+
+#endif // BINARY_PORTABLE_H
@@ -0,0 +1,211 @@
+#ifndef BINARY_RECORD_LOG_H
+#define BINARY_RECORD_LOG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "binary_serialization.h"
+#include "binary_crc32c.h"
+
+#if defined(_WIN32)
+#include <filesystem>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace BinarySerialization {
+
+// ========== 追加式记录日志 ==========
+// 一个文件里依次追加任意多条记录，每条记录一帧：
+//     [载荷长度（uint32）][CRC32C（uint32，覆盖长度字段与载荷）][载荷：记录的普通格式编码]
+// 没有文件头，多次打开追加得到的文件与一次写完的相同。
+// 崩溃可能留下写了一半的尾帧；读端校验每一帧，遇到损坏时逐字节向后寻找下一个合法帧，
+// 写端打开已有文件时只截掉最后一个合法帧之后的内容（写了一半的尾帧），中间的损坏留给读端跳过，再接着追加。
+namespace detail {
+
+constexpr size_t kFrameHeaderSize = 2 * sizeof(uint32_t);
+
+inline uint32_t frame_crc(uint32_t length, const char* payload) {
+    uint32_t crc = crc32c(reinterpret_cast<const char*>(&length), sizeof(length));
+    return crc32c(payload, length, crc);
+}
+
+// 在 [data, data + size) 的 pos 处是否有一个完整且校验通过的帧；是则返回载荷长度
+inline bool valid_frame_at(const char* data, size_t size, size_t pos, uint32_t& length) {
+    if (size - pos < kFrameHeaderSize) return false;
+    uint32_t crc;
+    std::memcpy(&length, data + pos, sizeof(length));
+    std::memcpy(&crc, data + pos + sizeof(length), sizeof(crc));
+    if (length > size - pos - kFrameHeaderSize) return false;
+    return frame_crc(length, data + pos + kFrameHeaderSize) == crc;
+}
+
+} // namespace detail
+
+// ========== RecordLogReader ==========
+// 顺序读取记录：
+//     RecordLogReader log("events.log");
+//     Event e;
+//     while (log.next(e)) handle(e);
+//     if (log.skipped_bytes()) ...  // 跳过了损坏或截断的数据
+// 帧校验通过但载荷不能解码为 T 时抛异常（类型不符，而不是数据损坏）。
+// T 可以含视图类型成员，视图指向映射区，只在读端存活期间有效
+class RecordLogReader {
+public:
+    explicit RecordLogReader(const std::string& filename)
+        : file_(new MappedFile(filename)), data_(file_->data()), size_(file_->size()) {}
+
+    RecordLogReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    // 取下一帧的载荷；文件结束时返回 false
+    bool next_frame(BufferReader& payload) {
+        while (pos_ < size_) {
+            uint32_t length;
+            if (detail::valid_frame_at(data_, size_, pos_, length)) {
+                payload = BufferReader(data_ + pos_ + detail::kFrameHeaderSize, length);
+                pos_ += detail::kFrameHeaderSize + length;
+                validEnd_ = pos_;
+                ++records_;
+                return true;
+            }
+            ++pos_;
+            ++skipped_;
+        }
+        return false;
+    }
+
+    template<typename T>
+    bool next(T& record) {
+        BufferReader payload(nullptr, 0);
+        if (!next_frame(payload)) return false;
+        deserialize(record, payload);
+        if (payload.remaining() != 0) throw std::runtime_error("RecordLogReader: record size mismatch");
+        return true;
+    }
+
+    size_t records() const { return records_; }
+
+    // 因校验失败或截断而跳过的字节数
+    size_t skipped_bytes() const { return skipped_; }
+
+    // 最后一个合法帧的结束位置；之后的内容都已被跳过
+    size_t valid_bytes() const { return validEnd_; }
+
+private:
+    std::unique_ptr<MappedFile> file_;
+    const char* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    size_t validEnd_ = 0;
+    size_t records_ = 0;
+    size_t skipped_ = 0;
+};
+
+// 截掉最后一个合法帧之后的内容，返回保留的字节数；文件不存在时返回 0。
+// 按读端的方式扫描：中间损坏的字节与其后的合法帧都保留，读端仍能跳过损坏读出后面的记录
+inline size_t recover_record_log(const std::string& filename) {
+    size_t keep = 0, size = 0;
+    {
+        std::FILE* probe = std::fopen(filename.c_str(), "rb");
+        if (!probe) return 0;
+        std::fclose(probe);
+        MappedFile file(filename);
+        size = file.size();
+        RecordLogReader log(file.data(), size);
+        BufferReader payload(nullptr, 0);
+        while (log.next_frame(payload)) {
+        }
+        keep = log.valid_bytes();
+    }
+    if (keep != size) {
+#if defined(_WIN32)
+        std::error_code ec;
+        std::filesystem::resize_file(filename, keep, ec);
+        if (ec) throw std::runtime_error("Failed to truncate file");
+#else
+        if (::truncate(filename.c_str(), static_cast<off_t>(keep)) != 0) {
+            throw std::runtime_error("Failed to truncate file");
+        }
+#endif
+    }
+    return keep;
+}
+
+// ========== RecordLogWriter ==========
+// 记录先编码成帧放进内存中的批次，批次达到 groupBytes 时一次写出（成组刷新）；
+// flush() 立即写出当前批次，sync() 再把文件落盘。析构时写出剩余批次。
+//     RecordLogWriter log("events.log");
+//     for (const auto& e : events) log.append(e);
+//     log.sync();
+class RecordLogWriter {
+public:
+    explicit RecordLogWriter(const std::string& filename, size_t groupBytes = 1 << 20)
+        : groupBytes_(groupBytes), batch_(groupBytes + (groupBytes >> 2)) {
+        recover_record_log(filename);
+        file_ = std::fopen(filename.c_str(), "ab");
+        if (!file_) throw std::runtime_error("Failed to open file for writing");
+    }
+
+    ~RecordLogWriter() {
+        try {
+            flush();
+        } catch (...) {
+        }
+        std::fclose(file_);
+    }
+
+    RecordLogWriter(const RecordLogWriter&) = delete;
+    RecordLogWriter& operator=(const RecordLogWriter&) = delete;
+
+    template<typename T>
+    void append(const T& record) {
+        scratch_.clear();
+        serialize(record, scratch_);
+        if (scratch_.size() > UINT32_MAX) throw std::runtime_error("RecordLogWriter: record too large");
+        uint32_t length = static_cast<uint32_t>(scratch_.size());
+        uint32_t crc = detail::frame_crc(length, scratch_.data());
+        char header[detail::kFrameHeaderSize];
+        std::memcpy(header, &length, sizeof(length));
+        std::memcpy(header + sizeof(length), &crc, sizeof(crc));
+        batch_.write(header, sizeof(header));
+        batch_.write(scratch_.data(), scratch_.size());
+        ++records_;
+        if (batch_.size() >= groupBytes_) flush();
+    }
+
+    void flush() {
+        if (batch_.size() == 0) return;
+        size_t written = std::fwrite(batch_.data(), 1, batch_.size(), file_);
+        bool ok = written == batch_.size() && std::fflush(file_) == 0;
+        batch_.clear();
+        if (!ok) throw std::runtime_error("Failed to write file");
+    }
+
+    void sync() {
+        flush();
+#if defined(_WIN32)
+        bool ok = ::_commit(::_fileno(file_)) == 0;
+#else
+        bool ok = ::fsync(::fileno(file_)) == 0;
+#endif
+        if (!ok) throw std::runtime_error("Failed to sync file");
+    }
+
+    // 本次打开后追加的记录数
+    size_t records() const { return records_; }
+
+private:
+    size_t groupBytes_;
+    BufferWriter batch_;
+    BufferWriter scratch_;
+    std::FILE* file_ = nullptr;
+    size_t records_ = 0;
+};
+
+} // namespace BinarySerialization
+
+#endif // BINARY_RECORD_LOG_H
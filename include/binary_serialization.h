@@ -2,177 +2,870 @@
 #define BINARY_SERIALIZATION_H
 
 #include <fstream>
+#include <array>
+#include <cstring>
 #include <string>
 #include <type_traits>
 #include <vector>
 #include <list>
 #include <set>
 #include <map>
+#include <memory>
+#include <typeinfo>
 #include <utility>
+#include <tuple>
 #include <stdexcept>
+#include "binary_archive.h"
+#include "binary_varint.h"
+#include "binary_view.h"
+#include "binary_dictionary.h"
+#include "binary_graph.h"
+#include "serialization_stats.h"
 
 namespace BinarySerialization {
 
-// 优先匹配有成员 serialize/deserialize 的类型（SFINAE）
+// ========== 批量拷贝判定 ==========
+// 内存表示与线上格式逐字节一致的类型，容器中可整段 write/read
 template<typename T>
-auto serialize(const T& obj, std::ostream& os) -> decltype(obj.serialize(os), void()) {
+struct is_bulk_copyable : std::is_arithmetic<T> {};
+
+template<typename T, size_t N>
+struct is_bulk_copyable<std::array<T, N>>
+    : std::integral_constant<bool, is_bulk_copyable<T>::value && sizeof(std::array<T, N>) == N * sizeof(T)> {};
+
+// 两个成员都是算术类型的 pair；std::pair 不是 trivially copyable，且可能含填充，需打包后整段读写
+template<typename T>
+struct is_arithmetic_pair : std::false_type {};
+
+template<typename T1, typename T2>
+struct is_arithmetic_pair<std::pair<T1, T2>>
+    : std::integral_constant<bool, std::is_arithmetic<T1>::value && std::is_arithmetic<T2>::value> {};
+
+// vector<bool> 没有 data()，不能走批量路径
+template<typename T>
+struct is_bulk_vector_element
+    : std::integral_constant<bool, is_bulk_copyable<T>::value && !std::is_same<T, bool>::value> {};
+
+// 紧凑模式下整数按 varint 编码，含整数的类型不能整段拷贝
+template<typename T>
+struct has_varint_integer : is_varint_integer<T> {};
+
+template<typename T, size_t N>
+struct has_varint_integer<std::array<T, N>> : has_varint_integer<T> {};
+
+template<typename T1, typename T2>
+struct has_varint_integer<std::pair<T1, T2>>
+    : std::integral_constant<bool, has_varint_integer<T1>::value || has_varint_integer<T2>::value> {};
+
+// 批量类型的标量成分（std::array 逐层展开）；可移植模式下按标量做字节序转换
+template<typename T>
+struct bulk_scalar { using type = T; };
+
+template<typename T, size_t N>
+struct bulk_scalar<std::array<T, N>> : bulk_scalar<T> {};
+
+template<typename T>
+using bulk_scalar_t = typename bulk_scalar<T>::type;
+
+// 可移植模式下线上宽度与内存宽度相同的标量才能整段处理（32 位平台上的 long 逐个加宽）
+template<typename T>
+struct is_portable_bulk
+    : std::integral_constant<bool, is_portable_type<bulk_scalar_t<T>>::value &&
+                                   portable_width<bulk_scalar_t<T>>::value == sizeof(bulk_scalar_t<T>)> {};
+
+template<typename T1, typename T2>
+struct is_portable_bulk<std::pair<T1, T2>>
+    : std::integral_constant<bool, is_portable_bulk<T1>::value && is_portable_bulk<T2>::value> {};
+
+template<typename T, typename Stream>
+struct is_bulk_for
+    : std::integral_constant<bool, is_bulk_vector_element<T>::value &&
+                                   !(is_compact_archive<Stream>::value && has_varint_integer<T>::value) &&
+                                   !(is_portable_archive<Stream>::value && !is_portable_bulk<T>::value)> {};
+
+template<typename T, typename Stream>
+struct is_packed_pair_for
+    : std::integral_constant<bool, is_arithmetic_pair<T>::value &&
+                                   !(is_compact_archive<Stream>::value && has_varint_integer<T>::value) &&
+                                   !(is_portable_archive<Stream>::value && !is_portable_bulk<T>::value)> {};
+
+// 紧凑模式下的整数数组：整串 varint 编解码
+template<typename T, typename Stream>
+struct is_varint_run_for
+    : std::integral_constant<bool, is_compact_archive<Stream>::value && is_varint_integer<T>::value> {};
+
+// ========== 前置声明（保证嵌套容器能找到后面定义的重载） ==========
+template<typename T1, typename T2, typename Stream> enable_if_output_t<Stream> serialize(const std::pair<T1, T2>& p, Stream& os);
+template<typename T1, typename T2, typename Stream> enable_if_input_t<Stream> deserialize(std::pair<T1, T2>& p, Stream& is);
+template<typename T, size_t N, typename Stream> enable_if_output_t<Stream> serialize(const std::array<T, N>& a, Stream& os);
+template<typename T, size_t N, typename Stream> enable_if_input_t<Stream> deserialize(std::array<T, N>& a, Stream& is);
+template<typename T, typename A, typename Stream> enable_if_output_t<Stream> serialize(const std::vector<T, A>& v, Stream& os);
+template<typename T, typename A, typename Stream> enable_if_input_t<Stream> deserialize(std::vector<T, A>& v, Stream& is);
+template<typename T, typename A, typename Stream> enable_if_output_t<Stream> serialize(const std::list<T, A>& l, Stream& os);
+template<typename T, typename A, typename Stream> enable_if_input_t<Stream> deserialize(std::list<T, A>& l, Stream& is);
+template<typename T, typename C, typename A, typename Stream> enable_if_output_t<Stream> serialize(const std::set<T, C, A>& s, Stream& os);
+template<typename T, typename C, typename A, typename Stream> enable_if_input_t<Stream> deserialize(std::set<T, C, A>& s, Stream& is);
+template<typename K, typename V, typename C, typename A, typename Stream> enable_if_output_t<Stream> serialize(const std::map<K, V, C, A>& m, Stream& os);
+template<typename K, typename V, typename C, typename A, typename Stream> enable_if_input_t<Stream> deserialize(std::map<K, V, C, A>& m, Stream& is);
+template<typename T, typename Stream> enable_if_output_t<Stream> serialize(const std::unique_ptr<T>& p, Stream& os);
+template<typename T, typename Stream> enable_if_input_t<Stream> deserialize(std::unique_ptr<T>& p, Stream& is);
+template<typename T, typename Stream> enable_if_output_t<Stream> serialize(const std::shared_ptr<T>& p, Stream& os);
+template<typename T, typename Stream> enable_if_input_t<Stream> deserialize(std::shared_ptr<T>& p, Stream& is);
+template<typename T, typename Stream> enable_if_output_t<Stream> serialize(const std::weak_ptr<T>& p, Stream& os);
+template<typename T, typename Stream> enable_if_input_t<Stream> deserialize(std::weak_ptr<T>& p, Stream& is);
+
+// 优先匹配有成员 serialize/deserialize 的类型（SFINAE）；定义 SERIALIZATION_STATS 时按类型统计
+template<typename T, typename Stream, typename = enable_if_output_t<Stream>>
+auto serialize(const T& obj, Stream& os) -> decltype(obj.serialize(os), void()) {
+    SERIALIZATION_STATS_SCOPE((serialization_stats::type_site<T, serialization_stats::Binary, serialization_stats::Encode>()), os);
     obj.serialize(os);
 }
 
-template<typename T>
-auto deserialize(T& obj, std::istream& is) -> decltype(obj.deserialize(is), void()) {
+template<typename T, typename Stream, typename = enable_if_input_t<Stream>>
+auto deserialize(T& obj, Stream& is) -> decltype(obj.deserialize(is), void()) {
+    SERIALIZATION_STATS_SCOPE((serialization_stats::type_site<T, serialization_stats::Binary, serialization_stats::Decode>()), is);
     obj.deserialize(is);
 }
 
 // 算术类型
-template<typename T>
-typename std::enable_if<std::is_arithmetic<T>::value, void>::type
-serialize(const T& obj, std::ostream& os) {
-    os.write(reinterpret_cast<const char*>(&obj), sizeof(T));
+template<typename T, typename Stream>
+typename std::enable_if<std::is_arithmetic<T>::value && is_output_archive<Stream>::value, void>::type
+serialize(const T& obj, Stream& os) {
+    if constexpr (is_compact_archive<Stream>::value && is_varint_integer<T>::value) {
+        os.write_varint(to_varint_bits(obj));
+    } else if constexpr (is_portable_archive<Stream>::value) {
+        os.write_values(&obj, 1);
+    } else {
+        os.write(reinterpret_cast<const char*>(&obj), sizeof(T));
+    }
 }
 
-template<typename T>
-typename std::enable_if<std::is_arithmetic<T>::value, void>::type
-deserialize(T& obj, std::istream& is) {
-    is.read(reinterpret_cast<char*>(&obj), sizeof(T));
+template<typename T, typename Stream>
+typename std::enable_if<std::is_arithmetic<T>::value && is_input_archive<Stream>::value, void>::type
+deserialize(T& obj, Stream& is) {
+    if constexpr (is_compact_archive<Stream>::value && is_varint_integer<T>::value) {
+        obj = from_varint_bits<T>(is.read_varint());
+    } else if constexpr (is_portable_archive<Stream>::value) {
+        is.read_values(&obj, 1);
+    } else {
+        is.read(reinterpret_cast<char*>(&obj), sizeof(T));
+    }
 }
 
-// std::string
-inline void serialize(const std::string& str, std::ostream& os) {
-    size_t len = str.size();
-    os.write(reinterpret_cast<const char*>(&len), sizeof(len));
-    os.write(str.data(), len);
+// std::string（含 std::pmr::string 等自定义分配器的字符串）；字典模式下经由字符串表读写
+template<typename Traits, typename A, typename Stream>
+enable_if_output_t<Stream> serialize(const std::basic_string<char, Traits, A>& str, Stream& os) {
+    if constexpr (is_dictionary_archive<Stream>::value) {
+        os.write_string(str.data(), str.size());
+    } else {
+        write_length(os, str.size());
+        os.write(str.data(), str.size());
+    }
+}
+
+template<typename Traits, typename A, typename Stream>
+enable_if_input_t<Stream> deserialize(std::basic_string<char, Traits, A>& str, Stream& is) {
+    if constexpr (is_dictionary_archive<Stream>::value) {
+        std::string_view sv = is.read_string();
+        str.assign(sv.data(), sv.size());
+    } else {
+        size_t len = read_length(is);
+        str.resize(len);
+        is.read(&str[0], len);
+    }
 }
 
-inline void deserialize(std::string& str, std::istream& is) {
-    size_t len;
-    is.read(reinterpret_cast<char*>(&len), sizeof(len));
-    str.resize(len);
-    is.read(&str[0], len);
+namespace detail {
+
+// 可移植模式下打包好的算术 pair 在需要时逐字段转换字节序
+template<typename T1, typename T2, typename Stream>
+void swap_packed_pairs(char* buf, size_t count, Stream& s) {
+    if constexpr (is_portable_archive<Stream>::value) {
+        if (!s.swaps()) return;
+        for (size_t i = 0; i < count; ++i, buf += sizeof(T1) + sizeof(T2)) {
+            byteswap_copy_scalar(buf, buf, 1, sizeof(T1));
+            byteswap_copy_scalar(buf + sizeof(T1), buf + sizeof(T1), 1, sizeof(T2));
+        }
+    } else {
+        (void)buf;
+        (void)count;
+        (void)s;
+    }
 }
 
+} // namespace detail
+
 // std::pair
-template<typename T1, typename T2>
-void serialize(const std::pair<T1, T2>& p, std::ostream& os) {
-    serialize(p.first, os);
-    serialize(p.second, os);
+// 算术 pair 先拼到栈上缓冲区，一次 write/read
+template<typename T1, typename T2, typename Stream>
+enable_if_output_t<Stream> serialize(const std::pair<T1, T2>& p, Stream& os) {
+    if constexpr (is_packed_pair_for<std::pair<T1, T2>, Stream>::value) {
+        char buf[sizeof(T1) + sizeof(T2)];
+        std::memcpy(buf, &p.first, sizeof(T1));
+        std::memcpy(buf + sizeof(T1), &p.second, sizeof(T2));
+        detail::swap_packed_pairs<T1, T2>(buf, 1, os);
+        os.write(buf, sizeof(buf));
+    } else {
+        serialize(p.first, os);
+        serialize(p.second, os);
+    }
 }
 
-template<typename T1, typename T2>
-void deserialize(std::pair<T1, T2>& p, std::istream& is) {
-    deserialize(p.first, is);
-    deserialize(p.second, is);
+template<typename T1, typename T2, typename Stream>
+enable_if_input_t<Stream> deserialize(std::pair<T1, T2>& p, Stream& is) {
+    if constexpr (is_packed_pair_for<std::pair<T1, T2>, Stream>::value) {
+        char buf[sizeof(T1) + sizeof(T2)];
+        is.read(buf, sizeof(buf));
+        detail::swap_packed_pairs<T1, T2>(buf, 1, is);
+        std::memcpy(&p.first, buf, sizeof(T1));
+        std::memcpy(&p.second, buf + sizeof(T1), sizeof(T2));
+    } else {
+        deserialize(p.first, is);
+        deserialize(p.second, is);
+    }
+}
+
+// 算术 pair 数组按块打包读写，每块一次 write/read
+namespace detail {
+
+// 批量类型的连续元素整段读写；可移植模式下交给 Archive 做字节序转换
+template<typename T, typename Stream>
+void write_bulk(const T* p, size_t n, Stream& os) {
+    if constexpr (is_portable_archive<Stream>::value) {
+        using S = bulk_scalar_t<T>;
+        os.write_values(reinterpret_cast<const S*>(p), n * (sizeof(T) / sizeof(S)));
+    } else {
+        os.write(reinterpret_cast<const char*>(p), n * sizeof(T));
+    }
+}
+
+template<typename T, typename Stream>
+void read_bulk(T* p, size_t n, Stream& is) {
+    if constexpr (is_portable_archive<Stream>::value) {
+        using S = bulk_scalar_t<T>;
+        is.read_values(reinterpret_cast<S*>(p), n * (sizeof(T) / sizeof(S)));
+    } else {
+        is.read(reinterpret_cast<char*>(p), n * sizeof(T));
+    }
+}
+
+constexpr size_t kPairChunkBytes = 64 * 1024;
+
+template<typename T1, typename T2, typename Stream>
+void write_pairs(const std::pair<T1, T2>* p, size_t n, Stream& os) {
+    constexpr size_t stride = sizeof(T1) + sizeof(T2);
+    constexpr size_t perChunk = kPairChunkBytes / stride;
+    std::vector<char> buf((n < perChunk ? n : perChunk) * stride);
+    while (n > 0) {
+        size_t count = n < perChunk ? n : perChunk;
+        char* out = buf.data();
+        for (size_t i = 0; i < count; ++i, out += stride) {
+            std::memcpy(out, &p[i].first, sizeof(T1));
+            std::memcpy(out + sizeof(T1), &p[i].second, sizeof(T2));
+        }
+        swap_packed_pairs<T1, T2>(buf.data(), count, os);
+        os.write(buf.data(), count * stride);
+        p += count;
+        n -= count;
+    }
+}
+
+template<typename T1, typename T2, typename Stream>
+void read_pairs(std::pair<T1, T2>* p, size_t n, Stream& is) {
+    constexpr size_t stride = sizeof(T1) + sizeof(T2);
+    constexpr size_t perChunk = kPairChunkBytes / stride;
+    std::vector<char> buf((n < perChunk ? n : perChunk) * stride);
+    while (n > 0) {
+        size_t count = n < perChunk ? n : perChunk;
+        is.read(buf.data(), count * stride);
+        swap_packed_pairs<T1, T2>(buf.data(), count, is);
+        const char* in = buf.data();
+        for (size_t i = 0; i < count; ++i, in += stride) {
+            std::memcpy(&p[i].first, in, sizeof(T1));
+            std::memcpy(&p[i].second, in + sizeof(T1), sizeof(T2));
+        }
+        p += count;
+        n -= count;
+    }
+}
+
+// 一段连续元素的编解码，与 std::vector 的元素部分相同（含批量 / 打包 pair / varint 串快速路径），
+// 供分块、列式等需要按区间处理元素的格式复用
+template<typename T, typename Stream>
+void encode_range(const T* first, size_t count, Stream& os) {
+    if constexpr (is_bulk_for<T, Stream>::value) {
+        write_bulk(first, count, os);
+    } else if constexpr (is_packed_pair_for<T, Stream>::value) {
+        write_pairs(first, count, os);
+    } else if constexpr (is_varint_run_for<T, Stream>::value) {
+        os.write_varints(first, count);
+    } else {
+        for (size_t i = 0; i < count; ++i) serialize(first[i], os);
+    }
+}
+
+template<typename T, typename Stream>
+void decode_range(T* first, size_t count, Stream& is) {
+    if constexpr (is_bulk_for<T, Stream>::value) {
+        read_bulk(first, count, is);
+    } else if constexpr (is_packed_pair_for<T, Stream>::value) {
+        read_pairs(first, count, is);
+    } else if constexpr (is_varint_run_for<T, Stream>::value) {
+        is.read_varints(first, count);
+    } else {
+        for (size_t i = 0; i < count; ++i) deserialize(first[i], is);
+    }
+}
+
+} // namespace detail
+
+// std::array（长度由类型决定，不写长度前缀）
+template<typename T, size_t N, typename Stream>
+enable_if_output_t<Stream> serialize(const std::array<T, N>& a, Stream& os) {
+    if constexpr (is_bulk_for<std::array<T, N>, Stream>::value) {
+        detail::write_bulk(a.data(), N, os);
+    } else if constexpr (is_packed_pair_for<T, Stream>::value) {
+        detail::write_pairs(a.data(), N, os);
+    } else if constexpr (is_varint_run_for<T, Stream>::value) {
+        os.write_varints(a.data(), N);
+    } else {
+        for (const auto& item : a) serialize(item, os);
+    }
+}
+
+template<typename T, size_t N, typename Stream>
+enable_if_input_t<Stream> deserialize(std::array<T, N>& a, Stream& is) {
+    if constexpr (is_bulk_for<std::array<T, N>, Stream>::value) {
+        detail::read_bulk(a.data(), N, is);
+    } else if constexpr (is_packed_pair_for<T, Stream>::value) {
+        detail::read_pairs(a.data(), N, is);
+    } else if constexpr (is_varint_run_for<T, Stream>::value) {
+        is.read_varints(a.data(), N);
+    } else {
+        for (auto& item : a) deserialize(item, is);
+    }
 }
 
 // std::vector
-template<typename T>
-void serialize(const std::vector<T>& v, std::ostream& os) {
+template<typename T, typename A, typename Stream>
+enable_if_output_t<Stream> serialize(const std::vector<T, A>& v, Stream& os) {
     size_t size = v.size();
-    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
-    for (const auto& item : v) serialize(item, os);
+    write_length(os, size);
+    if constexpr (is_bulk_for<T, Stream>::value) {
+        detail::write_bulk(v.data(), size, os);
+    } else if constexpr (is_packed_pair_for<T, Stream>::value) {
+        detail::write_pairs(v.data(), size, os);
+    } else if constexpr (is_varint_run_for<T, Stream>::value) {
+        os.write_varints(v.data(), size);
+    } else {
+        for (const auto& item : v) serialize(item, os);
+    }
 }
 
-template<typename T>
-void deserialize(std::vector<T>& v, std::istream& is) {
-    size_t size;
-    is.read(reinterpret_cast<char*>(&size), sizeof(size));
+template<typename T, typename A, typename Stream>
+enable_if_input_t<Stream> deserialize(std::vector<T, A>& v, Stream& is) {
+    size_t size = read_length(is);
     v.resize(size);
-    for (auto& item : v) deserialize(item, is);
+    if constexpr (is_bulk_for<T, Stream>::value) {
+        detail::read_bulk(v.data(), size, is);
+    } else if constexpr (is_packed_pair_for<T, Stream>::value) {
+        detail::read_pairs(v.data(), size, is);
+    } else if constexpr (is_varint_run_for<T, Stream>::value) {
+        is.read_varints(v.data(), size);
+    } else {
+        for (auto& item : v) deserialize(item, is);
+    }
 }
 
-// std::list
-template<typename T>
-void serialize(const std::list<T>& l, std::ostream& os) {
-    size_t size = l.size();
-    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+// std::list / std::set / std::map
+// 元素直接在容器节点中构造并移动进入；输入由有序容器写出，set/map 以 end() 为提示插入，均摊 O(1)。
+// 容器使用 std::pmr 分配器时，临时元素也用容器的分配器构造，整个快照可以解码进同一块 arena。
+template<typename T, typename Alloc>
+T make_element(const Alloc& alloc) {
+    if constexpr (std::uses_allocator<T, Alloc>::value && std::is_constructible<T, const Alloc&>::value) {
+        return T(alloc);
+    } else {
+        return T();
+    }
+}
+
+template<typename T, typename A, typename Stream>
+enable_if_output_t<Stream> serialize(const std::list<T, A>& l, Stream& os) {
+    write_length(os, l.size());
     for (const auto& item : l) serialize(item, os);
 }
 
-template<typename T>
-void deserialize(std::list<T>& l, std::istream& is) {
-    size_t size;
-    is.read(reinterpret_cast<char*>(&size), sizeof(size));
+template<typename T, typename A, typename Stream>
+enable_if_input_t<Stream> deserialize(std::list<T, A>& l, Stream& is) {
+    size_t size = read_length(is);
     l.clear();
     for (size_t i = 0; i < size; ++i) {
-        T item;
-        deserialize(item, is);
-        l.push_back(item);
+        l.emplace_back();
+        deserialize(l.back(), is);
     }
 }
 
-// std::set
-template<typename T>
-void serialize(const std::set<T>& s, std::ostream& os) {
-    size_t size = s.size();
-    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+template<typename T, typename C, typename A, typename Stream>
+enable_if_output_t<Stream> serialize(const std::set<T, C, A>& s, Stream& os) {
+    write_length(os, s.size());
     for (const auto& item : s) serialize(item, os);
 }
 
-template<typename T>
-void deserialize(std::set<T>& s, std::istream& is) {
-    size_t size;
-    is.read(reinterpret_cast<char*>(&size), sizeof(size));
+template<typename T, typename C, typename A, typename Stream>
+enable_if_input_t<Stream> deserialize(std::set<T, C, A>& s, Stream& is) {
+    size_t size = read_length(is);
     s.clear();
     for (size_t i = 0; i < size; ++i) {
-        T item;
+        T item = make_element<T>(s.get_allocator());
         deserialize(item, is);
-        s.insert(item);
+        s.emplace_hint(s.end(), std::move(item));
     }
 }
 
-// std::map
-template<typename K, typename V>
-void serialize(const std::map<K, V>& m, std::ostream& os) {
-    size_t size = m.size();
-    os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+template<typename K, typename V, typename C, typename A, typename Stream>
+enable_if_output_t<Stream> serialize(const std::map<K, V, C, A>& m, Stream& os) {
+    write_length(os, m.size());
     for (const auto& kv : m) {
         serialize(kv.first, os);
         serialize(kv.second, os);
     }
 }
 
-template<typename K, typename V>
-void deserialize(std::map<K, V>& m, std::istream& is) {
-    size_t size;
-    is.read(reinterpret_cast<char*>(&size), sizeof(size));
+template<typename K, typename V, typename C, typename A, typename Stream>
+enable_if_input_t<Stream> deserialize(std::map<K, V, C, A>& m, Stream& is) {
+    size_t size = read_length(is);
     m.clear();
     for (size_t i = 0; i < size; ++i) {
-        K key;
-        V value;
+        K key = make_element<K>(m.get_allocator());
         deserialize(key, is);
-        deserialize(value, is);
-        m.emplace(std::move(key), std::move(value));
+        auto it = m.emplace_hint(m.end(), std::piecewise_construct,
+                                 std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
+        deserialize(it->second, is);
+    }
+}
+
+// ========== 智能指针 ==========
+// 对象按指针的静态类型写出；多态类型指向派生类对象时写出会丢失派生部分，因此直接报错
+namespace detail {
+
+template<typename T>
+void check_static_type(const T& obj) {
+    if constexpr (std::is_polymorphic<T>::value) {
+        if (typeid(obj) != typeid(T)) throw std::runtime_error("Cannot serialize a pointer to a derived object");
+    }
+}
+
+template<typename T, typename Stream>
+void write_pointee(const void* object, Stream& os) {
+    serialize(*static_cast<const T*>(object), os);
+}
+
+template<typename T, typename Stream>
+void read_pointee(void* object, Stream& is) {
+    deserialize(*static_cast<T*>(object), is);
+}
+
+} // namespace detail
+
+// std::unique_ptr：独占所有权，不需要身份表，任何 Archive 都可用；1 字节存在标记后跟对象本身
+template<typename T, typename Stream>
+enable_if_output_t<Stream> serialize(const std::unique_ptr<T>& p, Stream& os) {
+    static_assert(!std::is_array<T>::value, "std::unique_ptr<T[]> is not supported");
+    uint8_t present = p ? 1 : 0;
+    serialize(present, os);
+    if (p) {
+        detail::check_static_type(*p);
+        serialize(*p, os);
+    }
+}
+
+template<typename T, typename Stream>
+enable_if_input_t<Stream> deserialize(std::unique_ptr<T>& p, Stream& is) {
+    static_assert(!std::is_array<T>::value, "std::unique_ptr<T[]> is not supported");
+    uint8_t present = 0;
+    deserialize(present, is);
+    if (!present) {
+        p.reset();
+        return;
+    }
+    if (!p || typeid(*p) != typeid(T)) p.reset(new T());
+    deserialize(*p, is);
+}
+
+// std::shared_ptr / std::weak_ptr：需要 GraphWriter / GraphReader（见 binary_graph.h），同一对象只写一次
+template<typename T, typename Stream>
+enable_if_output_t<Stream> serialize(const std::shared_ptr<T>& p, Stream& os) {
+    static_assert(is_graph_archive<Stream>::value,
+                  "std::shared_ptr must be serialized through GraphWriter (see serialize_graph)");
+    using U = std::remove_const_t<T>;
+    if (p) detail::check_static_type(*p);
+    const void* object = static_cast<const U*>(p.get());
+    if (os.write_pointer(object, detail::graph_type_key<U>())) os.write_object(object, &detail::write_pointee<U, Stream>);
+}
+
+template<typename T, typename Stream>
+enable_if_input_t<Stream> deserialize(std::shared_ptr<T>& p, Stream& is) {
+    static_assert(is_graph_archive<Stream>::value,
+                  "std::shared_ptr must be deserialized through GraphReader (see deserialize_graph)");
+    using U = std::remove_const_t<T>;
+    uint64_t tag = is.read_pointer();
+    if (tag == 0) {
+        p.reset();
+    } else if (tag >= 2) {
+        p = is.template object<U>(tag - 2);
+    } else {
+        // 先登记再读内容，对象内容中指回自身（环）的指针能找到它
+        std::shared_ptr<U> object = std::make_shared<U>();
+        is.add_object(object);
+        p = object;
+        is.read_object(object.get(), &detail::read_pointee<U, Stream>);
+    }
+}
+
+template<typename T, typename Stream>
+enable_if_output_t<Stream> serialize(const std::weak_ptr<T>& p, Stream& os) {
+    serialize(p.lock(), os);
+}
+
+template<typename T, typename Stream>
+enable_if_input_t<Stream> deserialize(std::weak_ptr<T>& p, Stream& is) {
+    std::shared_ptr<T> object;
+    deserialize(object, is);
+    p = object;
+}
+
+// ========== BINARY_SERIALIZABLE 成员访问 ==========
+// 宏生成的 binary_fields 把全部成员交给访问者；这里得到成员引用的 tuple，供按成员处理的格式使用
+namespace detail {
+
+struct tie_fields {
+    template<typename... F>
+    std::tuple<F&...> operator()(F&... fields) const { return std::tuple<F&...>(fields...); }
+};
+
+// 成员引用组成的 tuple，按 BINARY_SERIALIZABLE 中的声明顺序
+template<typename T>
+auto field_refs(T& obj) { return obj.binary_fields(tie_fields{}); }
+
+template<typename T>
+using field_tuple_t = decltype(field_refs(std::declval<T&>()));
+
+template<typename T, typename = void>
+struct has_binary_fields : std::false_type {};
+
+template<typename T>
+struct has_binary_fields<T, decltype(std::declval<T&>().binary_fields(tie_fields{}), void())> : std::true_type {};
+
+} // namespace detail
+
+// ========== 编码大小 ==========
+// serialized_size(obj) 返回 obj 在默认模式下编码的精确字节数，不实际编码。
+// 固定大小的类型（算术类型，及由它们组成的 std::array / std::pair / BINARY_SERIALIZABLE 类型）
+// 的大小在编译期已知，fixed_serialized_size<T>::value 即为该值（0 表示不定长），serialized_size 此时是常量表达式；
+// 不定长类型遍历一遍求和，定长元素的容器只按元素个数相乘。
+// 只提供成员 serialize 的类型用 SizeCounter 做一次计数编码。
+template<typename T, typename = void>
+struct fixed_serialized_size : std::integral_constant<size_t, 0> {};
+
+template<typename T>
+struct fixed_serialized_size<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    : std::integral_constant<size_t, sizeof(T)> {};
+
+template<typename T, size_t N>
+struct fixed_serialized_size<std::array<T, N>> : std::integral_constant<size_t, N * fixed_serialized_size<T>::value> {};
+
+template<typename T1, typename T2>
+struct fixed_serialized_size<std::pair<T1, T2>>
+    : std::integral_constant<size_t, fixed_serialized_size<T1>::value && fixed_serialized_size<T2>::value
+                                         ? fixed_serialized_size<T1>::value + fixed_serialized_size<T2>::value
+                                         : 0> {};
+
+namespace detail {
+
+// 只在 decltype 中使用：得到 BINARY_SERIALIZABLE 成员类型组成的 tuple
+struct field_types {
+    template<typename... F>
+    std::tuple<F...> operator()(const F&...) const;
+};
+
+template<typename Tuple>
+struct fixed_fields_size;
+
+template<typename... F>
+struct fixed_fields_size<std::tuple<F...>>
+    : std::integral_constant<size_t, (... && (fixed_serialized_size<F>::value != 0))
+                                         ? (size_t(0) + ... + fixed_serialized_size<F>::value)
+                                         : 0> {};
+
+template<typename T>
+using field_types_t = decltype(std::declval<const T&>().binary_fields(field_types{}));
+
+} // namespace detail
+
+template<typename T>
+struct fixed_serialized_size<T, std::void_t<detail::field_types_t<T>>>
+    : detail::fixed_fields_size<detail::field_types_t<T>> {};
+
+// 只累计字节数的输出 Archive
+class SizeCounter {
+public:
+    void write(const char*, size_t n) { size_ += n; }
+    size_t size() const { return size_; }
+
+private:
+    size_t size_ = 0;
+};
+
+} // namespace BinarySerialization
+
+// serialized_size 的计数编码不算作一次编码
+template<>
+struct serialization_stats::ignore_archive<BinarySerialization::SizeCounter> : std::true_type {};
+template<>
+struct serialization_stats::ignore_archive<BinarySerialization::CompactWriter<BinarySerialization::SizeCounter>>
+    : std::true_type {};
+
+namespace BinarySerialization {
+
+template<typename T> constexpr size_t serialized_size(const T& obj);
+template<typename Traits, typename A> size_t serialized_size(const std::basic_string<char, Traits, A>& str);
+inline size_t serialized_size(const std::string_view& sv);
+template<typename T> size_t serialized_size(const ArrayView<T>& v);
+template<typename T1, typename T2> constexpr size_t serialized_size(const std::pair<T1, T2>& p);
+template<typename T, size_t N> constexpr size_t serialized_size(const std::array<T, N>& a);
+template<typename T, typename A> size_t serialized_size(const std::vector<T, A>& v);
+template<typename T, typename A> size_t serialized_size(const std::list<T, A>& l);
+template<typename T, typename C, typename A> size_t serialized_size(const std::set<T, C, A>& s);
+template<typename K, typename V, typename C, typename A> size_t serialized_size(const std::map<K, V, C, A>& m);
+
+namespace detail {
+
+struct field_sizes {
+    template<typename... F>
+    size_t operator()(const F&... fields) const { return (size_t(0) + ... + serialized_size(fields)); }
+};
+
+template<typename Range>
+size_t elements_size(const Range& range) {
+    using T = typename Range::value_type;
+    if constexpr (fixed_serialized_size<T>::value != 0) {
+        return range.size() * fixed_serialized_size<T>::value;
+    } else {
+        size_t total = 0;
+        for (const auto& item : range) total += serialized_size(item);
+        return total;
+    }
+}
+
+} // namespace detail
+
+template<typename T>
+constexpr size_t serialized_size(const T& obj) {
+    if constexpr (fixed_serialized_size<T>::value != 0) {
+        return fixed_serialized_size<T>::value;
+    } else if constexpr (detail::has_binary_fields<T>::value) {
+        return obj.binary_fields(detail::field_sizes{});
+    } else {
+        SizeCounter counter;
+        serialize(obj, counter);
+        return counter.size();
+    }
+}
+
+template<typename Traits, typename A>
+size_t serialized_size(const std::basic_string<char, Traits, A>& str) {
+    return sizeof(size_t) + str.size();
+}
+
+inline size_t serialized_size(const std::string_view& sv) { return sizeof(size_t) + sv.size(); }
+
+template<typename T>
+size_t serialized_size(const ArrayView<T>& v) {
+    return sizeof(size_t) + v.size() * sizeof(T);
+}
+
+template<typename T1, typename T2>
+constexpr size_t serialized_size(const std::pair<T1, T2>& p) {
+    return serialized_size(p.first) + serialized_size(p.second);
+}
+
+template<typename T, size_t N>
+constexpr size_t serialized_size(const std::array<T, N>& a) {
+    if constexpr (fixed_serialized_size<T>::value != 0) {
+        return N * fixed_serialized_size<T>::value;
+    } else {
+        return detail::elements_size(a);
+    }
+}
+
+template<typename T, typename A>
+size_t serialized_size(const std::vector<T, A>& v) {
+    return sizeof(size_t) + detail::elements_size(v);
+}
+
+template<typename T, typename A>
+size_t serialized_size(const std::list<T, A>& l) {
+    return sizeof(size_t) + detail::elements_size(l);
+}
+
+template<typename T, typename C, typename A>
+size_t serialized_size(const std::set<T, C, A>& s) {
+    return sizeof(size_t) + detail::elements_size(s);
+}
+
+template<typename K, typename V, typename C, typename A>
+size_t serialized_size(const std::map<K, V, C, A>& m) {
+    if constexpr (fixed_serialized_size<K>::value != 0 && fixed_serialized_size<V>::value != 0) {
+        return sizeof(size_t) + m.size() * (fixed_serialized_size<K>::value + fixed_serialized_size<V>::value);
+    } else {
+        size_t total = sizeof(size_t);
+        for (const auto& kv : m) total += serialized_size(kv.first) + serialized_size(kv.second);
+        return total;
     }
 }
 
-// 文件接口
+// 紧凑模式下的编码大小与值有关，用一次计数编码求得
+template<typename T>
+size_t serialized_size_compact(const T& obj) {
+    SizeCounter counter;
+    CompactWriter<SizeCounter> compact(counter);
+    serialize(obj, compact);
+    return counter.size();
+}
+
+// 先求出编码大小，一次分配恰好大小的缓冲区再编码
+template<typename T>
+BufferWriter serialize_to_buffer(const T& obj) {
+    BufferWriter writer(serialized_size(obj));
+    serialize(obj, writer);
+    return writer;
+}
+
+// 文件接口：写入时先编码到内存缓冲区再一次性写文件；读取时直接从内存映射解码。
+// 映射在函数返回时释放，读取经由不提供 consume 的 CopyingReader，视图类型的目标无法通过编译；
+// 需要视图时自行持有 MappedFile 并调用 deserialize(obj, file)
 template<typename T>
 void serialize(const T& obj, const std::string& filename) {
     std::ofstream ofs(filename, std::ios::binary);
     if (!ofs) throw std::runtime_error("Failed to open file for writing");
-    serialize(obj, ofs);
+    BufferWriter writer = serialize_to_buffer(obj);
+    ofs.write(writer.data(), writer.size());
+    if (!ofs) throw std::runtime_error("Failed to write file");
 }
 
 template<typename T>
 void deserialize(T& obj, const std::string& filename) {
-    std::ifstream ifs(filename, std::ios::binary);
-    if (!ifs) throw std::runtime_error("Failed to open file for reading");
-    deserialize(obj, ifs);
+    MappedFile file(filename);
+    CopyingReader reader(file.data(), file.size());
+    deserialize(obj, reader);
+}
+
+// 紧凑模式文件接口：长度前缀与整数使用 varint
+template<typename T>
+void serialize_compact(const T& obj, const std::string& filename) {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) throw std::runtime_error("Failed to open file for writing");
+    BufferWriter writer;
+    CompactWriter<BufferWriter> compact(writer);
+    serialize(obj, compact);
+    ofs.write(writer.data(), writer.size());
+    if (!ofs) throw std::runtime_error("Failed to write file");
+}
+
+template<typename T>
+void deserialize_compact(T& obj, const std::string& filename) {
+    MappedFile file(filename);
+    CopyingReader reader(file.data(), file.size());
+    CompactReader<CopyingReader> compact(reader);
+    deserialize(obj, compact);
+}
+
+// 可移植模式文件接口：固定小端、固定宽度，附带格式头，可在不同字节序 / 字长的平台之间交换
+template<typename T>
+void serialize_portable(const T& obj, const std::string& filename) {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) throw std::runtime_error("Failed to open file for writing");
+    BufferWriter writer;
+    PortableWriter<BufferWriter> portable(writer);
+    serialize(obj, portable);
+    ofs.write(writer.data(), writer.size());
+    if (!ofs) throw std::runtime_error("Failed to write file");
+}
+
+template<typename T>
+void deserialize_portable(T& obj, const std::string& filename) {
+    MappedFile file(filename);
+    CopyingReader reader(file.data(), file.size());
+    PortableReader<CopyingReader> portable(reader);
+    deserialize(obj, portable);
+}
+
+// 字典模式文件接口：重复出现的字符串只写一次。需要 string_view 指向字典项时，
+// 自行在 MappedFile::reader() 上构造 DictionaryReader，并让映射与视图同生命周期
+template<typename T>
+void serialize_dictionary(const T& obj, const std::string& filename) {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) throw std::runtime_error("Failed to open file for writing");
+    BufferWriter writer;
+    DictionaryWriter<BufferWriter> dict(writer);
+    serialize(obj, dict);
+    ofs.write(writer.data(), writer.size());
+    if (!ofs) throw std::runtime_error("Failed to write file");
+}
+
+template<typename T>
+void deserialize_dictionary(T& obj, const std::string& filename) {
+    MappedFile file(filename);
+    CopyingReader reader(file.data(), file.size());
+    DictionaryReader<CopyingReader> dict(reader);
+    deserialize(obj, dict);
+}
+
+// 对象图文件接口：std::shared_ptr / std::weak_ptr 指向的对象只写一次，读回时恢复共享关系与环
+template<typename T>
+void serialize_graph(const T& obj, const std::string& filename) {
+    std::ofstream ofs(filename, std::ios::binary);
+    if (!ofs) throw std::runtime_error("Failed to open file for writing");
+    BufferWriter writer;
+    GraphWriter<BufferWriter> graph(writer);
+    serialize(obj, graph);
+    ofs.write(writer.data(), writer.size());
+    if (!ofs) throw std::runtime_error("Failed to write file");
+}
+
+template<typename T>
+void deserialize_graph(T& obj, const std::string& filename) {
+    MappedFile file(filename);
+    CopyingReader reader(file.data(), file.size());
+    GraphReader<CopyingReader> graph(reader);
+    deserialize(obj, graph);
 }
 
 // 用户自定义类型宏
+// binary_fields(f) 以全部成员（按声明顺序）为参数调用一次 f，供列式等需要逐成员处理的格式使用
 #define BINARY_SERIALIZABLE(...) \
     template<typename Stream> \
     void serialize(Stream& os) const { \
-        BinarySerialization::serialize_members(os, __VA_ARGS__); \
+        BINARY_SERIALIZATION_MEMBERS(serialize_members, os, __VA_ARGS__); \
     } \
     template<typename Stream> \
     void deserialize(Stream& is) { \
-        BinarySerialization::deserialize_members(is, __VA_ARGS__); \
+        BINARY_SERIALIZATION_MEMBERS(deserialize_members, is, __VA_ARGS__); \
+    } \
+    template<typename BinaryFieldVisitor> \
+    decltype(auto) binary_fields(BinaryFieldVisitor&& binary_field_visitor_) const { \
+        return binary_field_visitor_(__VA_ARGS__); \
+    } \
+    template<typename BinaryFieldVisitor> \
+    decltype(auto) binary_fields(BinaryFieldVisitor&& binary_field_visitor_) { \
+        return binary_field_visitor_(__VA_ARGS__); \
     }
 
-inline void serialize_members(std::ostream&) {}
-inline void deserialize_members(std::istream&) {}
+template<typename Stream>
+void serialize_members(Stream&) {}
+
+template<typename Stream>
+void deserialize_members(Stream&) {}
 
 template<typename Stream, typename First, typename... Rest>
 void serialize_members(Stream& os, const First& first, const Rest&... rest) {
@@ -186,6 +879,45 @@ void deserialize_members(Stream& is, First& first, Rest&... rest) {
     deserialize_members(is, rest...);
 }
 
+// 定义 SERIALIZATION_STATS 时成员逐个计时，统计名取自宏参数文本
+#if defined(SERIALIZATION_STATS)
+#define BINARY_SERIALIZATION_MEMBERS(members, stream, ...) \
+    BinarySerialization::members##_tracked<std::remove_cv_t<std::remove_reference_t<decltype(*this)>>>( \
+        stream, #__VA_ARGS__, __VA_ARGS__)
+
+template<typename Owner, size_t... I, typename Stream, typename... Members>
+void serialize_members_tracked_(Stream& os, const char* names, std::index_sequence<I...>, const Members&... members) {
+    using namespace serialization_stats;
+    auto one = [&](const Site& site, const auto& member) {
+        SERIALIZATION_STATS_SCOPE(site, os);
+        BinarySerialization::serialize(member, os);
+    };
+    (one(member_site<Owner, I, Binary, Encode>(names), members), ...);
+}
+
+template<typename Owner, size_t... I, typename Stream, typename... Members>
+void deserialize_members_tracked_(Stream& is, const char* names, std::index_sequence<I...>, Members&... members) {
+    using namespace serialization_stats;
+    auto one = [&](const Site& site, auto& member) {
+        SERIALIZATION_STATS_SCOPE(site, is);
+        BinarySerialization::deserialize(member, is);
+    };
+    (one(member_site<Owner, I, Binary, Decode>(names), members), ...);
+}
+
+template<typename Owner, typename Stream, typename... Members>
+void serialize_members_tracked(Stream& os, const char* names, const Members&... members) {
+    serialize_members_tracked_<Owner>(os, names, std::index_sequence_for<Members...>{}, members...);
+}
+
+template<typename Owner, typename Stream, typename... Members>
+void deserialize_members_tracked(Stream& is, const char* names, Members&... members) {
+    deserialize_members_tracked_<Owner>(is, names, std::index_sequence_for<Members...>{}, members...);
+}
+#else
+#define BINARY_SERIALIZATION_MEMBERS(members, stream, ...) BinarySerialization::members(stream, __VA_ARGS__)
+#endif
+
 } // namespace BinarySerialization
 
 
@@ -0,0 +1,252 @@
+#ifndef BINARY_VARINT_H
+#define BINARY_VARINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "binary_archive.h"
+#include "binary_portable.h"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace BinarySerialization {
+
+// ========== varint / zigzag 编码 ==========
+// 长度前缀与无符号整数使用 LEB128；有符号整数先做 zigzag 再 LEB128
+inline uint64_t zigzag_encode(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+inline int64_t zigzag_decode(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+constexpr size_t kMaxVarintBytes = 10;
+
+inline size_t encode_varint(uint64_t v, char* out) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = static_cast<char>(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = static_cast<char>(v);
+    return n;
+}
+
+// 解码一个 varint，返回消耗的字节数；数据不完整或超长时返回 0。
+// 单字节值直接返回；多字节且剩余字节不少于 8 时一次加载 8 字节，用终止位掩码求长度，再无分支地拼接 7 位分组（BMI2 下用 pext）
+inline size_t decode_varint(const char* p, size_t avail, uint64_t& out) {
+    if (avail > 0 && !(static_cast<uint8_t>(p[0]) & 0x80)) {
+        out = static_cast<uint8_t>(p[0]);
+        return 1;
+    }
+#if BINARY_SERIALIZATION_LITTLE_ENDIAN
+    if (avail >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        uint64_t stops = ~word & 0x8080808080808080ULL;
+        if (stops) {
+            uint64_t x = word & (stops ^ (stops - 1));
+#if defined(__BMI2__)
+            out = _pext_u64(x, 0x7f7f7f7f7f7f7f7fULL);
+#else
+            x &= 0x7f7f7f7f7f7f7f7fULL;
+            x = ((x & 0x7f007f007f007f00ULL) >> 1) | (x & 0x007f007f007f007fULL);
+            x = ((x & 0x3fff00003fff0000ULL) >> 2) | (x & 0x00003fff00003fffULL);
+            x = ((x & 0x0fffffff00000000ULL) >> 4) | (x & 0x000000000fffffffULL);
+            out = x;
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long bit;
+            _BitScanForward64(&bit, stops);
+            return bit / 8 + 1;
+#else
+            return static_cast<size_t>(__builtin_ctzll(stops)) / 8 + 1;
+#endif
+        }
+    }
+#endif
+    uint64_t result = 0;
+    size_t limit = avail < kMaxVarintBytes ? avail : kMaxVarintBytes;
+    for (size_t i = 0; i < limit; ++i) {
+        uint8_t b = static_cast<uint8_t>(p[i]);
+        result |= static_cast<uint64_t>(b & 0x7f) << (7 * i);
+        if (!(b & 0x80)) {
+            out = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// 按 varint 编码的整数类型：除 bool 与单字节类型外的所有整数
+template<typename T>
+struct is_varint_integer
+    : std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value && (sizeof(T) > 1)> {};
+
+template<typename T>
+uint64_t to_varint_bits(T v) {
+    if constexpr (std::is_signed<T>::value) return zigzag_encode(static_cast<int64_t>(v));
+    else return static_cast<uint64_t>(v);
+}
+
+template<typename T>
+T from_varint_bits(uint64_t bits) {
+    if constexpr (std::is_signed<T>::value) return static_cast<T>(zigzag_decode(bits));
+    else return static_cast<T>(bits);
+}
+
+// 连续内存读端（BufferReader、CopyingReader）：可以直接在底层字节上解码
+template<typename S, typename = void>
+struct is_contiguous_reader : std::false_type {};
+
+template<typename S>
+struct is_contiguous_reader<S, std::void_t<decltype(std::declval<const char*&>() = std::declval<S&>().data()),
+                                           decltype(std::declval<S&>().position()),
+                                           decltype(std::declval<S&>().remaining()),
+                                           decltype(std::declval<S&>().skip(size_t()))>>
+    : std::true_type {};
+
+// ========== 紧凑模式 Archive ==========
+// 包装任意 Archive；经由它序列化时，长度前缀与整数使用 varint，浮点与单字节类型保持原样
+template<typename Out>
+class CompactWriter {
+public:
+    explicit CompactWriter(Out& out) : out_(out) {}
+
+    void write(const char* p, size_t n) { out_.write(p, n); }
+
+    void write_varint(uint64_t v) {
+        char buf[kMaxVarintBytes];
+        out_.write(buf, encode_varint(v, buf));
+    }
+
+    // 整数数组按块编码，每块一次底层 write
+    template<typename T>
+    void write_varints(const T* p, size_t n) {
+        constexpr size_t kChunk = 4096;
+        char buf[kChunk + kMaxVarintBytes];
+        size_t used = 0;
+        for (size_t i = 0; i < n; ++i) {
+            used += encode_varint(to_varint_bits(p[i]), buf + used);
+            if (used >= kChunk) {
+                out_.write(buf, used);
+                used = 0;
+            }
+        }
+        if (used) out_.write(buf, used);
+    }
+
+    Out& inner() { return out_; }
+
+private:
+    Out& out_;
+};
+
+template<typename In>
+class CompactReader {
+public:
+    explicit CompactReader(In& in) : in_(in) {}
+
+    void read(char* p, size_t n) { in_.read(p, n); }
+
+    template<typename I = In>
+    auto consume(size_t n) -> decltype(std::declval<I&>().consume(n)) { return in_.consume(n); }
+
+    uint64_t read_varint() {
+        uint64_t v = 0;
+        if constexpr (is_contiguous_reader<In>::value) {
+            size_t used = decode_varint(in_.data() + in_.position(), in_.remaining(), v);
+            if (!used) throw std::runtime_error("CompactReader: malformed varint");
+            in_.skip(used);
+        } else {
+            char buf[kMaxVarintBytes];
+            size_t i = 0;
+            do {
+                if (i == kMaxVarintBytes) throw std::runtime_error("CompactReader: malformed varint");
+                in_.read(buf + i, 1);
+            } while (static_cast<uint8_t>(buf[i++]) & 0x80);
+            decode_varint(buf, i, v);
+        }
+        return v;
+    }
+
+    // 连续的一串 varint：在底层字节上直接循环解码，单字节值走内联分支，最后一次性推进读位置
+    template<typename T>
+    void read_varints(T* out, size_t n) {
+        if constexpr (is_contiguous_reader<In>::value) {
+            const char* base = in_.data() + in_.position();
+            size_t avail = in_.remaining();
+            size_t pos = 0;
+            for (size_t i = 0; i < n; ++i) {
+                uint8_t first = pos < avail ? static_cast<uint8_t>(base[pos]) : 0x80;
+                if (first < 0x80) {
+                    out[i] = from_varint_bits<T>(first);
+                    ++pos;
+                    continue;
+                }
+                uint64_t v;
+                size_t used = decode_varint(base + pos, avail - pos, v);
+                if (!used) throw std::runtime_error("CompactReader: malformed varint");
+                out[i] = from_varint_bits<T>(v);
+                pos += used;
+            }
+            in_.skip(pos);
+        } else {
+            for (size_t i = 0; i < n; ++i) out[i] = from_varint_bits<T>(read_varint());
+        }
+    }
+
+    In& inner() { return in_; }
+
+private:
+    In& in_;
+};
+
+template<typename S>
+struct is_compact_archive : std::false_type {};
+
+template<typename Out>
+struct is_compact_archive<CompactWriter<Out>> : std::true_type {};
+
+template<typename In>
+struct is_compact_archive<CompactReader<In>> : std::true_type {};
+
+// ========== 长度前缀 ==========
+// 默认模式写原生 size_t，紧凑模式写 LEB128，可移植模式写固定 8 字节
+template<typename Stream>
+void write_length(Stream& os, size_t n) {
+    if constexpr (is_compact_archive<Stream>::value) {
+        os.write_varint(n);
+    } else if constexpr (is_portable_archive<Stream>::value) {
+        uint64_t v = n;
+        os.write_values(&v, 1);
+    } else {
+        os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    }
+}
+
+template<typename Stream>
+size_t read_length(Stream& is) {
+    if constexpr (is_compact_archive<Stream>::value) {
+        return static_cast<size_t>(is.read_varint());
+    } else if constexpr (is_portable_archive<Stream>::value) {
+        uint64_t v;
+        is.read_values(&v, 1);
+        if (v > SIZE_MAX) throw std::runtime_error("read_length: length exceeds size_t");
+        return static_cast<size_t>(v);
+    } else {
+        size_t n;
+        is.read(reinterpret_cast<char*>(&n), sizeof(n));
+        return n;
+    }
+}
+
+} // namespace BinarySerialization
+
+#endif // BINARY_VARINT_H
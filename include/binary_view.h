@@ -0,0 +1,247 @@
+#ifndef BINARY_VIEW_H
+#define BINARY_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "binary_archive.h"
+#include "binary_varint.h"
+#include "binary_dictionary.h"
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BinarySerialization {
+
+// ========== MappedFile ==========
+// 只读内存映射文件。从 reader() 反序列化出的视图（std::string_view / ArrayView）直接指向映射区，
+// 生命周期规则：视图只在 MappedFile 对象存活期间有效；MappedFile 析构或被移动赋值后，所有视图失效。
+// 移动构造不会使视图失效（映射区地址不变）。
+class MappedFile {
+public:
+    // 访问模式提示：顺序解码整个文件时内核积极预读；随机查找（索引文件）时关闭预读，只读入访问到的页
+    enum Access { Sequential, Random };
+
+    explicit MappedFile(const std::string& filename, Access access = Sequential) { open(filename, access); }
+
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+#if defined(_WIN32)
+            owned_ = std::move(other.owned_);
+#endif
+        }
+        return *this;
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    BufferReader reader() const { return BufferReader(data_, size_); }
+
+private:
+#if defined(_WIN32)
+    // 没有 POSIX mmap 时退化为整文件读入内存，接口与生命周期规则不变
+    void open(const std::string& filename, Access) {
+        std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+        if (!ifs) throw std::runtime_error("Failed to open file for reading");
+        std::streamsize size = ifs.tellg();
+        ifs.seekg(0);
+        owned_.reset(new char[size > 0 ? size : 1]);
+        if (!ifs.read(owned_.get(), size)) throw std::runtime_error("Failed to read file");
+        data_ = owned_.get();
+        size_ = static_cast<size_t>(size);
+    }
+
+    void close() {
+        owned_.reset();
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    std::unique_ptr<char[]> owned_;
+#else
+    void open(const std::string& filename, Access access) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Failed to open file for reading");
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat file");
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Failed to map file");
+            }
+            ::madvise(p, size_, access == Random ? MADV_RANDOM : MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(p);
+        }
+        ::close(fd);
+    }
+
+    void close() {
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+#endif
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// ========== ArrayView ==========
+// 指向序列化数据中一段算术元素的非拥有视图，线上格式与 std::vector<T> 相同。
+// 映射区里的元素不保证按 T 对齐，operator[] 按字节加载；data() 仅在对齐时可用。
+template<typename T>
+class ArrayView {
+    static_assert(std::is_arithmetic<T>::value, "ArrayView only supports arithmetic element types");
+
+public:
+    ArrayView() = default;
+    ArrayView(const T* data, size_t size) : bytes_(reinterpret_cast<const char*>(data)), size_(size) {}
+
+    // 从未必对齐的原始字节构造，size 为元素个数
+    static ArrayView from_bytes(const char* bytes, size_t size) { return ArrayView(BytesTag{}, bytes, size); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T operator[](size_t i) const {
+        T value;
+        std::memcpy(&value, bytes_ + i * sizeof(T), sizeof(T));
+        return value;
+    }
+
+    const char* bytes() const { return bytes_; }
+
+    bool is_aligned() const { return reinterpret_cast<std::uintptr_t>(bytes_) % alignof(T) == 0; }
+
+    const T* data() const {
+        if (!is_aligned()) throw std::runtime_error("ArrayView: data is not aligned for element type");
+        return reinterpret_cast<const T*>(bytes_);
+    }
+
+private:
+    struct BytesTag {};
+    ArrayView(BytesTag, const char* bytes, size_t size) : bytes_(bytes), size_(size) {}
+
+    const char* bytes_ = nullptr;
+    size_t size_ = 0;
+};
+
+// ========== 视图类型的序列化 ==========
+// 与 std::string / std::vector<T> 的线上格式一致，可与拥有型类型互相读写。
+// string_view 只做精确匹配，避免字符串字面量在 std::string 与 std::string_view 之间产生歧义。
+// 字典模式下读出的 string_view 指向字典项，不要求底层 Archive 支持 consume
+template<typename SV, typename Stream>
+typename std::enable_if<std::is_same<SV, std::string_view>::value && is_output_archive<Stream>::value, void>::type
+serialize(const SV& sv, Stream& os) {
+    if constexpr (is_dictionary_archive<Stream>::value) {
+        os.write_string(sv.data(), sv.size());
+    } else {
+        write_length(os, sv.size());
+        os.write(sv.data(), sv.size());
+    }
+}
+
+template<typename Stream>
+typename std::enable_if<is_view_archive<Stream>::value || lends_dictionary_views<Stream>::value, void>::type
+deserialize(std::string_view& sv, Stream& is) {
+    if constexpr (is_dictionary_archive<Stream>::value) {
+        sv = is.read_string();
+    } else {
+        size_t len = read_length(is);
+        sv = std::string_view(is.consume(len), len);
+    }
+}
+
+template<typename T, typename Stream>
+enable_if_output_t<Stream> serialize(const ArrayView<T>& v, Stream& os) {
+    static_assert(!(is_compact_archive<Stream>::value && is_varint_integer<T>::value),
+                  "ArrayView of integers is not available in compact mode");
+    write_length(os, v.size());
+    if constexpr (is_portable_archive<Stream>::value) {
+        static_assert(portable_width<T>::value == sizeof(T), "ArrayView element has a different portable width");
+        os.write_values(reinterpret_cast<const T*>(v.bytes()), v.size());
+    } else {
+        os.write(v.bytes(), v.size() * sizeof(T));
+    }
+}
+
+template<typename T, typename Stream>
+typename std::enable_if<is_view_archive<Stream>::value, void>::type
+deserialize(ArrayView<T>& v, Stream& is) {
+    static_assert(!(is_compact_archive<Stream>::value && is_varint_integer<T>::value),
+                  "ArrayView of integers is not available in compact mode");
+    size_t size = read_length(is);
+    if (size > SIZE_MAX / sizeof(T)) throw std::runtime_error("ArrayView: invalid length");
+    // 可移植模式下视图直接指向输入，只有不需要转换字节序时才可用
+    if constexpr (is_portable_archive<Stream>::value) {
+        static_assert(portable_width<T>::value == sizeof(T), "ArrayView element has a different portable width");
+        if (sizeof(T) > 1 && is.swaps()) throw std::runtime_error("ArrayView: byte order differs from the host");
+    }
+    v = ArrayView<T>::from_bytes(is.consume(size * sizeof(T)), size);
+}
+
+// 从映射文件反序列化；T 中的视图成员指向 file 的映射区
+template<typename T>
+void deserialize(T& obj, const MappedFile& file) {
+    BufferReader reader = file.reader();
+    deserialize(obj, reader);
+}
+
+// ========== 容器格式的数据段 ==========
+// 分块、列式等格式先读出各段的字节数，再在一整块数据上分段解码
+namespace detail {
+
+// 段内的内存读端：外层支持 consume 时段内的视图指向外层数据，与之同生命周期；
+// 否则数据只在解码期间有效，经由不提供 consume 的 CopyingReader 解码，视图类型的目标无法通过编译
+template<typename Stream>
+using segment_reader_t = typename std::conditional<is_view_archive<Stream>::value, BufferReader, CopyingReader>::type;
+
+// 取出接下来 total 字节的数据段：支持 consume 或本身是连续内存（CopyingReader）时不拷贝，否则读入 owned
+template<typename Stream>
+const char* take_segments(Stream& is, size_t total, std::unique_ptr<char[]>& owned) {
+    if constexpr (is_view_archive<Stream>::value) {
+        return is.consume(total);
+    } else if constexpr (is_contiguous_reader<Stream>::value) {
+        const char* base = is.data() + is.position();
+        is.skip(total);
+        return base;
+    } else {
+        owned.reset(new char[total ? total : 1]);
+        is.read(owned.get(), total);
+        return owned.get();
+    }
+}
+
+} // namespace detail
+
+} // namespace BinarySerialization
+
+#endif // BINARY_VIEW_H
@@ -0,0 +1,453 @@
+#ifndef SERIALIZATION_STATS_H
+#define SERIALIZATION_STATS_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace serialization_stats {
+
+// ========== 序列化统计 ==========
+// 按类型、按成员统计调用次数、读写字节数与累计耗时。定义 SERIALIZATION_STATS 时才插桩：
+//   - 有成员 serialize/deserialize 的类型（BINARY_SERIALIZABLE 或手写）、有成员 serialize_xml 的类型（XML_SERIALIZABLE）
+//     每次编解码记一次，名字为类型名
+//   - BINARY_SERIALIZABLE / XML_SERIALIZABLE 的每个成员单独记一次，名字为 "类型::成员"
+// 未定义时插桩宏展开为空，模板中不留任何代码；本头文件的查询接口仍可调用，结果为空。
+// 耗时与字节数都是包含式的：外层类型包含其成员及嵌套类型的开销。
+// 字节数取自 Archive 的读写位置（BufferWriter / BufferReader / SizeCounter 及其 Compact 包装），
+// 无法取得位置的 Archive（如 std::ostream）与 XML DOM 路径只统计次数与耗时。
+//
+// 次数与字节数是精确的；读时钟（每次约 20~30ns）只对每个统计点每 SERIALIZATION_STATS_SAMPLE 次调用中的一次进行，
+// 报告的耗时按 调用次数 / 计时次数 放大。定义 SERIALIZATION_STATS_SAMPLE=1 时每次都计时。
+// 每个线程写自己的计数器（无锁、无原子读改写），snapshot() 时汇总所有线程；线程退出时计数并入全局。
+//     serialization_stats::dump_table(std::cout);
+//     serialization_stats::dump_json(file, serialization_stats::ByBytes);
+#if defined(SERIALIZATION_STATS)
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+#ifndef SERIALIZATION_STATS_SAMPLE
+#define SERIALIZATION_STATS_SAMPLE 16
+#endif
+
+constexpr uint64_t kTimeSample = SERIALIZATION_STATS_SAMPLE;
+static_assert(kTimeSample > 0 && (kTimeSample & (kTimeSample - 1)) == 0, "SERIALIZATION_STATS_SAMPLE must be a power of two");
+
+enum Format { Binary, Xml };
+enum Direction { Encode, Decode };
+enum SortBy { ByTime, ByBytes, ByCalls, ByName };
+
+struct Site {
+    std::string name;
+    bool member;
+    Format format;
+    Direction direction;
+    size_t id;
+};
+
+struct Entry {
+    std::string name;
+    bool member;
+    Format format;
+    Direction direction;
+    uint64_t calls;
+    uint64_t bytes;
+    uint64_t nanos;   // 由抽样计时按调用次数放大的估计值
+};
+
+constexpr size_t kNoOffset = SIZE_MAX;
+
+namespace detail {
+
+constexpr size_t kBlockSites = 64;
+constexpr size_t kMaxBlocks = 256;
+
+struct Counters {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> nanos{0};
+    std::atomic<uint64_t> timed{0};
+};
+
+struct Block {
+    Counters sites[kBlockSites];
+};
+
+// 只有所属线程写入；用 relaxed 的 load + store 而不是 fetch_add，汇总线程可以并发读取
+inline void bump(std::atomic<uint64_t>& c, uint64_t n) {
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+struct ThreadCounters;
+
+class Registry {
+public:
+    static Registry& instance() {
+        // 有意不析构：其他线程的 thread_local 计数器可能在静态对象析构之后才退出
+        static Registry* registry = new Registry;
+        return *registry;
+    }
+
+    const Site& add(std::string name, bool member, Format format, Direction direction) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sites_.size() == kBlockSites * kMaxBlocks) {
+            std::fprintf(stderr, "serialization_stats: too many sites\n");
+            std::abort();
+        }
+        sites_.emplace_back(new Site{std::move(name), member, format, direction, sites_.size()});
+        return *sites_.back();
+    }
+
+    void attach(ThreadCounters* t) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        threads_.push_back(t);
+    }
+
+    inline void detach(ThreadCounters* t);
+    inline std::vector<Entry> collect();
+    inline void reset();
+
+private:
+    struct Totals {
+        uint64_t calls = 0;
+        uint64_t bytes = 0;
+        uint64_t nanos = 0;
+        uint64_t timed = 0;
+    };
+
+    inline void add_thread(std::vector<Totals>& totals, const ThreadCounters& t) const;
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Site>> sites_;
+    std::vector<ThreadCounters*> threads_;
+    std::vector<Totals> retired_;
+    std::vector<Totals> baseline_;
+};
+
+struct ThreadCounters {
+    std::atomic<Block*> blocks[kMaxBlocks] = {};
+    uint64_t random = 0x9e3779b97f4a7c15ull;
+
+    // xorshift；抽样与调用序号无关，避免嵌套的统计点总在同一次调用上一起计时
+    uint64_t next_random() {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+        return random;
+    }
+
+    ThreadCounters() { Registry::instance().attach(this); }
+
+    ~ThreadCounters() {
+        Registry::instance().detach(this);
+        for (auto& b : blocks) delete b.load(std::memory_order_relaxed);
+    }
+
+    Counters& at(size_t id) {
+        Block* block = blocks[id / kBlockSites].load(std::memory_order_relaxed);
+        if (!block) {
+            block = new Block;
+            blocks[id / kBlockSites].store(block, std::memory_order_release);
+        }
+        return block->sites[id % kBlockSites];
+    }
+};
+
+inline void Registry::add_thread(std::vector<Totals>& totals, const ThreadCounters& t) const {
+    for (size_t b = 0; b < kMaxBlocks; ++b) {
+        const Block* block = t.blocks[b].load(std::memory_order_acquire);
+        if (!block) continue;
+        for (size_t i = 0; i < kBlockSites && b * kBlockSites + i < totals.size(); ++i) {
+            const Counters& c = block->sites[i];
+            Totals& sum = totals[b * kBlockSites + i];
+            sum.calls += c.calls.load(std::memory_order_relaxed);
+            sum.bytes += c.bytes.load(std::memory_order_relaxed);
+            sum.nanos += c.nanos.load(std::memory_order_relaxed);
+            sum.timed += c.timed.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+inline void Registry::detach(ThreadCounters* t) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    retired_.resize(sites_.size());
+    add_thread(retired_, *t);
+    threads_.erase(std::remove(threads_.begin(), threads_.end(), t), threads_.end());
+}
+
+inline std::vector<Entry> Registry::collect() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Totals> totals = retired_;
+    totals.resize(sites_.size());
+    for (const ThreadCounters* t : threads_) add_thread(totals, *t);
+    std::vector<Entry> entries;
+    for (size_t i = 0; i < sites_.size(); ++i) {
+        Totals base = i < baseline_.size() ? baseline_[i] : Totals{};
+        uint64_t calls = totals[i].calls - base.calls;
+        if (calls == 0) continue;
+        uint64_t timed = totals[i].timed - base.timed;
+        uint64_t nanos = totals[i].nanos - base.nanos;
+        if (timed != 0 && timed != calls) nanos = static_cast<uint64_t>(static_cast<long double>(nanos) * calls / timed);
+        const Site& s = *sites_[i];
+        entries.push_back({s.name, s.member, s.format, s.direction, calls, totals[i].bytes - base.bytes, nanos});
+    }
+    return entries;
+}
+
+// 不清零各线程的计数器（其他线程可能正在写），而是记下当前总数作为基线
+inline void Registry::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Totals> totals = retired_;
+    totals.resize(sites_.size());
+    for (const ThreadCounters* t : threads_) add_thread(totals, *t);
+    baseline_ = std::move(totals);
+}
+
+inline ThreadCounters& local_counters() {
+    thread_local ThreadCounters local;
+    return local;
+}
+
+inline std::string demangle(const char* name) {
+#if defined(__GNUG__)
+    int status = 0;
+    std::unique_ptr<char, void (*)(void*)> out(abi::__cxa_demangle(name, nullptr, nullptr, &status), std::free);
+    if (status == 0 && out) return out.get();
+#endif
+    return name;
+}
+
+// 宏参数文本 "a, packed(b), c" 中第 index 个成员表达式（按顶层逗号切分，去掉首尾空白）
+inline std::string member_name(const char* names, size_t index) {
+    int depth = 0;
+    size_t current = 0;
+    std::string name;
+    for (const char* p = names; *p; ++p) {
+        if (*p == '(' || *p == '<' || *p == '[') ++depth;
+        if (*p == ')' || *p == '>' || *p == ']') --depth;
+        if (*p == ',' && depth == 0) {
+            if (current++ == index) break;
+            continue;
+        }
+        if (current == index) name += *p;
+    }
+    size_t begin = name.find_first_not_of(" \t\r\n");
+    size_t end = name.find_last_not_of(" \t\r\n");
+    return begin == std::string::npos ? name : name.substr(begin, end - begin + 1);
+}
+
+// Archive 当前的读写位置；没有可用位置时返回 kNoOffset
+template<typename S, typename = void>
+struct has_position : std::false_type {};
+template<typename S>
+struct has_position<S, std::void_t<decltype(size_t(std::declval<S&>().position()))>> : std::true_type {};
+
+template<typename S, typename = void>
+struct has_inner : std::false_type {};
+template<typename S>
+struct has_inner<S, std::void_t<decltype(std::declval<S&>().inner())>> : std::true_type {};
+
+template<typename S, typename = void>
+struct has_size : std::false_type {};
+template<typename S>
+struct has_size<S, std::void_t<decltype(size_t(std::declval<S&>().size()))>> : std::true_type {};
+
+template<typename S>
+size_t archive_offset(S& s) {
+    if constexpr (has_position<S>::value) {
+        return s.position();
+    } else if constexpr (has_inner<S>::value) {
+        return archive_offset(s.inner());
+    } else if constexpr (has_size<S>::value) {
+        return s.size();
+    } else {
+        return kNoOffset;
+    }
+}
+
+} // namespace detail
+
+template<typename T>
+std::string type_name() {
+    return detail::demangle(typeid(T).name());
+}
+
+template<typename T, Format F, Direction D>
+const Site& type_site() {
+    static const Site& site = detail::Registry::instance().add(type_name<T>(), false, F, D);
+    return site;
+}
+
+template<typename Owner, size_t I, Format F, Direction D>
+const Site& member_site(const char* names) {
+    static const Site& site =
+        detail::Registry::instance().add(type_name<Owner>() + "::" + detail::member_name(names, I), true, F, D);
+    return site;
+}
+
+// 不计入统计的 Archive（如 serialized_size 内部的计数编码），由各格式特化
+template<typename Stream>
+struct ignore_archive : std::false_type {};
+
+namespace detail {
+
+// 进入作用域时计一次调用，并决定这次是否读时钟（每个统计点的第一次调用总是计时）
+class Timer {
+public:
+    explicit Timer(const Site& site) : Timer(local_counters(), site) {}
+
+    Timer(ThreadCounters& local, const Site& site) : counters_(local.at(site.id)) {
+        uint64_t calls = counters_.calls.load(std::memory_order_relaxed);
+        counters_.calls.store(calls + 1, std::memory_order_relaxed);
+        timed_ = calls == 0 || (local.next_random() & (kTimeSample - 1)) == 0;
+        if (timed_) start_ = std::chrono::steady_clock::now();
+    }
+
+    ~Timer() {
+        if (!timed_) return;
+        auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+        bump(counters_.nanos, static_cast<uint64_t>(nanos.count()));
+        bump(counters_.timed, 1);
+    }
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+    Counters& counters_;
+
+private:
+    bool timed_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace detail
+
+// 作用域统计：析构时把 Archive 位置的变化累加为字节数
+template<typename Stream, bool Ignored = ignore_archive<Stream>::value>
+class Scope {
+public:
+    Scope(const Site& site, Stream& stream) : timer_(site), stream_(stream), offset_(detail::archive_offset(stream)) {}
+
+    ~Scope() {
+        size_t end = detail::archive_offset(stream_);
+        if (offset_ != kNoOffset && end != kNoOffset) detail::bump(timer_.counters_.bytes, end - offset_);
+    }
+
+private:
+    detail::Timer timer_;
+    Stream& stream_;
+    size_t offset_;
+};
+
+template<typename Stream>
+class Scope<Stream, true> {
+public:
+    Scope(const Site&, Stream&) {}
+};
+
+struct NoArchive {};
+
+template<>
+class Scope<NoArchive, false> {
+public:
+    explicit Scope(const Site& site) : timer_(site) {}
+
+private:
+    detail::Timer timer_;
+};
+
+// ========== 查询与输出 ==========
+// 自上次 reset() 以来被调用过的统计点
+inline std::vector<Entry> snapshot(SortBy order = ByTime) {
+    std::vector<Entry> entries = detail::Registry::instance().collect();
+    std::stable_sort(entries.begin(), entries.end(), [order](const Entry& a, const Entry& b) {
+        switch (order) {
+        case ByBytes: return a.bytes > b.bytes;
+        case ByCalls: return a.calls > b.calls;
+        case ByName: return a.name < b.name;
+        default: return a.nanos > b.nanos;
+        }
+    });
+    return entries;
+}
+
+inline void reset() { detail::Registry::instance().reset(); }
+
+inline const char* format_name(Format f) { return f == Binary ? "binary" : "xml"; }
+inline const char* direction_name(Direction d) { return d == Encode ? "encode" : "decode"; }
+
+inline void dump_table(std::ostream& os, SortBy order = ByTime) {
+    char line[512];
+    std::snprintf(line, sizeof(line), "%-6s %-6s %12s %14s %12s %10s  %s\n", "format", "dir", "calls", "bytes",
+                  "total ms", "ns/call", "type / member");
+    os << line;
+    for (const Entry& e : snapshot(order)) {
+        std::snprintf(line, sizeof(line), "%-6s %-6s %12llu %14llu %12.3f %10.1f  %s%s\n", format_name(e.format),
+                      direction_name(e.direction), static_cast<unsigned long long>(e.calls),
+                      static_cast<unsigned long long>(e.bytes), e.nanos / 1e6,
+                      static_cast<double>(e.nanos) / e.calls, e.member ? "  " : "", e.name.c_str());
+        os << line;
+    }
+}
+
+inline void write_json_string(std::ostream& os, const std::string& s) {
+    os << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            os << buf;
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+inline void dump_json(std::ostream& os, SortBy order = ByTime) {
+    os << "[";
+    bool first = true;
+    for (const Entry& e : snapshot(order)) {
+        os << (first ? "\n" : ",\n") << "  {\"name\": ";
+        write_json_string(os, e.name);
+        os << ", \"member\": " << (e.member ? "true" : "false") << ", \"format\": \"" << format_name(e.format)
+           << "\", \"direction\": \"" << direction_name(e.direction) << "\", \"calls\": " << e.calls
+           << ", \"bytes\": " << e.bytes << ", \"nanos\": " << e.nanos << "}";
+        first = false;
+    }
+    os << (first ? "]\n" : "\n]\n");
+}
+
+} // namespace serialization_stats
+
+// ========== 插桩宏 ==========
+#if defined(SERIALIZATION_STATS)
+#define SERIALIZATION_STATS_SCOPE(site, stream) \
+    ::serialization_stats::Scope<std::remove_reference_t<decltype(stream)>> serialization_stats_scope_(site, stream)
+#define SERIALIZATION_STATS_TIME_SCOPE(site) \
+    ::serialization_stats::Scope<::serialization_stats::NoArchive> serialization_stats_scope_(site)
+#else
+#define SERIALIZATION_STATS_SCOPE(site, stream) ((void)0)
+#define SERIALIZATION_STATS_TIME_SCOPE(site) ((void)0)
+#endif
+
+#endif // SERIALIZATION_STATS_H
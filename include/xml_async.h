@@ -0,0 +1,43 @@
+#ifndef XML_ASYNC_H
+#define XML_ASYNC_H
+
+#include <future>
+#include <string>
+#include <utility>
+#include "binary_async.h"
+#include "xml_serialization.h"
+
+namespace xml_serialization {
+
+// ========== 异步文件接口 ==========
+// 与 serialize_xml(obj, name, filename) 输出相同：在调用线程上构建文档并打印到池中的缓冲区，
+// 写盘（临时文件 + rename）交给 BinarySerialization::AsyncFileWriter 的后台线程
+inline void print_document(const tinyxml2::XMLDocument& doc, BinarySerialization::BufferWriter& buffer) {
+    tinyxml2::XMLPrinter printer;
+    doc.Print(&printer);
+    buffer.write(printer.CStr(), static_cast<size_t>(printer.CStrSize()) - 1);
+}
+
+template<typename T>
+std::future<void> serialize_xml_async(const T& obj, const std::string& name, const std::string& filename,
+                                      BinarySerialization::AsyncFileWriter& writer =
+                                          BinarySerialization::default_async_writer()) {
+    XmlOutputArchive archive(filename);
+    archive.save(name, obj);
+    BinarySerialization::BufferWriter buffer = writer.acquire();
+    print_document(archive.document(), buffer);
+    return writer.submit(std::move(buffer), filename);
+}
+
+// 多值文档的异步版本：代替 archive.flush()
+inline std::future<void> flush_async(XmlOutputArchive& archive, const std::string& filename,
+                                     BinarySerialization::AsyncFileWriter& writer =
+                                         BinarySerialization::default_async_writer()) {
+    BinarySerialization::BufferWriter buffer = writer.acquire();
+    print_document(archive.document(), buffer);
+    return writer.submit(std::move(buffer), filename);
+}
+
+} // namespace xml_serialization
+
+#endif // XML_ASYNC_H
@@ -0,0 +1,193 @@
+#ifndef XML_BASE64_H
+#define XML_BASE64_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+namespace xml_serialization {
+
+// ========== base64 编码 ==========
+// 标准字母表（RFC 4648），末尾用 '=' 补齐
+inline void base64_encode(const char* in, size_t n, std::string& out) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t start = out.size();
+    out.resize(start + (n + 2) / 3 * 4);
+    char* o = &out[start];
+    size_t i = 0;
+    for (; i + 3 <= n; i += 3, o += 4) {
+        uint32_t v = static_cast<uint32_t>(static_cast<uint8_t>(in[i])) << 16 |
+                     static_cast<uint32_t>(static_cast<uint8_t>(in[i + 1])) << 8 |
+                     static_cast<uint8_t>(in[i + 2]);
+        o[0] = table[v >> 18];
+        o[1] = table[(v >> 12) & 63];
+        o[2] = table[(v >> 6) & 63];
+        o[3] = table[v & 63];
+    }
+    if (i < n) {
+        uint32_t v = static_cast<uint32_t>(static_cast<uint8_t>(in[i])) << 16;
+        if (i + 1 < n) v |= static_cast<uint32_t>(static_cast<uint8_t>(in[i + 1])) << 8;
+        o[0] = table[v >> 18];
+        o[1] = table[(v >> 12) & 63];
+        o[2] = i + 1 < n ? table[(v >> 6) & 63] : '=';
+        o[3] = '=';
+    }
+}
+
+// ========== base64 解码 ==========
+// 字符到 6 位值的查找表，非字母表字符（包括 '=' 与空白）为 -1
+inline const int8_t* base64_decode_table() {
+    static const struct Table {
+        int8_t v[256];
+        Table() {
+            std::memset(v, -1, sizeof(v));
+            const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            for (int i = 0; i < 64; ++i) v[static_cast<uint8_t>(alphabet[i])] = static_cast<int8_t>(i);
+        }
+    } table;
+    return table.v;
+}
+
+// 逐组（4 字符 -> 3 字节）解码尽可能长的合法前缀，遇到非字母表字符或输出空间不足时停在该组之前。
+// 返回消耗的字符数（4 的倍数），produced 为写出的字节数
+inline size_t base64_decode_scalar(const char* in, size_t n, char* out, size_t capacity, size_t& produced) {
+    const int8_t* table = base64_decode_table();
+    size_t i = 0, o = 0;
+    for (; i + 4 <= n && o + 3 <= capacity; i += 4, o += 3) {
+        int a = table[static_cast<uint8_t>(in[i])];
+        int b = table[static_cast<uint8_t>(in[i + 1])];
+        int c = table[static_cast<uint8_t>(in[i + 2])];
+        int d = table[static_cast<uint8_t>(in[i + 3])];
+        if ((a | b | c | d) < 0) break;
+        uint32_t v = static_cast<uint32_t>(a) << 18 | static_cast<uint32_t>(b) << 12 |
+                     static_cast<uint32_t>(c) << 6 | static_cast<uint32_t>(d);
+        out[o] = static_cast<char>(v >> 16);
+        out[o + 1] = static_cast<char>(v >> 8);
+        out[o + 2] = static_cast<char>(v);
+    }
+    produced = o;
+    return i;
+}
+
+// 与 base64_decode_scalar 语义相同；SSSE3 下每次处理 16 个字符：
+// pshufb 按高/低半字节查表做合法性检查并映射到 6 位值，再用 pmaddubsw / pmaddwd 把 4 个 6 位值拼成 3 字节
+inline size_t base64_decode_quads(const char* in, size_t n, char* out, size_t capacity, size_t& produced) {
+    size_t i = 0, o = 0;
+#if defined(__SSSE3__)
+    const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask2F = _mm_set1_epi8(0x2f);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    // 每次写出 16 字节（其中 12 字节有效），所以要求输出端多留 4 字节
+    for (; i + 16 <= n && o + 16 <= capacity; i += 16, o += 12) {
+        __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(input, 4), mask2F);
+        __m128i loNibbles = _mm_and_si128(input, mask2F);
+        __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+        __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), zero)) != 0xFFFF) break;
+        __m128i eq2F = _mm_cmpeq_epi8(input, mask2F);
+        __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hiNibbles));
+        __m128i values = _mm_add_epi8(input, roll);
+        __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        __m128i words = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), _mm_shuffle_epi8(words, pack));
+    }
+#endif
+    size_t tail = 0;
+    i += base64_decode_scalar(in + i, n - i, out + o, capacity - o, tail);
+    produced = o + tail;
+    return i;
+}
+
+// 增量解码器：可以分多次喂入文本（流式读取时按缓冲区块喂入），跳过空白，处理跨块的半组与末尾填充
+class Base64Decoder {
+public:
+    Base64Decoder(char* out, size_t capacity) : out_(out), capacity_(capacity) {}
+
+    bool feed(const char* p, size_t n) {
+        size_t i = 0;
+        while (i < n && !failed_) {
+            if (carryCount_ == 0 && !padded_) {
+                size_t produced = 0;
+                i += base64_decode_quads(p + i, n - i, out_ + size_, capacity_ - size_, produced);
+                size_ += produced;
+                if (i == n) break;
+            }
+            char c = p[i++];
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r') continue;
+            if (padded_) return fail();
+            carry_[carryCount_++] = c;
+            if (carryCount_ == 4) flush_carry();
+        }
+        return !failed_;
+    }
+
+    // 所有输入都已喂入：不允许残留不完整的组
+    bool finish() const { return !failed_ && carryCount_ == 0; }
+
+    size_t size() const { return size_; }
+
+    // 调用方取走已解码的字节后，从输出缓冲区开头继续写；用固定大小的缓冲区分块解码任意长的输入
+    void reset_output() { size_ = 0; }
+
+private:
+    bool fail() {
+        failed_ = true;
+        return false;
+    }
+
+    void flush_carry() {
+        carryCount_ = 0;
+        const int8_t* table = base64_decode_table();
+        int v[4];
+        int bytes = 3;
+        for (int k = 0; k < 4; ++k) {
+            if (carry_[k] == '=' && k >= 2) {
+                if (k == 2 && carry_[3] != '=') {
+                    fail();
+                    return;
+                }
+                bytes = k - 1;
+                break;
+            }
+            v[k] = table[static_cast<uint8_t>(carry_[k])];
+            if (v[k] < 0) {
+                fail();
+                return;
+            }
+        }
+        if (size_ + bytes > capacity_) {
+            fail();
+            return;
+        }
+        uint32_t bits = static_cast<uint32_t>(v[0]) << 18 | static_cast<uint32_t>(v[1]) << 12;
+        if (bytes > 1) bits |= static_cast<uint32_t>(v[2]) << 6;
+        if (bytes > 2) bits |= static_cast<uint32_t>(v[3]);
+        out_[size_++] = static_cast<char>(bits >> 16);
+        if (bytes > 1) out_[size_++] = static_cast<char>(bits >> 8);
+        if (bytes > 2) out_[size_++] = static_cast<char>(bits);
+        padded_ = bytes < 3;
+    }
+
+    char* out_;
+    size_t capacity_;
+    size_t size_ = 0;
+    char carry_[4];
+    int carryCount_ = 0;
+    bool padded_ = false;
+    bool failed_ = false;
+};
+
+} // namespace xml_serialization
+
+#endif // XML_BASE64_H
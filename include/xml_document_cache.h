@@ -0,0 +1,260 @@
+#ifndef XML_DOCUMENT_CACHE_H
+#define XML_DOCUMENT_CACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include "xml_serialization.h"
+
+namespace xml_serialization {
+
+// ========== 解析结果缓存 ==========
+// deserialize_xml(obj, name, filename) 每次调用都重新读文件并解析整个文档。XmlDocumentCache 以路径为键
+// 保存解析好的 XmlInputArchive（文档 + 按名字的索引），再次打开时只比较文件的修改时间与大小，未变化就直接复用：
+//     XmlDocumentCache& cache = default_xml_document_cache();
+//     cache.load_all("service.xml", "limits", limits, "users", users);   // 至多解析一次
+//     deserialize_xml_cached(config, "config", "service.xml");           // 之后只有一次 stat
+// open() 返回 std::shared_ptr<const XmlInputArchive>，文件未变化时多次调用返回同一个对象，
+// 热加载循环可以比较指针判断是否需要重新应用配置。文件被替换后旧对象仍可使用，直到最后一个持有者释放。
+//
+// 线程安全：按路径哈希分成若干分片，每片一把读写锁；命中只取读锁，读文件与解析在锁外进行。
+// tinyxml2 在第一次访问节点名与文本时才就地规范化字符串（会写内存），所以发布文档之前先遍历一遍全部节点，
+// 之后多个线程并发读取同一个文档不会再写入。
+//
+// 修改时间的精度有限（内核时钟节拍、部分文件系统 1~2 秒），同一节拍内改写且大小不变的文件只看 stat 分不出来。
+// 修改时间距今不足 kRacyWindow 的缓存项视为"不确定"：每次打开都重新读文件比较内容哈希，
+// 内容不同才重新解析；文件足够旧之后恢复为只比较 stat。
+class XmlDocumentCache {
+public:
+    static constexpr size_t kShards = 16;
+    static constexpr std::chrono::seconds kRacyWindow{2};
+
+    struct Stats {
+        uint64_t hits = 0;     // 直接复用（只做了 stat，或内容哈希确认未变化）
+        uint64_t misses = 0;   // 首次打开或被淘汰后重新打开
+        uint64_t reloads = 0;  // 文件已变化，重新解析
+    };
+
+    // capacity：最多缓存的文档数，超出后淘汰各分片中最久未使用的项
+    explicit XmlDocumentCache(size_t capacity = 64)
+        : perShard_(capacity < kShards ? 1 : (capacity + kShards - 1) / kShards) {}
+
+    XmlDocumentCache(const XmlDocumentCache&) = delete;
+    XmlDocumentCache& operator=(const XmlDocumentCache&) = delete;
+
+    // 返回 filename 当前内容对应的文档；文件不存在时返回一个 loaded() 为 false 的空文档（不缓存）
+    std::shared_ptr<const XmlInputArchive> open(const std::string& filename) {
+        Stamp stamp;
+        if (!read_stamp(filename, stamp)) return missing(filename);
+        Shard& shard = shard_for(filename);
+        std::shared_ptr<const XmlInputArchive> cached;
+        uint64_t hash = 0;
+        bool verify = true;
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.entries.find(filename);
+            if (it != shard.entries.end()) {
+                touch(it->second);
+                cached = it->second.archive;
+                hash = it->second.hash;
+                verify = it->second.racy || !(it->second.stamp == stamp);
+            }
+        }
+        if (cached && !verify) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return cached;
+        }
+
+        // 新文件、stat 变化或修改时间过近：读入内容，哈希相同（例如只是 touch）仍复用原来的文档
+        std::string text;
+        if (!read_text(filename, text)) return missing(filename);
+        uint64_t textHash = std::hash<std::string_view>()(text);
+        std::shared_ptr<const XmlInputArchive> archive;
+        if (cached && textHash == hash) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            archive = cached;
+        } else {
+            (cached ? reloads_ : misses_).fetch_add(1, std::memory_order_relaxed);
+            archive = std::make_shared<const XmlInputArchive>(text.data(), text.size());
+            touch_strings(archive->document());
+        }
+
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.entries.find(filename);
+        if (it == shard.entries.end()) {
+            if (shard.entries.size() >= perShard_) evict_one(shard);
+            it = shard.entries.try_emplace(filename).first;
+        }
+        Entry& entry = it->second;
+        entry.stamp = stamp;
+        entry.archive = archive;
+        entry.hash = textHash;
+        entry.racy = is_racy(stamp);
+        touch(entry);
+        return archive;
+    }
+
+    // 从缓存的文档读取一个值；返回是否找到该名字（与 XmlInputArchive::load 相同）
+    template<typename T>
+    bool load(const std::string& filename, const std::string& name, T& value) {
+        return open(filename)->load(name, value);
+    }
+
+    // 一次读取多个值：cache.load_all(filename, "a", a, "b", b)；返回找到的个数
+    template<typename... Args>
+    size_t load_all(const std::string& filename, Args&&... namesAndValues) {
+        return open(filename)->load_all(std::forward<Args>(namesAndValues)...);
+    }
+
+    void invalidate(const std::string& filename) {
+        Shard& shard = shard_for(filename);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.entries.erase(filename);
+    }
+
+    void clear() {
+        for (Shard& shard : shards_) {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            shard.entries.clear();
+        }
+    }
+
+    size_t size() const {
+        size_t n = 0;
+        for (const Shard& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            n += shard.entries.size();
+        }
+        return n;
+    }
+
+    Stats stats() const {
+        Stats s;
+        s.hits = hits_.load(std::memory_order_relaxed);
+        s.misses = misses_.load(std::memory_order_relaxed);
+        s.reloads = reloads_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    struct Stamp {
+        std::filesystem::file_time_type mtime{};
+        uintmax_t size = 0;
+
+        bool operator==(const Stamp& other) const { return mtime == other.mtime && size == other.size; }
+    };
+
+    struct Entry {
+        Stamp stamp;
+        std::shared_ptr<const XmlInputArchive> archive;
+        uint64_t hash = 0;
+        bool racy = false;
+        std::atomic<uint64_t> lastUse{0};
+    };
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, Entry> entries;
+    };
+
+    static bool read_stamp(const std::string& filename, Stamp& stamp) {
+        std::error_code ec;
+        stamp.mtime = std::filesystem::last_write_time(filename, ec);
+        if (ec) return false;
+        stamp.size = std::filesystem::file_size(filename, ec);
+        return !ec;
+    }
+
+    static bool read_text(const std::string& filename, std::string& text) {
+        std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+        if (!ifs) return false;
+        std::streamsize size = ifs.tellg();
+        if (size < 0) return false;
+        ifs.seekg(0);
+        text.resize(static_cast<size_t>(size));
+        return static_cast<bool>(ifs.read(&text[0], size));
+    }
+
+    static bool is_racy(const Stamp& stamp) {
+        return std::filesystem::file_time_type::clock::now() - stamp.mtime < kRacyWindow;
+    }
+
+    // 访问一遍所有节点名、文本与属性，让 tinyxml2 完成延迟的字符串规范化
+    static void touch_strings(const tinyxml2::XMLDocument& doc) {
+        const tinyxml2::XMLNode* node = doc.FirstChild();
+        while (node) {
+            node->Value();
+            if (const auto* element = node->ToElement()) {
+                for (const auto* a = element->FirstAttribute(); a; a = a->Next()) {
+                    a->Name();
+                    a->Value();
+                }
+            }
+            if (node->FirstChild()) {
+                node = node->FirstChild();
+                continue;
+            }
+            while (node && !node->NextSibling()) node = node->Parent();
+            if (node) node = node->NextSibling();
+        }
+    }
+
+    std::shared_ptr<const XmlInputArchive> missing(const std::string& filename) {
+        invalidate(filename);
+        return std::make_shared<const XmlInputArchive>("", 0);
+    }
+
+    // 记录最近使用时间（毫秒）；同一毫秒内不重复写，命中路径上多个线程很少写同一缓存行
+    static void touch(Entry& entry) {
+        uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                  std::chrono::steady_clock::now().time_since_epoch())
+                                                  .count());
+        if (entry.lastUse.load(std::memory_order_relaxed) != now) entry.lastUse.store(now, std::memory_order_relaxed);
+    }
+
+    void evict_one(Shard& shard) {
+        auto victim = shard.entries.begin();
+        for (auto it = shard.entries.begin(); it != shard.entries.end(); ++it) {
+            if (it->second.lastUse.load(std::memory_order_relaxed) < victim->second.lastUse.load(std::memory_order_relaxed))
+                victim = it;
+        }
+        if (victim != shard.entries.end()) shard.entries.erase(victim);
+    }
+
+    Shard& shard_for(const std::string& filename) { return shards_[std::hash<std::string>()(filename) % kShards]; }
+
+    size_t perShard_;
+    Shard shards_[kShards];
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> reloads_{0};
+};
+
+// 进程级默认缓存（首次使用时创建，不在退出时析构）
+inline XmlDocumentCache& default_xml_document_cache() {
+    static XmlDocumentCache* cache = new XmlDocumentCache();
+    return *cache;
+}
+
+// 与 deserialize_xml(obj, name, filename) 结果相同，但文件未变化时复用已解析的文档
+template<typename T>
+bool deserialize_xml_cached(T& obj, const std::string& name, const std::string& filename,
+                            XmlDocumentCache& cache = default_xml_document_cache()) {
+    return cache.load(filename, name, obj);
+}
+
+} // namespace xml_serialization
+
+#endif // XML_DOCUMENT_CACHE_H
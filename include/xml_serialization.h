@@ -2,308 +2,492 @@
 #define XML_SERIALIZATION_H
 
 #include <tinyxml2.h>
+#include <charconv>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <list>
 #include <set>
 #include <map>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include "xml_base64.h"
+#include "serialization_stats.h"
 
 namespace xml_serialization {
 
-// ========== 用户自定义类型优先匹配 ==========
+// 每个类型都有一对"嵌套节点"重载：serialize_xml(obj, name, element) 把值写进已经创建好的 element，
+// deserialize_xml(obj, name, element) 从 element 读回（element 为空表示节点缺失）。
+// 文件接口与 XmlOutputArchive / XmlInputArchive 都建立在这组重载之上。
+
+// ========== 数值文本 ==========
+// 算术类型统一用 std::to_chars 写成最短的可往返文本，用 std::from_chars 读回；bool 与 tinyxml2 一致写成 true/false。
+// 读取时容忍前导空白与 '+'，也能读回旧版本以 printf 格式（如 "%.17g"）写出的文件
+constexpr size_t kNumberTextSize = 64;
+
 template<typename T>
-auto serialize_xml(const T& obj, const std::string& name, const std::string& filename)
-    -> decltype(obj.serialize_xml(name, filename), void()) {
-    obj.serialize_xml(name, filename);
+const char* format_number(T value, char (&buf)[kNumberTextSize]) {
+    if constexpr (std::is_same<T, bool>::value) {
+        return value ? "true" : "false";
+    } else {
+        auto result = std::to_chars(buf, buf + kNumberTextSize - 1, value);
+        *result.ptr = '\0';
+        return buf;
+    }
 }
 
 template<typename T>
-auto deserialize_xml(T& obj, const std::string& name, const std::string& filename)
-    -> decltype(obj.deserialize_xml(name, filename), void()) {
-    obj.deserialize_xml(name, filename);
+bool parse_number(const char* text, T& value) {
+    while (*text == ' ' || *text == '\t' || *text == '\n' || *text == '\r') ++text;
+    if constexpr (std::is_same<T, bool>::value) {
+        if (!std::strcmp(text, "true") || !std::strcmp(text, "1")) value = true;
+        else if (!std::strcmp(text, "false") || !std::strcmp(text, "0")) value = false;
+        else return false;
+        return true;
+    } else {
+        if (*text == '+') ++text;
+        T parsed;
+        auto result = std::from_chars(text, text + std::strlen(text), parsed);
+        if (result.ec != std::errc()) return false;
+        value = parsed;
+        return true;
+    }
 }
 
-// ========== 算术类型 ==========
+// ========== 嵌套节点：前置声明（保证嵌套容器能找到后面定义的重载） ==========
+template<typename T1, typename T2>
+void serialize_xml(const std::pair<T1, T2>& obj, const char* name, tinyxml2::XMLElement* element);
+template<typename T1, typename T2>
+void deserialize_xml(std::pair<T1, T2>& obj, const char* name, const tinyxml2::XMLElement* element);
 template<typename T>
-typename std::enable_if<std::is_arithmetic<T>::value, void>::type
-serialize_xml(const T& obj, const std::string& name, const std::string& filename) {
-    tinyxml2::XMLDocument doc;
-    auto* root = doc.NewElement("serialization");
-    doc.InsertFirstChild(root);
-    auto* element = doc.NewElement(name.c_str());
-    element->SetAttribute("val", obj);
-    root->InsertEndChild(element);
-    doc.SaveFile(filename.c_str());
+void serialize_xml(const std::vector<T>& v, const char* name, tinyxml2::XMLElement* element);
+template<typename T>
+void deserialize_xml(std::vector<T>& v, const char* name, const tinyxml2::XMLElement* element);
+template<typename T>
+void serialize_xml(const std::list<T>& l, const char* name, tinyxml2::XMLElement* element);
+template<typename T>
+void deserialize_xml(std::list<T>& l, const char* name, const tinyxml2::XMLElement* element);
+template<typename T>
+void serialize_xml(const std::set<T>& s, const char* name, tinyxml2::XMLElement* element);
+template<typename T>
+void deserialize_xml(std::set<T>& s, const char* name, const tinyxml2::XMLElement* element);
+template<typename K, typename V>
+void serialize_xml(const std::map<K, V>& m, const char* name, tinyxml2::XMLElement* element);
+template<typename K, typename V>
+void deserialize_xml(std::map<K, V>& m, const char* name, const tinyxml2::XMLElement* element);
+
+// ========== 用户自定义类型优先匹配 ==========
+// 定义 SERIALIZATION_STATS 时按类型统计次数与耗时（DOM 上没有字节位置）
+template<typename T>
+auto serialize_xml(const T& obj, const char* /*name*/, tinyxml2::XMLElement* element)
+    -> decltype(obj.serialize_xml(element), void()) {
+    SERIALIZATION_STATS_TIME_SCOPE((serialization_stats::type_site<T, serialization_stats::Xml, serialization_stats::Encode>()));
+    obj.serialize_xml(element);
 }
 
 template<typename T>
-typename std::enable_if<std::is_arithmetic<T>::value, void>::type
-deserialize_xml(T& obj, const std::string& name, const std::string& filename) {
-    tinyxml2::XMLDocument doc;
-    doc.LoadFile(filename.c_str());
-    auto* root = doc.FirstChildElement("serialization");
-    if (!root) return;
-    auto* element = root->FirstChildElement(name.c_str());
-    if (!element) return;
-    element->QueryAttribute("val", &obj);
+auto deserialize_xml(T& obj, const char* /*name*/, const tinyxml2::XMLElement* element)
+    -> decltype(obj.deserialize_xml(element), void()) {
+    SERIALIZATION_STATS_TIME_SCOPE((serialization_stats::type_site<T, serialization_stats::Xml, serialization_stats::Decode>()));
+    obj.deserialize_xml(element);
 }
 
-// ========== 算术类型 嵌套节点 ==========
+// ========== 算术类型 ==========
 template<typename T>
 typename std::enable_if<std::is_arithmetic<T>::value, void>::type
-serialize_xml(const T& obj, const char* /*name*/, tinyxml2::XMLElement* parent) {
-    parent->SetAttribute("val", obj);
+serialize_xml(const T& obj, const char* /*name*/, tinyxml2::XMLElement* element) {
+    char buf[kNumberTextSize];
+    element->SetAttribute("val", format_number(obj, buf));
 }
 
 template<typename T>
 typename std::enable_if<std::is_arithmetic<T>::value, void>::type
-deserialize_xml(T& obj, const char* /*name*/, tinyxml2::XMLElement* parent) {
-    if (!parent) return;
-    parent->QueryAttribute("val", &obj);
+deserialize_xml(T& obj, const char* /*name*/, const tinyxml2::XMLElement* element) {
+    if (!element) return;
+    if (const char* v = element->Attribute("val")) parse_number(v, obj);
 }
 
 // ========== std::string ==========
-inline void serialize_xml(const std::string& obj, const std::string& name, const std::string& filename) {
-    tinyxml2::XMLDocument doc;
-    auto* root = doc.NewElement("serialization");
-    doc.InsertFirstChild(root);
-    auto* element = doc.NewElement(name.c_str());
+inline void serialize_xml(const std::string& obj, const char* /*name*/, tinyxml2::XMLElement* element) {
     element->SetAttribute("val", obj.c_str());
-    root->InsertEndChild(element);
-    doc.SaveFile(filename.c_str());
 }
 
-inline void deserialize_xml(std::string& obj, const std::string& name, const std::string& filename) {
-    tinyxml2::XMLDocument doc;
-    doc.LoadFile(filename.c_str());
-    auto* root = doc.FirstChildElement("serialization");
-    if (!root) { obj.clear(); return; }
-    auto* element = root->FirstChildElement(name.c_str());
+inline void deserialize_xml(std::string& obj, const char* /*name*/, const tinyxml2::XMLElement* element) {
     if (!element) { obj.clear(); return; }
-    const char* value = element->Attribute("val");
-    obj = value ? value : "";
-}
-
-// ========== std::string 嵌套节点 ==========
-inline void serialize_xml(const std::string& obj, const char* /*name*/, tinyxml2::XMLElement* parent) {
-    parent->SetAttribute("val", obj.c_str());
-}
-
-inline void deserialize_xml(std::string& obj, const char* /*name*/, tinyxml2::XMLElement* parent) {
-    if (!parent) { obj.clear(); return; }
-    const char* v = parent->Attribute("val");
+    const char* v = element->Attribute("val");
     obj = v ? v : "";
 }
 
 // ========== std::pair ==========
 template<typename T1, typename T2>
-void serialize_xml(const std::pair<T1, T2>& obj, const std::string& name, const std::string& filename) {
-    tinyxml2::XMLDocument doc;
-    auto* root = doc.NewElement("serialization");
-    doc.InsertFirstChild(root);
-    auto* element = doc.NewElement(name.c_str());
-    root->InsertEndChild(element);
-
-    auto* first = doc.NewElement("first");
-    serialize_xml(obj.first, "first", first);
+void serialize_xml(const std::pair<T1, T2>& obj, const char* /*name*/, tinyxml2::XMLElement* element) {
+    auto* first = element->GetDocument()->NewElement("first");
     element->InsertEndChild(first);
+    serialize_xml(obj.first, "first", first);
 
-    auto* second = doc.NewElement("second");
-    serialize_xml(obj.second, "second", second);
+    auto* second = element->GetDocument()->NewElement("second");
     element->InsertEndChild(second);
-
-    doc.SaveFile(filename.c_str());
+    serialize_xml(obj.second, "second", second);
 }
 
 template<typename T1, typename T2>
-void deserialize_xml(std::pair<T1, T2>& obj, const std::string& name, const std::string& filename) {
-    tinyxml2::XMLDocument doc;
-    doc.LoadFile(filename.c_str());
-    auto* root = doc.FirstChildElement("serialization");
-    if (!root) return;
-    auto* element = root->FirstChildElement(name.c_str());
+void deserialize_xml(std::pair<T1, T2>& obj, const char* /*name*/, const tinyxml2::XMLElement* element) {
     if (!element) return;
+    deserialize_xml(obj.first, "first", element->FirstChildElement("first"));
+    deserialize_xml(obj.second, "second", element->FirstChildElement("second"));
+}
 
-    auto* first = element->FirstChildElement("first");
-    auto* second = element->FirstChildElement("second");
-    deserialize_xml(obj.first, "first", first);
-    deserialize_xml(obj.second, "second", second);
+// ========== 打包数组（可选） ==========
+// packed(v) 把算术类型的 std::vector 写成一个 base64 文本节点（按本机字节序的原始字节）：
+//     <name encoding="base64" count="3">AAAAAAAA8D8AAAAAAAAAQAAAAAAAAAhA</name>
+// 读取端自动识别这种格式，普通 std::vector 也能读回。packed(...) 可用于 save/load，也可以直接写在成员列表里：
+//     XML_SERIALIZABLE(id, xml_serialization::packed(samples))
+template<typename T>
+struct is_packable : std::integral_constant<bool, std::is_arithmetic<T>::value && !std::is_same<T, bool>::value> {};
+
+template<typename Vec>
+struct Packed {
+    Vec& vec;
+};
+
+template<typename T>
+Packed<std::vector<T>> packed(std::vector<T>& v) {
+    static_assert(is_packable<T>::value, "packed() only supports vectors of non-bool arithmetic types");
+    return {v};
 }
 
-// ========== std::vector ==========
 template<typename T>
-void serialize_xml(const std::vector<T>& v, const std::string& name, const std::string& filename) {
-    tinyxml2::XMLDocument doc;
-    auto* root = doc.NewElement("serialization");
-    doc.InsertFirstChild(root);
-    auto* element = doc.NewElement(name.c_str());
-    root->InsertEndChild(element);
-
-    for (const auto& item : v) {
-        auto* child = doc.NewElement("item");
-        serialize_xml(item, "item", child);
+Packed<const std::vector<T>> packed(const std::vector<T>& v) {
+    static_assert(is_packable<T>::value, "packed() only supports vectors of non-bool arithmetic types");
+    return {v};
+}
+
+inline bool is_packed_element(const char* encoding) { return encoding && !std::strcmp(encoding, "base64"); }
+
+// 按 count 预分配后直接解码到 v 的存储中；count 与数据长度不符时清空 v
+template<typename T>
+bool decode_packed(std::vector<T>& v, const char* count, const char* text) {
+    size_t n = 0;
+    size_t len = text ? std::strlen(text) : 0;
+    if (!count || !parse_number(count, n) || n > len / 4 * 3 / sizeof(T)) {
+        v.clear();
+        return false;
+    }
+    v.resize(n);
+    Base64Decoder decoder(reinterpret_cast<char*>(v.data()), n * sizeof(T));
+    if (!decoder.feed(text, len) || !decoder.finish() || decoder.size() != n * sizeof(T)) {
+        v.clear();
+        return false;
+    }
+    return true;
+}
+
+template<typename Vec>
+void serialize_xml(const Packed<Vec>& p, const char* /*name*/, tinyxml2::XMLElement* element) {
+    char buf[kNumberTextSize];
+    element->SetAttribute("encoding", "base64");
+    element->SetAttribute("count", format_number(p.vec.size(), buf));
+    if (p.vec.empty()) return;
+    std::string text;
+    base64_encode(reinterpret_cast<const char*>(p.vec.data()), p.vec.size() * sizeof(p.vec[0]), text);
+    element->SetText(text.c_str());
+}
+
+template<typename Vec>
+void deserialize_xml(Packed<Vec>& p, const char* name, const tinyxml2::XMLElement* element) {
+    deserialize_xml(p.vec, name, element);
+}
+
+// ========== std::vector / std::list / std::set ==========
+// 每个元素一个 <item> 子节点
+template<typename Container>
+void serialize_items(const Container& c, tinyxml2::XMLElement* element) {
+    for (const auto& item : c) {
+        auto* child = element->GetDocument()->NewElement("item");
         element->InsertEndChild(child);
+        serialize_xml(item, "item", child);
     }
-    doc.SaveFile(filename.c_str());
 }
 
 template<typename T>
-void deserialize_xml(std::vector<T>& v, const std::string& name, const std::string& filename) {
-    tinyxml2::XMLDocument doc;
-    doc.LoadFile(filename.c_str());
-    auto* root = doc.FirstChildElement("serialization");
-    if (!root) return;
-    auto* element = root->FirstChildElement(name.c_str());
+void serialize_xml(const std::vector<T>& v, const char* /*name*/, tinyxml2::XMLElement* element) {
+    serialize_items(v, element);
+}
+
+template<typename T>
+void deserialize_xml(std::vector<T>& v, const char* /*name*/, const tinyxml2::XMLElement* element) {
     if (!element) return;
+    if constexpr (is_packable<T>::value) {
+        if (is_packed_element(element->Attribute("encoding"))) {
+            decode_packed(v, element->Attribute("count"), element->GetText());
+            return;
+        }
+    }
     v.clear();
     for (auto* child = element->FirstChildElement("item"); child; child = child->NextSiblingElement("item")) {
-        T item;
-        deserialize_xml(item, "item", child);
-        v.push_back(item);
+        v.emplace_back();
+        deserialize_xml(v.back(), "item", child);
     }
 }
 
-// ========== std::list ==========
 template<typename T>
-void serialize_xml(const std::list<T>& l, const std::string& name, const std::string& filename) {
-    std::vector<T> v(l.begin(), l.end());
-    serialize_xml(v, name, filename);
+void serialize_xml(const std::list<T>& l, const char* /*name*/, tinyxml2::XMLElement* element) {
+    serialize_items(l, element);
 }
 
 template<typename T>
-void deserialize_xml(std::list<T>& l, const std::string& name, const std::string& filename) {
-    std::vector<T> v;
-    deserialize_xml(v, name, filename);
-    l.assign(v.begin(), v.end());
+void deserialize_xml(std::list<T>& l, const char* /*name*/, const tinyxml2::XMLElement* element) {
+    if (!element) return;
+    l.clear();
+    for (auto* child = element->FirstChildElement("item"); child; child = child->NextSiblingElement("item")) {
+        l.emplace_back();
+        deserialize_xml(l.back(), "item", child);
+    }
 }
 
-// ========== std::set ==========
 template<typename T>
-void serialize_xml(const std::set<T>& s, const std::string& name, const std::string& filename) {
-    std::vector<T> v(s.begin(), s.end());
-    serialize_xml(v, name, filename);
+void serialize_xml(const std::set<T>& s, const char* /*name*/, tinyxml2::XMLElement* element) {
+    serialize_items(s, element);
 }
 
 template<typename T>
-void deserialize_xml(std::set<T>& s, const std::string& name, const std::string& filename) {
-    std::vector<T> v;
-    deserialize_xml(v, name, filename);
+void deserialize_xml(std::set<T>& s, const char* /*name*/, const tinyxml2::XMLElement* element) {
+    if (!element) return;
     s.clear();
-    s.insert(v.begin(), v.end());
+    for (auto* child = element->FirstChildElement("item"); child; child = child->NextSiblingElement("item")) {
+        T item;
+        deserialize_xml(item, "item", child);
+        s.emplace_hint(s.end(), std::move(item));
+    }
 }
 
 // ========== std::map ==========
+// 每个键值对一个 <item>，其下分别是 <key> 与 <value>
 template<typename K, typename V>
-void serialize_xml(const std::map<K, V>& m, const std::string& name, const std::string& filename) {
-    tinyxml2::XMLDocument doc;
-    auto* root = doc.NewElement("serialization");
-    doc.InsertFirstChild(root);
-    auto* element = doc.NewElement(name.c_str());
-    root->InsertEndChild(element);
-
+void serialize_xml(const std::map<K, V>& m, const char* /*name*/, tinyxml2::XMLElement* element) {
+    auto* doc = element->GetDocument();
     for (const auto& kv : m) {
-        auto* child = doc.NewElement("item");
-        serialize_xml(kv.first, "key", child);
-        serialize_xml(kv.second, "value", child);
+        auto* child = doc->NewElement("item");
         element->InsertEndChild(child);
+        auto* keyElem = doc->NewElement("key");
+        child->InsertEndChild(keyElem);
+        serialize_xml(kv.first, "key", keyElem);
+        auto* valueElem = doc->NewElement("value");
+        child->InsertEndChild(valueElem);
+        serialize_xml(kv.second, "value", valueElem);
     }
-    doc.SaveFile(filename.c_str());
 }
 
 template<typename K, typename V>
-void deserialize_xml(std::map<K, V>& m, const std::string& name, const std::string& filename) {
-    tinyxml2::XMLDocument doc;
-    doc.LoadFile(filename.c_str());
-    auto* root = doc.FirstChildElement("serialization");
-    if (!root) return;
-    auto* element = root->FirstChildElement(name.c_str());
+void deserialize_xml(std::map<K, V>& m, const char* /*name*/, const tinyxml2::XMLElement* element) {
     if (!element) return;
     m.clear();
     for (auto* child = element->FirstChildElement("item"); child; child = child->NextSiblingElement("item")) {
         K key;
-        V value;
-        auto* keyElem = child->FirstChildElement("key");
-        auto* valueElem = child->FirstChildElement("value");
-        deserialize_xml(key, "key", keyElem);
-        deserialize_xml(value, "value", valueElem);
-        m.emplace(std::move(key), std::move(value));
+        deserialize_xml(key, "key", child->FirstChildElement("key"));
+        auto it = m.emplace_hint(m.end(), std::piecewise_construct,
+                                 std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
+        deserialize_xml(it->second, "value", child->FirstChildElement("value"));
     }
 }
 
-// ========== 递归成员展开声明（提前声明） ==========
-template<typename T>
-void serialize_member(tinyxml2::XMLDocument& doc, tinyxml2::XMLElement* parent, const T& value);
-
-template<typename T>
-void deserialize_member(tinyxml2::XMLElement* parent, T& value);
+// ========== 用户自定义类型的成员展开 ==========
+// XML_SERIALIZABLE 生成的 xml_fields(f) 按声明顺序对每个成员调用 f，供流式读写等不经过 DOM 的路径使用
+template<typename F, typename... Fields>
+void apply_fields(F& f, Fields&&... fields) {
+    (f(fields), ...);
+}
 
-inline void serialize_members(tinyxml2::XMLDocument&, tinyxml2::XMLElement*) {}
+// 每个成员按声明顺序写成一个 <field> 子节点
+inline void serialize_members(tinyxml2::XMLElement*) {}
 
 template<typename First, typename... Rest>
-void serialize_members(tinyxml2::XMLDocument& doc, tinyxml2::XMLElement* parent, const First& first, const Rest&... rest) {
-    serialize_member(doc, parent, first);
-    serialize_members(doc, parent, rest...);
+void serialize_members(tinyxml2::XMLElement* parent, const First& first, const Rest&... rest) {
+    auto* field = parent->GetDocument()->NewElement("field");
+    parent->InsertEndChild(field);
+    serialize_xml(first, "field", field);
+    serialize_members(parent, rest...);
 }
 
-inline void deserialize_members(tinyxml2::XMLElement*) {}
+// field 指向当前成员对应的 <field>，依次沿兄弟节点前进
+inline void deserialize_members(const tinyxml2::XMLElement*) {}
 
+// 成员列表里可以出现 packed(...) 这样的临时包装对象，所以按转发引用接收
 template<typename First, typename... Rest>
-void deserialize_members(tinyxml2::XMLElement* parent, First& first, Rest&... rest) {
-    deserialize_member(parent, first);
-    deserialize_members(parent, rest...);
+void deserialize_members(const tinyxml2::XMLElement* field, First&& first, Rest&&... rest) {
+    deserialize_xml(first, "field", field);
+    deserialize_members(field ? field->NextSiblingElement("field") : nullptr, rest...);
 }
 
-template<typename T>
-void serialize_member(tinyxml2::XMLDocument& doc, tinyxml2::XMLElement* parent, const T& value) {
-    auto* elem = doc.NewElement("field");
-    if constexpr (std::is_arithmetic<T>::value) {
-        elem->SetAttribute("val", value);
-    } else if constexpr (std::is_same<T, std::string>::value) {
-        elem->SetAttribute("val", value.c_str());
-    } else {
-        serialize_members(doc, elem, value);
+// 定义 SERIALIZATION_STATS 时成员逐个计时，统计名取自宏参数文本
+#if defined(SERIALIZATION_STATS)
+template<typename Owner, size_t... I, typename... Members>
+void serialize_members_tracked_(tinyxml2::XMLElement* parent, const char* names, std::index_sequence<I...>,
+                                const Members&... members) {
+    using namespace serialization_stats;
+    auto one = [&](const Site& site, const auto& member) {
+        SERIALIZATION_STATS_TIME_SCOPE(site);
+        serialize_members(parent, member);
+    };
+    (one(member_site<Owner, I, Xml, Encode>(names), members), ...);
+}
+
+template<typename Owner, size_t... I, typename... Members>
+void deserialize_members_tracked_(const tinyxml2::XMLElement* field, const char* names, std::index_sequence<I...>,
+                                  Members&&... members) {
+    using namespace serialization_stats;
+    auto one = [&](const Site& site, auto& member) {
+        {
+            SERIALIZATION_STATS_TIME_SCOPE(site);
+            deserialize_xml(member, "field", field);
+        }
+        field = field ? field->NextSiblingElement("field") : nullptr;
+    };
+    (one(member_site<Owner, I, Xml, Decode>(names), members), ...);
+}
+
+template<typename Owner, typename... Members>
+void serialize_members_tracked(tinyxml2::XMLElement* parent, const char* names, const Members&... members) {
+    serialize_members_tracked_<Owner>(parent, names, std::index_sequence_for<Members...>{}, members...);
+}
+
+template<typename Owner, typename... Members>
+void deserialize_members_tracked(const tinyxml2::XMLElement* field, const char* names, Members&&... members) {
+    deserialize_members_tracked_<Owner>(field, names, std::index_sequence_for<Members...>{},
+                                        std::forward<Members>(members)...);
+}
+
+#define XML_SERIALIZATION_MEMBERS(members, node, ...) \
+    xml_serialization::members##_tracked<std::remove_cv_t<std::remove_reference_t<decltype(*this)>>>( \
+        node, #__VA_ARGS__, __VA_ARGS__)
+#else
+#define XML_SERIALIZATION_MEMBERS(members, node, ...) xml_serialization::members(node, __VA_ARGS__)
+#endif
+
+// ========== 多值文档 ==========
+// 一个文档里保存任意多个命名值，最后只写一次文件：
+//     XmlOutputArchive out("config.xml");
+//     out.save("limits", limits).save("users", users);
+//     out.flush();
+class XmlOutputArchive {
+public:
+    explicit XmlOutputArchive(const std::string& filename) : filename_(filename) {
+        root_ = doc_.NewElement("serialization");
+        doc_.InsertFirstChild(root_);
     }
-    parent->InsertEndChild(elem);
+
+    template<typename T>
+    XmlOutputArchive& save(const std::string& name, const T& value) {
+        auto* element = doc_.NewElement(name.c_str());
+        root_->InsertEndChild(element);
+        serialize_xml(value, name.c_str(), element);
+        return *this;
+    }
+
+    bool flush() { return doc_.SaveFile(filename_.c_str()) == tinyxml2::XML_SUCCESS; }
+
+    tinyxml2::XMLDocument& document() { return doc_; }
+
+private:
+    std::string filename_;
+    tinyxml2::XMLDocument doc_;
+    tinyxml2::XMLElement* root_;
+};
+
+// 只解析一次文件，按名字建立索引后可读取任意多个值；同名节点以第一个为准
+class XmlInputArchive {
+public:
+    explicit XmlInputArchive(const std::string& filename) {
+        doc_.LoadFile(filename.c_str());
+        build_index();
+    }
+
+    // 从内存中的文档文本解析（XmlDocumentCache 读入文件后用它解析）
+    XmlInputArchive(const char* text, size_t size) {
+        doc_.Parse(text, size);
+        build_index();
+    }
+
+    bool loaded() const { return loaded_; }
+
+    bool contains(const std::string& name) const { return index_.count(name) != 0; }
+
+    // 返回是否找到该名字；找不到时按各类型的缺失规则处理 value
+    template<typename T>
+    bool load(const std::string& name, T& value) const {
+        auto it = index_.find(name);
+        const tinyxml2::XMLElement* element = it == index_.end() ? nullptr : it->second;
+        deserialize_xml(value, name.c_str(), element);
+        return element != nullptr;
+    }
+
+    // 一次读取多个值：archive.load_all("limits", limits, "users", users)；返回找到的个数
+    template<typename T, typename... Rest>
+    size_t load_all(const std::string& name, T& value, Rest&&... rest) const {
+        static_assert(sizeof...(Rest) % 2 == 0, "load_all expects name/value pairs");
+        size_t found = load(name, value) ? 1 : 0;
+        if constexpr (sizeof...(Rest) > 0) found += load_all(std::forward<Rest>(rest)...);
+        return found;
+    }
+
+    const tinyxml2::XMLDocument& document() const { return doc_; }
+
+private:
+    void build_index() {
+        const auto* root = doc_.FirstChildElement("serialization");
+        if (!root) return;
+        loaded_ = true;
+        for (auto* element = root->FirstChildElement(); element; element = element->NextSiblingElement()) {
+            index_.emplace(element->Name(), element);
+        }
+    }
+
+    tinyxml2::XMLDocument doc_;
+    std::unordered_map<std::string, const tinyxml2::XMLElement*> index_;
+    bool loaded_ = false;
+};
+
+// ========== 文件接口 ==========
+// 单值文件：<serialization><name>...</name></serialization>
+template<typename T>
+void serialize_xml(const T& obj, const std::string& name, const std::string& filename) {
+    XmlOutputArchive archive(filename);
+    archive.save(name, obj);
+    archive.flush();
 }
 
 template<typename T>
-void deserialize_member(tinyxml2::XMLElement* parent, T& value) {
-    if (!parent) return;
-    auto* elem = parent->FirstChildElement("field");
-    if (!elem) return;
-    if constexpr (std::is_arithmetic<T>::value) {
-        elem->QueryAttribute("val", &value);
-    } else if constexpr (std::is_same<T, std::string>::value) {
-        const char* v = elem->Attribute("val");
-        value = v ? v : "";
-    } else {
-        deserialize_members(elem, value);
-    }
+void deserialize_xml(T& obj, const std::string& name, const std::string& filename) {
+    XmlInputArchive archive(filename);
+    archive.load(name, obj);
 }
 
 // ========== 用户自定义类型宏 ==========
 #define XML_SERIALIZABLE(...) \
+    template<typename XmlFieldVisitor> \
+    void xml_fields(XmlFieldVisitor&& xml_field_visitor_) const { \
+        xml_serialization::apply_fields(xml_field_visitor_, __VA_ARGS__); \
+    } \
+    template<typename XmlFieldVisitor> \
+    void xml_fields(XmlFieldVisitor&& xml_field_visitor_) { \
+        xml_serialization::apply_fields(xml_field_visitor_, __VA_ARGS__); \
+    } \
+    void serialize_xml(tinyxml2::XMLElement* element) const { \
+        XML_SERIALIZATION_MEMBERS(serialize_members, element, __VA_ARGS__); \
+    } \
+    void deserialize_xml(const tinyxml2::XMLElement* element) { \
+        XML_SERIALIZATION_MEMBERS(deserialize_members, element ? element->FirstChildElement("field") : nullptr, \
+                                  __VA_ARGS__); \
+    } \
     void serialize_xml(const std::string& name, const std::string& filename) const { \
-        tinyxml2::XMLDocument doc; \
-        auto* root = doc.NewElement("serialization"); \
-        doc.InsertFirstChild(root); \
-        auto* element = doc.NewElement(name.c_str()); \
-        root->InsertEndChild(element); \
-        xml_serialization::serialize_members(doc, element, __VA_ARGS__); \
-        doc.SaveFile(filename.c_str()); \
+        xml_serialization::serialize_xml(*this, name, filename); \
     } \
     void deserialize_xml(const std::string& name, const std::string& filename) { \
-        tinyxml2::XMLDocument doc; \
-        doc.LoadFile(filename.c_str()); \
-        auto* root = doc.FirstChildElement("serialization"); \
-        if (!root) return; \
-        auto* element = root->FirstChildElement(name.c_str()); \
-        if (!element) return; \
-        xml_serialization::deserialize_members(element, __VA_ARGS__); \
+        xml_serialization::deserialize_xml(*this, name, filename); \
     }
 
 } // namespace xml_serialization
 
-#endif // XML_SERIALIZATION_H
\ No newline at end of file
+#endif // XML_SERIALIZATION_H
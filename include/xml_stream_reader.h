@@ -0,0 +1,554 @@
+#ifndef XML_STREAM_READER_H
+#define XML_STREAM_READER_H
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "xml_serialization.h"
+
+namespace xml_serialization {
+
+// 流式读取：不构建 XMLDocument，按块读文件并逐个产出元素事件，边解析边填充对象。
+// 内存占用只与最长的单个标签和嵌套深度有关，与文件大小无关。
+// 读取规则与 DOM 路径一致：只认 <item>/<key>/<value>/<first>/<second>/<field> 子节点，其余子节点跳过；
+// 节点缺失时按 deserialize_xml(obj, name, nullptr) 的规则处理。
+
+// ========== XmlPullReader ==========
+// 最小的拉取式 XML 分词器：只产出开始/结束标签事件，文本、注释、声明、CDATA 一律跳过；
+// 自闭合标签 <a/> 产出一对 StartElement / EndElement。属性值会做实体解码与换行规范化。
+class XmlPullReader {
+public:
+    enum Event { StartElement, EndElement, EndDocument };
+
+    explicit XmlPullReader(const std::string& filename, size_t chunkBytes = 64 * 1024)
+        : file_(std::fopen(filename.c_str(), "rb")), owned_(chunkBytes), chunk_(chunkBytes) {
+        data_ = owned_.data();
+        if (!file_) error_ = true;
+    }
+
+    // 内存输入：data 在读取期间必须保持有效
+    static XmlPullReader from_buffer(const char* data, size_t size) { return XmlPullReader(BufferTag{}, data, size); }
+
+    ~XmlPullReader() {
+        if (file_) std::fclose(file_);
+    }
+
+    XmlPullReader(const XmlPullReader&) = delete;
+    XmlPullReader& operator=(const XmlPullReader&) = delete;
+
+    // 前进到下一个开始或结束标签；到达文件尾或遇到格式错误时返回 false
+    bool next() {
+        if (pendingEnd_) {
+            pendingEnd_ = false;
+            event_ = EndElement;
+            return true;
+        }
+        while (true) {
+            size_t lt = find("<", true);
+            if (lt == npos) return finish();
+            pos_ = lt;
+            if (!available(2)) return finish();
+            char c = data_[pos_ + 1];
+            if (c == '?') {
+                if (!skip_past("?>")) return finish();
+            } else if (c == '!') {
+                if (!available(4)) return finish();
+                if (std::memcmp(data_ + pos_, "<!--", 4) == 0) {
+                    if (!skip_past("-->")) return finish();
+                } else if (available(9) && std::memcmp(data_ + pos_, "<![CDATA[", 9) == 0) {
+                    if (!skip_past("]]>")) return finish();
+                } else if (!skip_past(">")) {
+                    return finish();
+                }
+            } else if (c == '/') {
+                size_t gt = find(">", false);
+                if (gt == npos) return finish();
+                const char* p = data_ + pos_ + 2;
+                const char* e = data_ + gt;
+                while (e > p && is_space(e[-1])) --e;
+                name_.assign(p, e);
+                pos_ = gt + 1;
+                event_ = EndElement;
+                return true;
+            } else {
+                return parse_start_tag();
+            }
+        }
+    }
+
+    Event event() const { return event_; }
+    const std::string& name() const { return name_; }
+    bool error() const { return error_; }
+    // 文件输入时内部缓冲区的大小，不随跳过的文本长度增长
+    size_t buffer_size() const { return owned_.size(); }
+
+    // 当前开始标签上的属性值（已解码）；不存在时返回 nullptr
+    const char* attribute(const char* name) const {
+        for (size_t i = 0; i < attrCount_; ++i) {
+            if (attrs_[i].first == name) return attrs_[i].second.c_str();
+        }
+        return nullptr;
+    }
+
+    // 当前位于 StartElement 时，跳过该元素的全部内容，直到消费掉与之匹配的 EndElement
+    void skip() {
+        size_t depth = 0;
+        while (next()) {
+            if (event_ == StartElement) {
+                ++depth;
+            } else if (depth-- == 0) {
+                return;
+            }
+        }
+    }
+
+    // 当前位于 StartElement 时，把到下一个标签为止的原始文本（不做实体解码）按缓冲区块交给 sink(const char*, size_t)；
+    // 之后仍需 skip() 消费结束标签
+    template<typename Sink>
+    void read_text(Sink&& sink) {
+        if (pendingEnd_) return;
+        while (true) {
+            size_t i = pos_;
+            while (i < end_ && data_[i] != '<') ++i;
+            if (i > pos_) sink(data_ + pos_, i - pos_);
+            pos_ = i;
+            if (i < end_ || !refill()) return;
+        }
+    }
+
+private:
+    struct BufferTag {};
+    XmlPullReader(BufferTag, const char* data, size_t size) : data_(data), end_(size) {}
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    static bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    bool finish() {
+        event_ = EndDocument;
+        return false;
+    }
+
+    // 把未消费的数据移到缓冲区开头，再从文件读入一块；缓冲区已满时扩容
+    bool refill() {
+        if (!file_) return false;
+        if (pos_ > 0) {
+            std::memmove(owned_.data(), owned_.data() + pos_, end_ - pos_);
+            end_ -= pos_;
+            pos_ = 0;
+        }
+        if (end_ + chunk_ > owned_.size()) owned_.resize(end_ + chunk_);
+        data_ = owned_.data();
+        size_t n = std::fread(owned_.data() + end_, 1, chunk_, file_);
+        end_ += n;
+        return n > 0;
+    }
+
+    bool available(size_t n) {
+        while (end_ - pos_ < n) {
+            if (!refill()) return false;
+        }
+        return true;
+    }
+
+    // 从 pos_ 开始查找 delim，返回其在缓冲区中的下标；必要时继续读文件。
+    // discard 表示调用方不需要 delim 之前的内容：每次 refill 前丢弃已扫描的字节，只保留可能是 delim 前缀的末尾 len-1 个，
+    // 跳过很长的文本或注释时缓冲区不会随之增长
+    size_t find(const char* delim, bool discard) {
+        size_t len = std::strlen(delim);
+        size_t from = pos_;
+        while (true) {
+            for (size_t i = from; i + len <= end_; ++i) {
+                if (data_[i] == delim[0] && std::memcmp(data_ + i, delim, len) == 0) return i;
+            }
+            if (discard && end_ - pos_ >= len) pos_ = end_ - (len - 1);
+            size_t scanned = end_ - pos_;
+            if (!refill()) return npos;
+            from = pos_ + (scanned >= len ? scanned - len + 1 : 0);
+        }
+    }
+
+    bool skip_past(const char* delim) {
+        size_t at = find(delim, true);
+        if (at == npos) return false;
+        pos_ = at + std::strlen(delim);
+        return true;
+    }
+
+    // 解析 <name a="v" ...> 或 <name .../>；属性值中可以出现 '>'，所以按引号扫描
+    bool parse_start_tag() {
+        size_t i = pos_ + 1;
+        char quote = 0;
+        while (true) {
+            if (i >= end_) {
+                size_t offset = i - pos_;
+                if (!refill()) return fail();
+                i = pos_ + offset;
+                continue;
+            }
+            char c = data_[i];
+            if (quote) {
+                if (c == quote) quote = 0;
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '>') {
+                break;
+            }
+            ++i;
+        }
+        const char* p = data_ + pos_ + 1;
+        const char* e = data_ + i;
+        pos_ = i + 1;
+        bool selfClosing = e > p && e[-1] == '/';
+        if (selfClosing) --e;
+
+        const char* n = p;
+        while (p < e && !is_space(*p)) ++p;
+        if (p == n) return fail();
+        name_.assign(n, p);
+
+        attrCount_ = 0;
+        while (true) {
+            while (p < e && is_space(*p)) ++p;
+            if (p == e) break;
+            const char* an = p;
+            while (p < e && *p != '=' && !is_space(*p)) ++p;
+            const char* ae = p;
+            while (p < e && is_space(*p)) ++p;
+            if (p == e || *p != '=') return fail();
+            ++p;
+            while (p < e && is_space(*p)) ++p;
+            if (p == e || (*p != '"' && *p != '\'')) return fail();
+            char q = *p++;
+            const char* vb = p;
+            while (p < e && *p != q) ++p;
+            if (p == e) return fail();
+            if (attrCount_ == attrs_.size()) attrs_.emplace_back();
+            auto& attr = attrs_[attrCount_++];
+            attr.first.assign(an, ae);
+            decode(vb, p, attr.second);
+            ++p;
+        }
+
+        event_ = StartElement;
+        pendingEnd_ = selfClosing;
+        return true;
+    }
+
+    bool fail() {
+        error_ = true;
+        return finish();
+    }
+
+    static void append_utf8(unsigned long cp, std::string& out) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    // 与 tinyxml2 的属性值处理一致：解码预定义实体与字符引用，\r\n 与 \r 规范化为 \n；无法识别的实体原样保留
+    static void decode(const char* p, const char* e, std::string& out) {
+        out.clear();
+        while (p < e) {
+            char c = *p;
+            if (c == '\r') {
+                out += '\n';
+                p += (p + 1 < e && p[1] == '\n') ? 2 : 1;
+                continue;
+            }
+            if (c != '&') {
+                out += c;
+                ++p;
+                continue;
+            }
+            const char* semi = static_cast<const char*>(std::memchr(p, ';', e - p));
+            if (!semi) {
+                out.append(p, e);
+                return;
+            }
+            std::string entity(p + 1, semi);
+            if (entity == "lt") out += '<';
+            else if (entity == "gt") out += '>';
+            else if (entity == "amp") out += '&';
+            else if (entity == "quot") out += '"';
+            else if (entity == "apos") out += '\'';
+            else if (entity.size() > 1 && entity[0] == '#') {
+                bool hex = entity[1] == 'x' || entity[1] == 'X';
+                append_utf8(std::strtoul(entity.c_str() + (hex ? 2 : 1), nullptr, hex ? 16 : 10), out);
+            } else {
+                out.append(p, semi + 1);
+            }
+            p = semi + 1;
+        }
+    }
+
+    std::FILE* file_ = nullptr;
+    std::vector<char> owned_;
+    size_t chunk_ = 0;
+    const char* data_ = nullptr;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+
+    Event event_ = EndDocument;
+    std::string name_;
+    std::vector<std::pair<std::string, std::string>> attrs_;
+    size_t attrCount_ = 0;
+    bool pendingEnd_ = false;
+    bool error_ = false;
+};
+
+// read_xml(obj, reader) 约定：调用前 reader 停在该值节点的 StartElement，返回时已消费与之匹配的 EndElement
+
+// ========== 前置声明 ==========
+template<typename T1, typename T2>
+void read_xml(std::pair<T1, T2>& obj, XmlPullReader& reader);
+template<typename T>
+void read_xml(std::vector<T>& v, XmlPullReader& reader);
+template<typename T>
+void read_xml(std::list<T>& l, XmlPullReader& reader);
+template<typename T>
+void read_xml(std::set<T>& s, XmlPullReader& reader);
+template<typename K, typename V>
+void read_xml(std::map<K, V>& m, XmlPullReader& reader);
+template<typename Vec>
+void read_xml(Packed<Vec>& p, XmlPullReader& reader);
+
+// 依次把后续的 <field> 子节点读入各成员；子节点用完后剩余成员按缺失处理
+struct FieldReader {
+    XmlPullReader& reader;
+    bool open = true;
+
+    template<typename Field>
+    void operator()(Field& field);
+};
+
+// 对当前节点的每个子元素调用 f(name)；f 必须消费该子元素（读取或 reader.skip()）
+template<typename F>
+void for_each_child(XmlPullReader& reader, F&& f) {
+    while (reader.next() && reader.event() == XmlPullReader::StartElement) {
+        f(reader.name());
+    }
+}
+
+// ========== 用户自定义类型（XML_SERIALIZABLE） ==========
+template<typename T>
+auto read_xml(T& obj, XmlPullReader& reader) -> decltype(obj.xml_fields(std::declval<FieldReader&>()), void()) {
+    FieldReader fields{reader};
+    obj.xml_fields(fields);
+    if (fields.open) for_each_child(reader, [&](const std::string&) { reader.skip(); });
+}
+
+// ========== 算术类型 ==========
+template<typename T>
+typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+read_xml(T& obj, XmlPullReader& reader) {
+    if (const char* v = reader.attribute("val")) parse_number(v, obj);
+    reader.skip();
+}
+
+// ========== std::string ==========
+inline void read_xml(std::string& obj, XmlPullReader& reader) {
+    const char* v = reader.attribute("val");
+    obj = v ? v : "";
+    reader.skip();
+}
+
+// ========== std::pair ==========
+template<typename T1, typename T2>
+void read_xml(std::pair<T1, T2>& obj, XmlPullReader& reader) {
+    bool first = false, second = false;
+    for_each_child(reader, [&](const std::string& name) {
+        if (!first && name == "first") {
+            read_xml(obj.first, reader);
+            first = true;
+        } else if (!second && name == "second") {
+            read_xml(obj.second, reader);
+            second = true;
+        } else {
+            reader.skip();
+        }
+    });
+    if (!first) deserialize_xml(obj.first, "first", nullptr);
+    if (!second) deserialize_xml(obj.second, "second", nullptr);
+}
+
+// ========== std::vector / std::list / std::set ==========
+// 打包格式：按 count 预分配，文本按块直接解码进 v 的存储
+template<typename T>
+void read_packed(std::vector<T>& v, XmlPullReader& reader) {
+    size_t n = 0;
+    const char* count = reader.attribute("count");
+    bool ok = count && parse_number(count, n);
+    if (ok) {
+        v.resize(n);
+        Base64Decoder decoder(reinterpret_cast<char*>(v.data()), n * sizeof(T));
+        reader.read_text([&](const char* p, size_t len) { ok = ok && decoder.feed(p, len); });
+        ok = ok && decoder.finish() && decoder.size() == n * sizeof(T);
+    }
+    if (!ok) v.clear();
+    reader.skip();
+}
+
+template<typename Vec>
+void read_xml(Packed<Vec>& p, XmlPullReader& reader) {
+    read_xml(p.vec, reader);
+}
+
+template<typename T>
+void read_xml(std::vector<T>& v, XmlPullReader& reader) {
+    if constexpr (is_packable<T>::value) {
+        if (is_packed_element(reader.attribute("encoding"))) return read_packed(v, reader);
+    }
+    v.clear();
+    for_each_child(reader, [&](const std::string& name) {
+        if (name != "item") return reader.skip();
+        v.emplace_back();
+        read_xml(v.back(), reader);
+    });
+}
+
+template<typename T>
+void read_xml(std::list<T>& l, XmlPullReader& reader) {
+    l.clear();
+    for_each_child(reader, [&](const std::string& name) {
+        if (name != "item") return reader.skip();
+        l.emplace_back();
+        read_xml(l.back(), reader);
+    });
+}
+
+template<typename T>
+void read_xml(std::set<T>& s, XmlPullReader& reader) {
+    s.clear();
+    for_each_child(reader, [&](const std::string& name) {
+        if (name != "item") return reader.skip();
+        T item;
+        read_xml(item, reader);
+        s.emplace_hint(s.end(), std::move(item));
+    });
+}
+
+// ========== std::map ==========
+// 正常情况下 <key> 在 <value> 之前，值直接在 map 节点中就地解码；顺序颠倒时先读入临时对象
+template<typename K, typename V>
+void read_xml(std::map<K, V>& m, XmlPullReader& reader) {
+    m.clear();
+    for_each_child(reader, [&](const std::string& name) {
+        if (name != "item") return reader.skip();
+        K key{};
+        V pending{};
+        bool hasKey = false, hasValue = false, valueFirst = false;
+        for_each_child(reader, [&](const std::string& child) {
+            if (!hasKey && child == "key") {
+                read_xml(key, reader);
+                hasKey = true;
+            } else if (!hasValue && child == "value") {
+                if (hasKey) {
+                    auto it = m.emplace_hint(m.end(), std::piecewise_construct,
+                                             std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
+                    read_xml(it->second, reader);
+                } else {
+                    read_xml(pending, reader);
+                    valueFirst = true;
+                }
+                hasValue = true;
+            } else {
+                reader.skip();
+            }
+        });
+        if (!hasValue) {
+            m.emplace_hint(m.end(), std::piecewise_construct,
+                           std::forward_as_tuple(std::move(key)), std::forward_as_tuple());
+        } else if (valueFirst) {
+            m.emplace_hint(m.end(), std::move(key), std::move(pending));
+        }
+    });
+}
+
+template<typename Field>
+void FieldReader::operator()(Field& field) {
+    while (open) {
+        if (!reader.next() || reader.event() != XmlPullReader::StartElement) {
+            open = false;
+            break;
+        }
+        if (reader.name() == "field") {
+            read_xml(field, reader);
+            return;
+        }
+        reader.skip();
+    }
+    deserialize_xml(field, "field", nullptr);
+}
+
+// ========== XmlStreamReader ==========
+// 与 XmlInputArchive 用法相同，但不建索引：load 从当前位置向后查找同名节点，
+// 所以多个值必须按它们在文件中的顺序读取；越过的节点被跳过且不能再读。
+class XmlStreamReader {
+public:
+    explicit XmlStreamReader(const std::string& filename) : reader_(filename) {
+        loaded_ = reader_.next() && reader_.event() == XmlPullReader::StartElement && reader_.name() == "serialization";
+        open_ = loaded_;
+    }
+
+    bool loaded() const { return loaded_; }
+
+    // 返回是否找到该名字；找不到时按各类型的缺失规则处理 value
+    template<typename T>
+    bool load(const std::string& name, T& value) {
+        if (load_with(name, [&](XmlPullReader& reader) { read_xml(value, reader); })) return true;
+        deserialize_xml(value, name.c_str(), nullptr);
+        return false;
+    }
+
+    // 找到名为 name 的节点后交给 read(reader) 按 read_xml 的约定消费；找不到时返回 false，不调用 read
+    template<typename F>
+    bool load_with(const std::string& name, F&& read) {
+        while (open_) {
+            if (!reader_.next() || reader_.event() != XmlPullReader::StartElement) {
+                open_ = false;
+                break;
+            }
+            if (reader_.name() == name) {
+                read(reader_);
+                return true;
+            }
+            reader_.skip();
+        }
+        return false;
+    }
+
+    bool error() const { return reader_.error(); }
+
+private:
+    XmlPullReader reader_;
+    bool loaded_ = false;
+    bool open_ = false;
+};
+
+// ========== 文件接口 ==========
+// 读取 serialize_xml / stream_serialize_xml 写出的单值文件
+template<typename T>
+bool stream_deserialize_xml(T& obj, const std::string& name, const std::string& filename) {
+    XmlStreamReader reader(filename);
+    return reader.load(name, obj);
+}
+
+} // namespace xml_serialization
+
+#endif // XML_STREAM_READER_H
@@ -0,0 +1,207 @@
+#ifndef XML_STREAM_WRITER_H
+#define XML_STREAM_WRITER_H
+
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "xml_serialization.h"
+
+namespace xml_serialization {
+
+// 流式写出：不构建 XMLDocument，遍历对象的同时经 tinyxml2::XMLPrinter 直接写入文件（或内存缓冲区）。
+// 写文件时内存占用只与嵌套深度有关，与元素个数无关；输出与 XmlOutputArchive::flush() 逐字节相同。
+// stream_xml(obj, printer) 约定：调用前当前节点已 OpenElement，值以属性或子节点的形式写入，由调用方 CloseElement。
+
+// ========== 前置声明 ==========
+template<typename T1, typename T2>
+void stream_xml(const std::pair<T1, T2>& obj, tinyxml2::XMLPrinter& printer);
+template<typename T>
+void stream_xml(const std::vector<T>& v, tinyxml2::XMLPrinter& printer);
+template<typename T>
+void stream_xml(const std::list<T>& l, tinyxml2::XMLPrinter& printer);
+template<typename T>
+void stream_xml(const std::set<T>& s, tinyxml2::XMLPrinter& printer);
+template<typename K, typename V>
+void stream_xml(const std::map<K, V>& m, tinyxml2::XMLPrinter& printer);
+template<typename Vec>
+void stream_xml(const Packed<Vec>& p, tinyxml2::XMLPrinter& printer);
+
+// 把每个成员写成一个 <field> 子节点，供 XML_SERIALIZABLE 生成的 xml_fields 使用
+struct FieldStreamer {
+    tinyxml2::XMLPrinter& printer;
+
+    template<typename Field>
+    void operator()(const Field& field) const;
+};
+
+// ========== 用户自定义类型（XML_SERIALIZABLE） ==========
+template<typename T>
+auto stream_xml(const T& obj, tinyxml2::XMLPrinter& printer)
+    -> decltype(obj.xml_fields(std::declval<FieldStreamer&>()), void()) {
+    obj.xml_fields(FieldStreamer{printer});
+}
+
+// ========== 算术类型 ==========
+template<typename T>
+typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+stream_xml(const T& obj, tinyxml2::XMLPrinter& printer) {
+    char buf[kNumberTextSize];
+    printer.PushAttribute("val", format_number(obj, buf));
+}
+
+// ========== 打包数组 ==========
+// 分块编码并逐块 PushText，内存占用与数组大小无关；块长是 3 的倍数，拼起来与整体编码相同
+template<typename Vec>
+void stream_xml(const Packed<Vec>& p, tinyxml2::XMLPrinter& printer) {
+    char buf[kNumberTextSize];
+    printer.PushAttribute("encoding", "base64");
+    printer.PushAttribute("count", format_number(p.vec.size(), buf));
+    const char* bytes = reinterpret_cast<const char*>(p.vec.data());
+    size_t total = p.vec.size() * sizeof(p.vec[0]);
+    constexpr size_t kChunk = 3 * 16 * 1024;
+    std::string text;
+    for (size_t off = 0; off < total; off += kChunk) {
+        text.clear();
+        base64_encode(bytes + off, total - off < kChunk ? total - off : kChunk, text);
+        printer.PushText(text.c_str());
+    }
+}
+
+// ========== std::string ==========
+inline void stream_xml(const std::string& obj, tinyxml2::XMLPrinter& printer) {
+    printer.PushAttribute("val", obj.c_str());
+}
+
+// ========== std::pair ==========
+template<typename T1, typename T2>
+void stream_xml(const std::pair<T1, T2>& obj, tinyxml2::XMLPrinter& printer) {
+    printer.OpenElement("first");
+    stream_xml(obj.first, printer);
+    printer.CloseElement();
+    printer.OpenElement("second");
+    stream_xml(obj.second, printer);
+    printer.CloseElement();
+}
+
+// ========== std::vector / std::list / std::set ==========
+template<typename Container>
+void stream_items(const Container& c, tinyxml2::XMLPrinter& printer) {
+    for (const auto& item : c) {
+        printer.OpenElement("item");
+        stream_xml(item, printer);
+        printer.CloseElement();
+    }
+}
+
+template<typename T>
+void stream_xml(const std::vector<T>& v, tinyxml2::XMLPrinter& printer) {
+    stream_items(v, printer);
+}
+
+template<typename T>
+void stream_xml(const std::list<T>& l, tinyxml2::XMLPrinter& printer) {
+    stream_items(l, printer);
+}
+
+template<typename T>
+void stream_xml(const std::set<T>& s, tinyxml2::XMLPrinter& printer) {
+    stream_items(s, printer);
+}
+
+// ========== std::map ==========
+template<typename K, typename V>
+void stream_xml(const std::map<K, V>& m, tinyxml2::XMLPrinter& printer) {
+    for (const auto& kv : m) {
+        printer.OpenElement("item");
+        printer.OpenElement("key");
+        stream_xml(kv.first, printer);
+        printer.CloseElement();
+        printer.OpenElement("value");
+        stream_xml(kv.second, printer);
+        printer.CloseElement();
+        printer.CloseElement();
+    }
+}
+
+template<typename Field>
+void FieldStreamer::operator()(const Field& field) const {
+    printer.OpenElement("field");
+    stream_xml(field, printer);
+    printer.CloseElement();
+}
+
+// ========== XmlStreamWriter ==========
+// 与 XmlOutputArchive 用法相同，但每次 save 都立即写出：
+//     XmlStreamWriter out("export.xml");
+//     out.save("samples", samples).save("index", index);
+//     out.close();
+// 不带文件名构造时写入内存，close() 后通过 c_str() / size() 取结果。
+class XmlStreamWriter {
+public:
+    explicit XmlStreamWriter(const std::string& filename)
+        : file_(std::fopen(filename.c_str(), "w")), printer_(file_), good_(file_ != nullptr) {
+        printer_.OpenElement("serialization");
+    }
+
+    XmlStreamWriter() : printer_(nullptr) { printer_.OpenElement("serialization"); }
+
+    ~XmlStreamWriter() { close(); }
+
+    XmlStreamWriter(const XmlStreamWriter&) = delete;
+    XmlStreamWriter& operator=(const XmlStreamWriter&) = delete;
+
+    // 文件打开或写入失败时为 false；打开失败后的 save 不会写出任何内容
+    bool good() const { return good_; }
+
+    template<typename T>
+    XmlStreamWriter& save(const std::string& name, const T& value) {
+        return save_with(name, [&](tinyxml2::XMLPrinter& printer) { stream_xml(value, printer); });
+    }
+
+    // 写出名为 name 的节点，内容由 write(printer) 按 stream_xml 的约定写入（用于不经过对象的写出，如转码）
+    template<typename F>
+    XmlStreamWriter& save_with(const std::string& name, F&& write) {
+        if (closed_ || !good_) return *this;
+        printer_.OpenElement(name.c_str());
+        write(printer_);
+        printer_.CloseElement();
+        return *this;
+    }
+
+    // 结束根节点并关闭文件；返回整个写出过程是否成功
+    bool close() {
+        if (closed_) return good_;
+        closed_ = true;
+        if (!good_) return false;
+        printer_.CloseElement();
+        if (file_) {
+            good_ = !std::ferror(file_);
+            good_ = std::fclose(file_) == 0 && good_;
+            file_ = nullptr;
+        }
+        return good_;
+    }
+
+    const char* c_str() const { return printer_.CStr(); }
+    size_t size() const { return static_cast<size_t>(printer_.CStrSize()) - 1; }
+
+private:
+    std::FILE* file_ = nullptr;
+    tinyxml2::XMLPrinter printer_;
+    bool good_ = true;
+    bool closed_ = false;
+};
+
+// ========== 文件接口 ==========
+// 单值文件，格式与 serialize_xml(obj, name, filename) 相同
+template<typename T>
+bool stream_serialize_xml(const T& obj, const std::string& name, const std::string& filename) {
+    XmlStreamWriter writer(filename);
+    writer.save(name, obj);
+    return writer.close();
+}
+
+} // namespace xml_serialization
+
+#endif // XML_STREAM_WRITER_H
@@ -0,0 +1,446 @@
+#ifndef XML_TRANSCODE_H
+#define XML_TRANSCODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "binary_serialization.h"
+#include "xml_serialization.h"
+#include "xml_stream_writer.h"
+#include "xml_stream_reader.h"
+
+namespace xml_serialization {
+
+// ========== 二进制 <-> XML 转码 ==========
+// 不构造对象，按类型 T 的结构在两种编码之间逐元素转换：
+//     transcode_binary_to_xml<Config>("config.bin", "config", "config.xml");   // 导出供人工编辑或审计
+//     transcode_xml_to_binary<Config>("config.xml", "config", "config.bin");   // 编辑后写回快照
+// 结果与"反序列化成 T 再用另一端序列化"相同：XML 与 stream_serialize_xml 写出的文件逐字节相同，
+// 二进制（XML 由本库写出时）与 serialize(obj, filename) 写出的文件逐字节相同。
+// 转换过程中只持有当前的一个标量或字符串，内存占用只与嵌套深度有关，与元素个数无关。
+//
+// 支持算术类型、std::string、std::pair、std::vector、std::list、std::set、std::map，以及同时带有
+// BINARY_SERIALIZABLE 与 XML_SERIALIZABLE 的用户类型：成员类型取自 BINARY_SERIALIZABLE，
+// 两个宏的成员列表须相同且顺序一致。
+// - 二进制 -> XML：可读任意输入 Archive（默认、紧凑、可移植、字典模式）。XML_SERIALIZABLE 中写成 packed(...)
+//   的成员转出为普通的 <item> 列表，两种形式读端都认。
+// - XML -> 二进制：只写默认模式。XML 中没有元素个数，容器先写占位的长度前缀，元素写完后回填，
+//   因此输出端除 write 外还需要 size() / overwrite()（BufferWriter、FileWriter）。
+//   读取规则与 read_xml 相同：缺失的节点按 deserialize_xml(obj, name, nullptr) 处理，无关子节点跳过，
+//   <key>/<value>、<first>/<second> 顺序颠倒时后一个先暂存，打包数组按块解码。
+//   set / map 的元素按文件中的顺序写出，手工编辑打乱的顺序或重复的键在读回时照常排序、去重。
+//   打包数组的内容损坏时抛 std::runtime_error（此时长度前缀已经写出；DOM 路径会读回空数组）。
+template<typename T>
+struct type_tag {};
+
+// 二进制输入的编码（XML -> 二进制只写 Default）
+enum class BinaryEncoding { Default, Compact, Portable, Dictionary };
+
+// ========== 前置声明 ==========
+template<typename T1, typename T2, typename In>
+void binary_to_xml(type_tag<std::pair<T1, T2>>, In& in, tinyxml2::XMLPrinter& printer);
+template<typename T, typename In>
+void binary_to_xml(type_tag<std::vector<T>>, In& in, tinyxml2::XMLPrinter& printer);
+template<typename T, typename In>
+void binary_to_xml(type_tag<std::list<T>>, In& in, tinyxml2::XMLPrinter& printer);
+template<typename T, typename In>
+void binary_to_xml(type_tag<std::set<T>>, In& in, tinyxml2::XMLPrinter& printer);
+template<typename K, typename V, typename In>
+void binary_to_xml(type_tag<std::map<K, V>>, In& in, tinyxml2::XMLPrinter& printer);
+
+template<typename T1, typename T2, typename Out>
+void xml_to_binary(type_tag<std::pair<T1, T2>>, XmlPullReader& reader, Out& out, const std::pair<T1, T2>& base);
+template<typename T, typename Out>
+void xml_to_binary(type_tag<std::vector<T>>, XmlPullReader& reader, Out& out, const std::vector<T>& base);
+template<typename T, typename Out>
+void xml_to_binary(type_tag<std::list<T>>, XmlPullReader& reader, Out& out, const std::list<T>& base);
+template<typename T, typename Out>
+void xml_to_binary(type_tag<std::set<T>>, XmlPullReader& reader, Out& out, const std::set<T>& base);
+template<typename K, typename V, typename Out>
+void xml_to_binary(type_tag<std::map<K, V>>, XmlPullReader& reader, Out& out, const std::map<K, V>& base);
+
+// ========== 二进制 -> XML ==========
+// binary_to_xml(type_tag<T>, in, printer) 从 in 读出一个 T 的编码，按 stream_xml(obj, printer) 的约定写出：
+// 调用前当前节点已 OpenElement，由调用方 CloseElement
+
+// 用户自定义类型：每个成员一个 <field> 子节点
+template<typename In, typename... F>
+void binary_fields_to_xml(type_tag<std::tuple<F...>>, In& in, tinyxml2::XMLPrinter& printer) {
+    ((printer.OpenElement("field"), binary_to_xml(type_tag<F>{}, in, printer), printer.CloseElement()), ...);
+}
+
+template<typename T, typename In>
+auto binary_to_xml(type_tag<T>, In& in, tinyxml2::XMLPrinter& printer)
+    -> decltype(std::declval<BinarySerialization::detail::field_types_t<T>*>(), void()) {
+    binary_fields_to_xml(type_tag<BinarySerialization::detail::field_types_t<T>>{}, in, printer);
+}
+
+template<typename T, typename In>
+typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+binary_to_xml(type_tag<T>, In& in, tinyxml2::XMLPrinter& printer) {
+    T value;
+    BinarySerialization::deserialize(value, in);
+    char buf[kNumberTextSize];
+    printer.PushAttribute("val", format_number(value, buf));
+}
+
+template<typename In>
+void binary_to_xml(type_tag<std::string>, In& in, tinyxml2::XMLPrinter& printer) {
+    std::string value;
+    BinarySerialization::deserialize(value, in);
+    printer.PushAttribute("val", value.c_str());
+}
+
+template<typename T1, typename T2, typename In>
+void binary_to_xml(type_tag<std::pair<T1, T2>>, In& in, tinyxml2::XMLPrinter& printer) {
+    printer.OpenElement("first");
+    binary_to_xml(type_tag<T1>{}, in, printer);
+    printer.CloseElement();
+    printer.OpenElement("second");
+    binary_to_xml(type_tag<T2>{}, in, printer);
+    printer.CloseElement();
+}
+
+// 长度前缀来自输入，不据此预分配；数据被截断时由读端抛异常
+template<typename T, typename In>
+void binary_items_to_xml(In& in, tinyxml2::XMLPrinter& printer) {
+    size_t n = BinarySerialization::read_length(in);
+    for (size_t i = 0; i < n; ++i) {
+        printer.OpenElement("item");
+        binary_to_xml(type_tag<T>{}, in, printer);
+        printer.CloseElement();
+    }
+}
+
+template<typename T, typename In>
+void binary_to_xml(type_tag<std::vector<T>>, In& in, tinyxml2::XMLPrinter& printer) {
+    binary_items_to_xml<T>(in, printer);
+}
+
+template<typename T, typename In>
+void binary_to_xml(type_tag<std::list<T>>, In& in, tinyxml2::XMLPrinter& printer) {
+    binary_items_to_xml<T>(in, printer);
+}
+
+template<typename T, typename In>
+void binary_to_xml(type_tag<std::set<T>>, In& in, tinyxml2::XMLPrinter& printer) {
+    binary_items_to_xml<T>(in, printer);
+}
+
+template<typename K, typename V, typename In>
+void binary_to_xml(type_tag<std::map<K, V>>, In& in, tinyxml2::XMLPrinter& printer) {
+    size_t n = BinarySerialization::read_length(in);
+    for (size_t i = 0; i < n; ++i) {
+        printer.OpenElement("item");
+        printer.OpenElement("key");
+        binary_to_xml(type_tag<K>{}, in, printer);
+        printer.CloseElement();
+        printer.OpenElement("value");
+        binary_to_xml(type_tag<V>{}, in, printer);
+        printer.CloseElement();
+        printer.CloseElement();
+    }
+}
+
+// ========== XML -> 二进制 ==========
+// xml_to_binary(type_tag<T>, reader, out, base) 按 read_xml(obj, reader) 的约定消费一个值节点，把它的默认模式编码写入 out。
+// base 是 read_xml 开始时 obj 的值（容器元素为 T{}，成员为其默认值）：属性缺失的算术节点与缺失的节点从它得到结果
+
+// 每个类型一个值初始化的对象，作为容器元素与成员的 base
+template<typename T>
+const T& default_value() {
+    static const T value{};
+    return value;
+}
+
+// 节点缺失：与对 base 的副本调用 deserialize_xml(obj, name, nullptr) 相同
+template<typename T, typename Out>
+void write_missing(const T& base, Out& out) {
+    T value = base;
+    deserialize_xml(value, "", nullptr);
+    BinarySerialization::serialize(value, out);
+}
+
+template<typename Out>
+size_t begin_length(Out& out) {
+    size_t pos = out.size();
+    BinarySerialization::write_length(out, size_t(0));
+    return pos;
+}
+
+template<typename Out>
+void end_length(Out& out, size_t pos, size_t n) {
+    out.overwrite(pos, reinterpret_cast<const char*>(&n), sizeof(n));
+}
+
+// 与 FieldReader 相同：取下一个 <field> 子节点，子节点用完后剩余成员按缺失处理
+template<typename F, typename Out>
+void xml_field_to_binary(XmlPullReader& reader, Out& out, const F& base, bool& open) {
+    while (open) {
+        if (!reader.next() || reader.event() != XmlPullReader::StartElement) {
+            open = false;
+            break;
+        }
+        if (reader.name() == "field") {
+            xml_to_binary(type_tag<F>{}, reader, out, base);
+            return;
+        }
+        reader.skip();
+    }
+    write_missing(base, out);
+}
+
+template<typename T, typename Out>
+auto xml_to_binary(type_tag<T>, XmlPullReader& reader, Out& out, const T& base)
+    -> decltype(std::declval<BinarySerialization::detail::field_types_t<T>*>(), void()) {
+    bool open = true;
+    std::apply([&](const auto&... fields) { (xml_field_to_binary(reader, out, fields, open), ...); },
+               BinarySerialization::detail::field_refs(base));
+    if (open) for_each_child(reader, [&](const std::string&) { reader.skip(); });
+}
+
+template<typename T, typename Out>
+typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+xml_to_binary(type_tag<T>, XmlPullReader& reader, Out& out, const T& base) {
+    T value = base;
+    if (const char* v = reader.attribute("val")) parse_number(v, value);
+    reader.skip();
+    BinarySerialization::serialize(value, out);
+}
+
+template<typename Out>
+void xml_to_binary(type_tag<std::string>, XmlPullReader& reader, Out& out, const std::string& /*base*/) {
+    const char* v = reader.attribute("val");
+    BinarySerialization::serialize(std::string_view(v ? v : ""), out);
+    reader.skip();
+}
+
+// 依次写出两个子节点 A、B（pair 的 first/second，map 项的 key/value）。B 先出现时写入临时缓冲区，A 写完后接上。
+// missingRule：缺失的子节点按 write_missing 处理（pair）；否则直接写 base（map 项的键与值从 K{} / V{} 开始）
+template<typename A, typename B, typename Out>
+void xml_pair_to_binary(XmlPullReader& reader, Out& out, const char* nameA, const A& baseA, const char* nameB,
+                        const B& baseB, bool missingRule) {
+    auto missing = [&](const auto& base, auto& sink) {
+        if (missingRule) {
+            write_missing(base, sink);
+        } else {
+            BinarySerialization::serialize(base, sink);
+        }
+    };
+    BinarySerialization::BufferWriter pendingB;
+    bool hasA = false, hasB = false;
+    for_each_child(reader, [&](const std::string& name) {
+        if (!hasA && name == nameA) {
+            xml_to_binary(type_tag<A>{}, reader, out, baseA);
+            hasA = true;
+            if (hasB) out.write(pendingB.data(), pendingB.size());
+        } else if (!hasB && name == nameB) {
+            if (hasA) {
+                xml_to_binary(type_tag<B>{}, reader, out, baseB);
+            } else {
+                xml_to_binary(type_tag<B>{}, reader, pendingB, baseB);
+            }
+            hasB = true;
+        } else {
+            reader.skip();
+        }
+    });
+    if (!hasA) {
+        missing(baseA, out);
+        if (hasB) out.write(pendingB.data(), pendingB.size());
+    }
+    if (!hasB) missing(baseB, out);
+}
+
+template<typename T1, typename T2, typename Out>
+void xml_to_binary(type_tag<std::pair<T1, T2>>, XmlPullReader& reader, Out& out, const std::pair<T1, T2>& base) {
+    xml_pair_to_binary(reader, out, "first", base.first, "second", base.second, true);
+}
+
+template<typename T, typename Out>
+void xml_items_to_binary(XmlPullReader& reader, Out& out) {
+    size_t pos = begin_length(out);
+    size_t n = 0;
+    for_each_child(reader, [&](const std::string& name) {
+        if (name != "item") return reader.skip();
+        xml_to_binary(type_tag<T>{}, reader, out, default_value<T>());
+        ++n;
+    });
+    end_length(out, pos, n);
+}
+
+// 打包数组：count 已知，长度前缀直接写出；文本经固定大小的缓冲区分块解码后写出（base64 内容即本机字节序的原始字节）
+template<typename T, typename Out>
+void xml_packed_to_binary(XmlPullReader& reader, Out& out) {
+    size_t n = 0;
+    const char* count = reader.attribute("count");
+    if (!count || !parse_number(count, n)) {
+        BinarySerialization::write_length(out, size_t(0));
+        reader.skip();
+        return;
+    }
+    if (n > SIZE_MAX / sizeof(T)) throw std::runtime_error("xml_to_binary: invalid packed array");
+    BinarySerialization::write_length(out, n);
+    char buf[12 * 1024];
+    constexpr size_t kTextChunk = sizeof(buf) / 3 * 4 - 4;  // 加上上一块残留的不足 4 个字符，解码结果不超过 buf
+    Base64Decoder decoder(buf, sizeof(buf));
+    size_t expected = n * sizeof(T), total = 0;
+    bool ok = true;
+    reader.read_text([&](const char* p, size_t len) {
+        while (ok && len > 0) {
+            size_t k = len < kTextChunk ? len : kTextChunk;
+            ok = decoder.feed(p, k) && decoder.size() <= expected - total;
+            if (ok) {
+                out.write(buf, decoder.size());
+                total += decoder.size();
+                decoder.reset_output();
+            }
+            p += k;
+            len -= k;
+        }
+    });
+    if (!ok || !decoder.finish() || total != expected) throw std::runtime_error("xml_to_binary: invalid packed array");
+    reader.skip();
+}
+
+template<typename T, typename Out>
+void xml_to_binary(type_tag<std::vector<T>>, XmlPullReader& reader, Out& out, const std::vector<T>& /*base*/) {
+    if constexpr (is_packable<T>::value) {
+        if (is_packed_element(reader.attribute("encoding"))) return xml_packed_to_binary<T>(reader, out);
+    }
+    xml_items_to_binary<T>(reader, out);
+}
+
+template<typename T, typename Out>
+void xml_to_binary(type_tag<std::list<T>>, XmlPullReader& reader, Out& out, const std::list<T>& /*base*/) {
+    xml_items_to_binary<T>(reader, out);
+}
+
+template<typename T, typename Out>
+void xml_to_binary(type_tag<std::set<T>>, XmlPullReader& reader, Out& out, const std::set<T>& /*base*/) {
+    xml_items_to_binary<T>(reader, out);
+}
+
+template<typename K, typename V, typename Out>
+void xml_to_binary(type_tag<std::map<K, V>>, XmlPullReader& reader, Out& out, const std::map<K, V>& /*base*/) {
+    size_t pos = begin_length(out);
+    size_t n = 0;
+    for_each_child(reader, [&](const std::string& name) {
+        if (name != "item") return reader.skip();
+        xml_pair_to_binary(reader, out, "key", default_value<K>(), "value", default_value<V>(), false);
+        ++n;
+    });
+    end_length(out, pos, n);
+}
+
+// ========== 转码接口 ==========
+// in 位于一个 T 的编码开头；printer 上的值节点已由调用方打开（例如 XmlStreamWriter::save_with）
+template<typename T, typename In>
+void transcode_to_xml(In& in, tinyxml2::XMLPrinter& printer) {
+    binary_to_xml(type_tag<T>{}, in, printer);
+}
+
+// reader 停在值节点的 StartElement（例如 XmlStreamReader::load_with），返回时已消费对应的 EndElement
+template<typename T, typename Out>
+void transcode_to_binary(XmlPullReader& reader, Out& out) {
+    static_assert(!BinarySerialization::is_compact_archive<Out>::value &&
+                      !BinarySerialization::is_portable_archive<Out>::value &&
+                      !BinarySerialization::is_dictionary_archive<Out>::value,
+                  "transcode_to_binary writes the default binary format only");
+    xml_to_binary(type_tag<T>{}, reader, out, default_value<T>());
+}
+
+// 读取 serialize(obj, binaryFile)（或紧凑 / 可移植 / 字典模式的文件接口）写出的文件，
+// 写成与 stream_serialize_xml(obj, name, xmlFile) 相同的 XML 文件；返回 XML 是否写出成功。
+// 二进制文件经 FileReader 顺序读入；数据损坏时与 deserialize 一样抛 std::runtime_error
+template<typename T>
+bool transcode_binary_to_xml(const std::string& binaryFile, const std::string& name, const std::string& xmlFile,
+                             BinaryEncoding encoding = BinaryEncoding::Default) {
+    using namespace BinarySerialization;
+    FileReader reader(binaryFile);
+    XmlStreamWriter writer(xmlFile);
+    writer.save_with(name, [&](tinyxml2::XMLPrinter& printer) {
+        switch (encoding) {
+        case BinaryEncoding::Compact: {
+            CompactReader<FileReader> compact(reader);
+            transcode_to_xml<T>(compact, printer);
+            break;
+        }
+        case BinaryEncoding::Portable: {
+            PortableReader<FileReader> portable(reader);
+            transcode_to_xml<T>(portable, printer);
+            break;
+        }
+        case BinaryEncoding::Dictionary: {
+            DictionaryReader<FileReader> dict(reader);
+            transcode_to_xml<T>(dict, printer);
+            break;
+        }
+        default:
+            transcode_to_xml<T>(reader, printer);
+        }
+    });
+    return writer.close();
+}
+
+// 读取 serialize_xml / stream_serialize_xml 写出的单值文件，写成与 serialize(obj, binaryFile) 相同的文件。
+// 返回是否找到名为 name 的值且 XML 没有格式错误；找不到时不创建二进制文件。写文件失败时抛 std::runtime_error
+template<typename T>
+bool transcode_xml_to_binary(const std::string& xmlFile, const std::string& name, const std::string& binaryFile) {
+    XmlStreamReader reader(xmlFile);
+    if (!reader.loaded()) return false;
+    bool found = reader.load_with(name, [&](XmlPullReader& pull) {
+        BinarySerialization::FileWriter out(binaryFile);
+        transcode_to_binary<T>(pull, out);
+        out.close();
+    });
+    return found && !reader.error();
+}
+
+// ========== 按类型名查找 ==========
+// 命令行工具按名字选择类型；使用方为自己的类型注册一行即可：
+//     registry.add<Config>("Config");
+class TranscoderRegistry {
+public:
+    using ToXml = bool (*)(const std::string&, const std::string&, const std::string&, BinaryEncoding);
+    using ToBinary = bool (*)(const std::string&, const std::string&, const std::string&);
+
+    struct Entry {
+        ToXml toXml;
+        ToBinary toBinary;
+    };
+
+    template<typename T>
+    TranscoderRegistry& add(const std::string& typeName) {
+        entries_[typeName] = Entry{&transcode_binary_to_xml<T>, &transcode_xml_to_binary<T>};
+        return *this;
+    }
+
+    // 未注册时返回 nullptr
+    const Entry* find(const std::string& typeName) const {
+        auto it = entries_.find(typeName);
+        return it == entries_.end() ? nullptr : &it->second;
+    }
+
+    std::vector<std::string> names() const {
+        std::vector<std::string> result;
+        for (const auto& kv : entries_) result.push_back(kv.first);
+        return result;
+    }
+
+private:
+    std::map<std::string, Entry> entries_;
+};
+
+} // namespace xml_serialization
+
+#endif // XML_TRANSCODE_H
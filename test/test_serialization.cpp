@@ -1,12 +1,28 @@
 #include <iostream>
+#include <cstdio>
 #include <cassert>
 #include <vector>
 #include <list>
 #include <set>
 #include <map>
+#include <array>
 #include <string>
+#include <string_view>
+#include <memory_resource>
 #include "binary_serialization.h"
+#include "binary_parallel.h"
+#include "binary_columnar.h"
+#include "binary_indexed.h"
+#include "binary_async.h"
+#include "binary_record_log.h"
+#include "binary_compress.h"
+#include "binary_delta.h"
 #include "xml_serialization.h"
+#include "xml_stream_writer.h"
+#include "xml_stream_reader.h"
+#include "xml_async.h"
+#include "xml_document_cache.h"
+#include "xml_transcode.h"
 
 struct UserDefinedType {
     int idx;
@@ -16,6 +32,20 @@ struct UserDefinedType {
     XML_SERIALIZABLE(idx, name, data)
 };
 
+struct NamedRowView {
+    int idx = 0;
+    std::string_view name;
+    BINARY_SERIALIZABLE(idx, name)
+};
+
+struct GraphNode {
+    int value = 0;
+    std::vector<std::shared_ptr<GraphNode>> children;
+    std::weak_ptr<GraphNode> parent;
+    std::unique_ptr<std::string> label;
+    BINARY_SERIALIZABLE(value, children, parent, label)
+};
+
 void test_binary_serialization() {
     int n0 = 256, n1;
     BinarySerialization::serialize(n0, "n.data");
@@ -52,6 +82,336 @@ void test_binary_serialization() {
     BinarySerialization::deserialize(pair1, "pair.data");
     assert(pair0 == pair1);
 
+    std::array<float, 4> a0{1.5f, 2.5f, 3.5f, 4.5f}, a1{};
+    BinarySerialization::serialize(a0, "array.data");
+    BinarySerialization::deserialize(a1, "array.data");
+    assert(a0 == a1);
+
+    std::vector<std::pair<int, double>> vp0{{1, 1.5}, {2, 2.5}, {3, 3.5}}, vp1;
+    BinarySerialization::serialize(vp0, "vpair.data");
+    BinarySerialization::deserialize(vp1, "vpair.data");
+    assert(vp0 == vp1);
+
+    std::map<int, std::vector<std::string>> mv0{{1, {"x", "y"}}, {2, {}}}, mv1;
+    BinarySerialization::BufferWriter writer;
+    BinarySerialization::serialize(mv0, writer);
+    BinarySerialization::BufferReader reader(writer.data(), writer.size());
+    BinarySerialization::deserialize(mv1, reader);
+    assert(mv0 == mv1 && reader.remaining() == 0);
+
+    // 空容器的 data() 可能为空指针，读写 0 字节不能把它交给 memcpy
+    std::vector<double> empty0, empty1{1.0};
+    BinarySerialization::BufferWriter emptyWriter;
+    BinarySerialization::serialize(empty0, emptyWriter);
+    BinarySerialization::BufferReader emptyReader(emptyWriter.data(), emptyWriter.size());
+    BinarySerialization::deserialize(empty1, emptyReader);
+    assert(empty1.empty() && emptyReader.remaining() == 0);
+
+    std::vector<std::string> sv0{"alpha", "beta"};
+    BinarySerialization::serialize(sv0, "views.data");
+    {
+        BinarySerialization::MappedFile file("views.data");
+        std::vector<std::string_view> sv1;
+        BinarySerialization::deserialize(sv1, file);
+        assert(sv1.size() == 2 && sv1[0] == "alpha" && sv1[1] == "beta");
+    }
+    // 文件接口在返回前释放映射，读端不借出视图
+    static_assert(!BinarySerialization::is_view_archive<BinarySerialization::CopyingReader>::value, "");
+    static_assert(!BinarySerialization::lends_dictionary_views<
+                      BinarySerialization::DictionaryReader<BinarySerialization::CopyingReader>>::value, "");
+
+    std::vector<double> dv0{1.5, 2.5}, dv1;
+    BinarySerialization::serialize(dv0, "doubles.data");
+    {
+        BinarySerialization::MappedFile file("doubles.data");
+        BinarySerialization::ArrayView<double> view;
+        BinarySerialization::deserialize(view, file);
+        assert(view.size() == 2 && view[0] == 1.5 && view[1] == 2.5);
+    }
+    // ArrayView<char>：字节视图，与 std::string 的线上格式相同
+    const char rawBytes[] = "bytes";
+    BinarySerialization::BufferWriter byteWriter;
+    BinarySerialization::serialize(BinarySerialization::ArrayView<char>(rawBytes, 5), byteWriter);
+    {
+        BinarySerialization::BufferReader byteReader(byteWriter.data(), byteWriter.size());
+        BinarySerialization::ArrayView<char> bytes;
+        BinarySerialization::deserialize(bytes, byteReader);
+        assert(bytes.size() == 5 && bytes[4] == 's' && std::string(bytes.data(), bytes.size()) == "bytes");
+        BinarySerialization::BufferReader stringReader(byteWriter.data(), byteWriter.size());
+        std::string asString;
+        BinarySerialization::deserialize(asString, stringReader);
+        assert(asString == "bytes");
+    }
+
+    std::map<int, std::string> cm0{{-7, "neg"}, {300, "wide"}}, cm1;
+    BinarySerialization::serialize_compact(cm0, "compact.data");
+    BinarySerialization::deserialize_compact(cm1, "compact.data");
+    assert(cm0 == cm1);
+
+    std::map<long, std::vector<double>> em0{{-1, {0.5, 1.5}}, {1L << 40, {}}}, em1;
+    BinarySerialization::serialize_portable(em0, "portable.data");
+    BinarySerialization::deserialize_portable(em1, "portable.data");
+    assert(em0 == em1);
+    BinarySerialization::BufferWriter bigBuffer;
+    {
+        BinarySerialization::PortableWriter<BinarySerialization::BufferWriter> big(bigBuffer, BinarySerialization::ByteOrder::Big);
+        BinarySerialization::serialize(uint32_t(0x01020304), big);
+        std::vector<std::array<uint16_t, 3>> arrays(11, {{1, 0x0203, 0xfffe}});
+        std::vector<std::pair<int64_t, float>> pairs{{-5, 2.5f}, {1LL << 50, -0.25f}};
+        BinarySerialization::serialize(arrays, big);
+        BinarySerialization::serialize(pairs, big);
+    }
+    assert(std::string(bigBuffer.data(), 4) == "BSPF" && bigBuffer.data()[5] == 1);
+    assert(bigBuffer.data()[8] == 1 && bigBuffer.data()[9] == 2 && bigBuffer.data()[11] == 4);
+    {
+        BinarySerialization::BufferReader bigBytes(bigBuffer.data(), bigBuffer.size());
+        BinarySerialization::PortableReader<BinarySerialization::BufferReader> big(bigBytes);
+        uint32_t word;
+        std::vector<std::array<uint16_t, 3>> arrays;
+        std::vector<std::pair<int64_t, float>> pairs;
+        BinarySerialization::deserialize(word, big);
+        BinarySerialization::deserialize(arrays, big);
+        BinarySerialization::deserialize(pairs, big);
+        assert(big.swaps() == (BinarySerialization::kHostByteOrder == BinarySerialization::ByteOrder::Little));
+        assert(word == 0x01020304 && arrays.size() == 11 && arrays[10][1] == 0x0203 && arrays[10][2] == 0xfffe);
+        assert(pairs[1].first == (1LL << 50) && pairs[1].second == -0.25f && bigBytes.remaining() == 0);
+    }
+
+    std::vector<std::map<std::string, int>> tm0(50, {{"tenant-a", 1}, {"tenant-b", 2}}), tm1;
+    tm0[7]["tenant-c"] = 3;
+    BinarySerialization::serialize_dictionary(tm0, "dictionary.data");
+    BinarySerialization::deserialize_dictionary(tm1, "dictionary.data");
+    assert(tm0 == tm1);
+    BinarySerialization::BufferWriter dictBuffer;
+    BinarySerialization::CompactWriter<BinarySerialization::BufferWriter> dictCompact(dictBuffer);
+    BinarySerialization::DictionaryWriter<BinarySerialization::CompactWriter<BinarySerialization::BufferWriter>> dictWriter(dictCompact, 8);
+    std::vector<std::string> ds0{"metric", "metric", std::string(20, 'x'), "", "metric", std::string(20, 'x')};
+    BinarySerialization::serialize(ds0, dictWriter);
+    assert(dictWriter.dictionary_size() == 2 && dictBuffer.size() == 1 + 8 + 1 + 22 + 2 + 1 + 22);
+    std::vector<std::string_view> ds1;
+    BinarySerialization::BufferReader dictBytes(dictBuffer.data(), dictBuffer.size());
+    BinarySerialization::CompactReader<BinarySerialization::BufferReader> dictCompactReader(dictBytes);
+    BinarySerialization::DictionaryReader<BinarySerialization::CompactReader<BinarySerialization::BufferReader>> dictReader(dictCompactReader);
+    BinarySerialization::deserialize(ds1, dictReader);
+    assert(ds1.size() == 6 && ds1[4] == "metric" && ds1[0].data() == ds1[4].data() && ds1[5] == ds0[5]);
+
+    // 共享的子节点只写一次，环与 weak_ptr 读回后指向同一对象；长链按队列写出，不受调用栈深度限制
+    auto root0 = std::make_shared<GraphNode>();
+    auto leaf0 = std::make_shared<GraphNode>();
+    leaf0->value = 7;
+    leaf0->parent = root0;
+    leaf0->label.reset(new std::string("leaf"));
+    leaf0->children.push_back(root0);
+    root0->children = {leaf0, leaf0, nullptr};
+    std::vector<std::shared_ptr<GraphNode>> chain0(100000);
+    for (size_t i = 0; i < chain0.size(); ++i) {
+        chain0[i] = std::make_shared<GraphNode>();
+        chain0[i]->value = static_cast<int>(i);
+        if (i > 0) chain0[i - 1]->children.push_back(chain0[i]);
+    }
+    std::pair<std::shared_ptr<GraphNode>, std::vector<std::shared_ptr<GraphNode>>> g0{root0, chain0}, g1;
+    BinarySerialization::SizeCounter graphBytes;
+    BinarySerialization::GraphWriter<BinarySerialization::SizeCounter> graphCounter(graphBytes);
+    BinarySerialization::serialize(g0, graphCounter);
+    assert(graphCounter.object_count() == 2 + chain0.size());
+    BinarySerialization::serialize_graph(g0, "graph.data");
+    BinarySerialization::deserialize_graph(g1, "graph.data");
+    const auto& root1 = g1.first;
+    assert(root1->children.size() == 3 && root1->children[0] == root1->children[1] && !root1->children[2]);
+    assert(root1->children[0]->children[0] == root1 && root1->children[0]->parent.lock() == root1);
+    assert(*root1->children[0]->label == "leaf" && !root1->label);
+    assert(g1.second.size() == chain0.size() && g1.second[5]->children[0] == g1.second[6] &&
+           g1.second.back()->value == 99999);
+    root0->children.clear();
+    root1->children.clear();
+    std::vector<std::unique_ptr<int>> up0, up1;
+    up0.emplace_back(new int(5));
+    up0.emplace_back();
+    BinarySerialization::serialize(up0, "unique.data");
+    BinarySerialization::deserialize(up1, "unique.data");
+    assert(up1.size() == 2 && *up1[0] == 5 && !up1[1]);
+
+    std::vector<std::pair<int, std::string>> pv0, pv1, pv2;
+    for (int i = 0; i < 1000; ++i) pv0.emplace_back(i, std::string(i % 13, 'p'));
+    BinarySerialization::ThreadPool pool(4);
+    BinarySerialization::serialize_chunked(pv0, "chunked.data", pool, 64);
+    BinarySerialization::deserialize_chunked(pv1, "chunked.data", pool);
+    assert(pv0 == pv1);
+    BinarySerialization::BufferWriter chunkWriter;
+    BinarySerialization::CompactWriter<BinarySerialization::BufferWriter> compactChunks(chunkWriter);
+    BinarySerialization::serialize_chunked(pv0, compactChunks, pool);
+    BinarySerialization::BufferReader chunkReader(chunkWriter.data(), chunkWriter.size());
+    BinarySerialization::CompactReader<BinarySerialization::BufferReader> compactChunkReader(chunkReader);
+    BinarySerialization::deserialize_chunked(pv2, compactChunkReader, pool);
+    assert(pv0 == pv2 && chunkReader.remaining() == 0);
+    // 可移植模式：块内沿用外层格式头的字节序
+    std::vector<std::pair<int, std::string>> pv3;
+    BinarySerialization::BufferWriter bigChunkWriter;
+    {
+        BinarySerialization::PortableWriter<BinarySerialization::BufferWriter> bigChunks(bigChunkWriter, BinarySerialization::ByteOrder::Big);
+        BinarySerialization::serialize_chunked(pv0, bigChunks, pool, 64);
+    }
+    BinarySerialization::BufferReader bigChunkBytes(bigChunkWriter.data(), bigChunkWriter.size());
+    BinarySerialization::PortableReader<BinarySerialization::BufferReader> bigChunkReader(bigChunkBytes);
+    BinarySerialization::deserialize_chunked(pv3, bigChunkReader, pool);
+    assert(pv0 == pv3 && bigChunkBytes.remaining() == 0);
+    assert(bigChunkWriter.data()[bigChunkWriter.size() - 12] == 11);  // 末元素字符串的长度前缀为大端
+    // 块内视图只在外层支持 consume 时出现，且指向外层数据；文件接口与 CopyingReader 上不产生视图
+    std::vector<std::string> sc0(600, "chunk-view"), sc1;
+    std::vector<std::string_view> scViews;
+    BinarySerialization::BufferWriter viewChunks;
+    BinarySerialization::serialize_chunked(sc0, viewChunks, pool, 64);
+    BinarySerialization::BufferReader viewChunkReader(viewChunks.data(), viewChunks.size());
+    BinarySerialization::deserialize_chunked(scViews, viewChunkReader, pool);
+    assert(scViews.size() == 600 && scViews[5] == "chunk-view" && scViews[5].data() > viewChunks.data() &&
+           scViews[5].data() < viewChunks.data() + viewChunks.size());
+    BinarySerialization::CopyingReader copyingChunks(viewChunks.data(), viewChunks.size());
+    BinarySerialization::deserialize_chunked(sc1, copyingChunks, pool);
+    assert(sc1 == sc0 && copyingChunks.remaining() == 0);
+    static_assert(!BinarySerialization::is_view_archive<
+                      BinarySerialization::detail::segment_reader_t<BinarySerialization::CopyingReader>>::value, "");
+
+    BinarySerialization::serialize_indexed(map0, "map_indexed.data");
+    {
+        BinarySerialization::IndexedMapReader<int, std::string> indexed("map_indexed.data");
+        std::string found;
+        assert(indexed.size() == 2 && indexed.find(2, found) && found == "b" && !indexed.contains(3));
+    }
+    BinarySerialization::serialize_indexed(sv0, "vector_indexed.data");
+    {
+        BinarySerialization::IndexedVectorReader<std::string_view> indexed("vector_indexed.data");
+        assert(indexed.size() == 2 && indexed.at(1) == "beta");
+    }
+
+    std::vector<std::pair<int, std::string>> async0{{1, "one"}, {2, "two"}}, async1;
+    BinarySerialization::serialize_async(async0, "async.data").get();
+    BinarySerialization::deserialize(async1, "async.data");
+    assert(async0 == async1);
+
+    std::remove("records.log");
+    {
+        BinarySerialization::RecordLogWriter log("records.log", 64);
+        for (int i = 0; i < 10; ++i) log.append(std::make_pair(i, std::string(i, 'r')));
+    }
+    {
+        BinarySerialization::RecordLogReader log("records.log");
+        std::pair<int, std::string> record;
+        int count = 0;
+        while (log.next(record)) assert(record.first == count++ && record.second.size() == size_t(record.first));
+        assert(count == 10 && log.skipped_bytes() == 0);
+    }
+    // 中间一帧损坏、末尾留下半帧：重新打开写端只截掉半帧，损坏帧之后的记录仍可读出
+    {
+        std::FILE* f = std::fopen("records.log", "r+b");
+        std::fseek(f, 20 + 21 + 8 + 12, SEEK_SET);  // 第 3 帧（i = 2）载荷中的字符串内容
+        std::fputc('x', f);
+        std::fseek(f, 0, SEEK_END);
+        std::fwrite("\x05\0\0", 1, 3, f);
+        std::fclose(f);
+    }
+    {
+        BinarySerialization::RecordLogWriter log("records.log", 64);
+        log.append(std::make_pair(10, std::string(10, 'r')));
+    }
+    {
+        BinarySerialization::RecordLogReader log("records.log");
+        std::pair<int, std::string> record;
+        std::vector<int> seen;
+        while (log.next(record)) seen.push_back(record.first);
+        assert(seen.size() == 10 && seen[1] == 1 && seen[2] == 3 && seen.back() == 10 && log.skipped_bytes() == 22);
+    }
+
+    std::map<int, std::string> zm0, zm1;
+    for (int i = 0; i < 2000; ++i) zm0[i] = "compressed-" + std::to_string(i % 10);
+    BinarySerialization::serialize_compressed(zm0, "compressed.data", BinarySerialization::default_codec(), 4096, pool);
+    BinarySerialization::deserialize_compressed(zm1, "compressed.data", pool);
+    assert(zm0 == zm1);
+    {
+        BinarySerialization::CompressedReader compressed("compressed.data");
+        assert(compressed.block_count() > 1);
+        compressed.seek(sizeof(uint64_t) + sizeof(int));
+        std::string first;
+        BinarySerialization::deserialize(first, compressed);
+        assert(first == "compressed-0");
+    }
+
+    std::map<int, std::string> dm1 = zm0;
+    dm1.erase(3);
+    dm1[5000] = "inserted";
+    dm1[7] = "changed";
+    BinarySerialization::BufferWriter deltaWriter;
+    BinarySerialization::serialize_delta(zm0, dm1, deltaWriter);
+    assert(deltaWriter.size() < BinarySerialization::serialized_size(dm1) / 100);
+    std::map<int, std::string> dm2 = zm0;
+    BinarySerialization::BufferReader deltaReader(deltaWriter.data(), deltaWriter.size());
+    BinarySerialization::apply_delta(dm2, deltaReader);
+    assert(dm2 == dm1 && deltaReader.remaining() == 0);
+
+    std::remove("checkpoint.data");
+    std::remove("checkpoint.data.delta");
+    {
+        BinarySerialization::DeltaCheckpointer<std::map<int, std::string>> checkpoints("checkpoint.data", 2);
+        checkpoints.checkpoint(zm0);
+        checkpoints.checkpoint(dm1);
+        assert(checkpoints.delta_count() == 1 && checkpoints.last_checkpoint_bytes() == deltaWriter.size());
+    }
+    {
+        BinarySerialization::DeltaCheckpointer<std::map<int, std::string>> checkpoints("checkpoint.data");
+        std::map<int, std::string> restored;
+        assert(checkpoints.load(restored) && restored == dm1);
+    }
+    // 中间一条增量损坏：载入停在它之前的检查点，下一次检查点写出完整快照
+    std::remove("checkpoint.data");
+    std::remove("checkpoint.data.delta");
+    std::map<int, std::string> cp0{{1, "a"}, {2, "b"}}, cp1 = cp0, cp2, cp3;
+    cp1[3] = "c";
+    cp2 = cp1;
+    cp2[1] = "changed";
+    cp3 = cp2;
+    cp3.erase(2);
+    {
+        BinarySerialization::DeltaCheckpointer<std::map<int, std::string>> checkpoints("checkpoint.data", 32, 100.0);
+        checkpoints.checkpoint(cp0);
+        checkpoints.checkpoint(cp1);
+        checkpoints.checkpoint(cp2);
+        checkpoints.checkpoint(cp3);
+        assert(checkpoints.delta_count() == 3);
+    }
+    long secondDelta = 0;
+    {
+        BinarySerialization::MappedFile file("checkpoint.data.delta");
+        BinarySerialization::RecordLogReader log(file.data(), file.size());
+        BinarySerialization::BufferReader payload(nullptr, 0);
+        assert(log.next_frame(payload) && log.next_frame(payload));
+        secondDelta = static_cast<long>(payload.data() - file.data());
+    }
+    {
+        std::FILE* f = std::fopen("checkpoint.data.delta", "r+b");
+        std::fseek(f, secondDelta, SEEK_SET);
+        int c = std::fgetc(f);
+        std::fseek(f, secondDelta, SEEK_SET);
+        std::fputc(c ^ 0xff, f);
+        std::fclose(f);
+    }
+    {
+        BinarySerialization::DeltaCheckpointer<std::map<int, std::string>> checkpoints("checkpoint.data", 32, 100.0);
+        std::map<int, std::string> restored;
+        assert(checkpoints.load(restored) && restored == cp1 && checkpoints.delta_count() == 1);
+        uint64_t generation = checkpoints.generation();
+        checkpoints.checkpoint(cp3);
+        assert(checkpoints.generation() == generation + 1 && checkpoints.delta_count() == 0);
+    }
+    {
+        BinarySerialization::DeltaCheckpointer<std::map<int, std::string>> checkpoints("checkpoint.data");
+        std::map<int, std::string> restored;
+        assert(checkpoints.load(restored) && restored == cp3);
+    }
+
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::map<int, std::pmr::string> pm1(&arena);
+    BinarySerialization::deserialize(pm1, "map.data");
+    assert(pm1.size() == map0.size() && pm1[1] == "a" && pm1[2] == "b");
+
     std::cout << "Binary serialization test passed!" << std::endl;
 }
 
@@ -81,16 +441,83 @@ void test_xml_serialization() {
     xml_serialization::deserialize_xml(set1, "set", "set.xml");
     assert(set0 == set1);
 
-    // std::map<int, std::string> map0{{1,"a"},{2,"b"}}, map1;
-    // xml_serialization::serialize_xml(map0, "map", "map.xml");
-    // xml_serialization::deserialize_xml(map1, "map", "map.xml");
-    // assert(map0 == map1);
+    std::map<int, std::string> map0{{1,"a"},{2,"b"}}, map1;
+    xml_serialization::serialize_xml(map0, "map", "map.xml");
+    xml_serialization::deserialize_xml(map1, "map", "map.xml");
+    assert(map0 == map1);
 
     std::pair<int, double> pair0 = {2, 3.1}, pair1;
     xml_serialization::serialize_xml(pair0, "std_pair", "pair.xml");
     xml_serialization::deserialize_xml(pair1, "std_pair", "pair.xml");
     assert(pair0 == pair1);
 
+    std::map<int, std::string> map2;
+    xml_serialization::serialize_xml_async(map0, "map", "map_async.xml").get();
+    xml_serialization::deserialize_xml(map2, "map", "map_async.xml");
+    assert(map0 == map2);
+
+    std::vector<std::map<std::string, std::vector<int>>> nested0{{{"a", {1, 2}}}, {{"b", {}}}}, nested1;
+    xml_serialization::XmlOutputArchive out("multi.xml");
+    out.save("n", n0).save("s", s0).save("nested", nested0);
+    assert(out.flush());
+    int n2 = 0;
+    std::string s2;
+    xml_serialization::XmlInputArchive in("multi.xml");
+    assert(in.load("n", n2) && in.load("s", s2) && in.load("nested", nested1));
+    assert(n2 == n0 && s2 == s0 && nested1 == nested0);
+    assert(!in.contains("missing"));
+    int n4 = 0;
+    std::string s4;
+    assert(in.load_all("n", n4, "missing", n1, "s", s4) == 2 && n4 == n0 && s4 == s0);
+
+    // 同样大小的改写发生在修改时间精度之内也要能看到新内容
+    xml_serialization::XmlDocumentCache cache;
+    xml_serialization::serialize_xml(100, "n", "cached.xml");
+    auto doc0 = cache.open("cached.xml");
+    assert(cache.open("cached.xml") == doc0 && cache.load("cached.xml", "n", n4) && n4 == 100);
+    xml_serialization::serialize_xml(200, "n", "cached.xml");
+    assert(cache.open("cached.xml") != doc0 && cache.load_all("cached.xml", "n", n4) == 1 && n4 == 200);
+    assert(cache.stats().misses == 1 && cache.stats().reloads == 1 && cache.size() == 1);
+    std::remove("cached.xml");
+    assert(!cache.open("cached.xml")->loaded() && cache.size() == 0);
+
+    int n3 = 0;
+    std::string s3;
+    std::vector<std::map<std::string, std::vector<int>>> nested3;
+    xml_serialization::XmlStreamReader streamIn("multi.xml");
+    assert(streamIn.load("n", n3) && streamIn.load("s", s3) && streamIn.load("nested", nested3));
+    assert(n3 == n0 && s3 == s0 && nested3 == nested0);
+    assert(!streamIn.load("missing", n3) && !streamIn.error());
+
+    // 跳过跨越多个缓冲块的长文本与注释时，缓冲区保持在块大小附近
+    {
+        std::ofstream longText("long_text.xml");
+        longText << "<serialization><blob>" << std::string(300000, 'x') << "<!--" << std::string(300000, '-')
+                 << "--></blob><n>7</n></serialization>";
+    }
+    xml_serialization::XmlPullReader longReader("long_text.xml", 4096);
+    assert(longReader.next() && longReader.next() && longReader.name() == "blob");
+    longReader.skip();
+    assert(longReader.next() && longReader.name() == "n" && longReader.buffer_size() < 2 * 4096);
+    std::remove("long_text.xml");
+
+    std::vector<double> samples0{0.1, -2.5, 1e300, 3.0}, samples1, samples2;
+    xml_serialization::serialize_xml(xml_serialization::packed(samples0), "samples", "packed.xml");
+    xml_serialization::deserialize_xml(samples1, "samples", "packed.xml");
+    assert(samples1 == samples0);
+    assert(xml_serialization::stream_deserialize_xml(samples2, "samples", "packed.xml") && samples2 == samples0);
+
+    std::vector<float> floats{0.1f, 2.5f, -3.75f};
+    xml_serialization::XmlOutputArchive domOut("dom.xml");
+    domOut.save("n", n0).save("floats", floats).save("map", map0).save("nested", nested0);
+    assert(domOut.flush());
+    xml_serialization::XmlStreamWriter streamOut;
+    streamOut.save("n", n0).save("floats", floats).save("map", map0).save("nested", nested0);
+    assert(streamOut.close());
+    tinyxml2::XMLPrinter domPrinter;
+    domOut.document().Print(&domPrinter);
+    assert(std::string(streamOut.c_str()) == domPrinter.CStr());
+
     std::cout << "XML serialization test passed!" << std::endl;
 }
 
@@ -100,12 +527,116 @@ void test_user_defined_type() {
     BinarySerialization::deserialize(u1, "user.data");
     assert(u0.idx == u1.idx && u0.name == u1.name && u0.data == u1.data);
 
+    static_assert(BinarySerialization::serialized_size(std::pair<int, double>{}) == sizeof(int) + sizeof(double), "");
+    static_assert(BinarySerialization::fixed_serialized_size<UserDefinedType>::value == 0, "");
+    BinarySerialization::BufferWriter exact = BinarySerialization::serialize_to_buffer(u0);
+    assert(BinarySerialization::serialized_size(u0) == sizeof(int) + 2 * sizeof(size_t) + 5 + 3 * sizeof(double));
+    assert(exact.size() == exact.capacity() && exact.size() == BinarySerialization::serialized_size(u0));
 
+#if defined(SERIALIZATION_STATS)
+    serialization_stats::reset();
+    BinarySerialization::ThreadPool statsPool(2);
+    statsPool.parallel_for(4, [&](size_t) { BinarySerialization::serialize_to_buffer(u0); });
+    auto stats = serialization_stats::snapshot(serialization_stats::ByName);
+    assert(stats.size() == 4 && stats[0].name == "UserDefinedType" && stats[0].calls == 4);
+    assert(stats[0].bytes == 4 * exact.size() && stats[0].format == serialization_stats::Binary);
+    assert(stats[3].name == "UserDefinedType::name" && stats[3].member && stats[3].bytes == 4 * (sizeof(size_t) + 5));
+#endif
 
     xml_serialization::serialize_xml(u0, "user", "user.xml");
     xml_serialization::deserialize_xml(u2, "user", "user.xml");
     assert(u0.idx == u2.idx && u0.name == u2.name && u0.data == u2.data);
 
+    UserDefinedType u3;
+    assert(xml_serialization::stream_serialize_xml(u0, "user", "user_stream.xml"));
+    xml_serialization::deserialize_xml(u3, "user", "user_stream.xml");
+    assert(u0.idx == u3.idx && u0.name == u3.name && u0.data == u3.data);
+
+    UserDefinedType u4;
+    assert(xml_serialization::stream_deserialize_xml(u4, "user", "user.xml"));
+    assert(u0.idx == u4.idx && u0.name == u4.name && u0.data == u4.data);
+
+    std::vector<UserDefinedType> rows{u0, {7, "", {}}, {-3, "row", {0.5}}}, cols, idxOnly;
+    BinarySerialization::serialize_columnar(rows, "columnar.data");
+    BinarySerialization::deserialize_columnar(cols, "columnar.data");
+    assert(cols.size() == 3 && cols[0].name == "hello" && cols[2].data == rows[2].data && cols[1].idx == 7);
+    BinarySerialization::deserialize_columns(idxOnly, "columnar.data", &UserDefinedType::idx);
+    assert(idxOnly.size() == 3 && idxOnly[2].idx == -3 && idxOnly[0].name.empty() && idxOnly[0].data.empty());
+    std::vector<UserDefinedType> bigCols, bigNames;
+    BinarySerialization::BufferWriter bigColumnWriter;
+    {
+        BinarySerialization::PortableWriter<BinarySerialization::BufferWriter> bigColumns(bigColumnWriter, BinarySerialization::ByteOrder::Big);
+        BinarySerialization::serialize_columnar(rows, bigColumns);
+    }
+    {
+        BinarySerialization::BufferReader bigColumnBytes(bigColumnWriter.data(), bigColumnWriter.size());
+        BinarySerialization::PortableReader<BinarySerialization::BufferReader> bigColumnReader(bigColumnBytes);
+        BinarySerialization::deserialize_columnar(bigCols, bigColumnReader);
+        assert(bigColumnBytes.remaining() == 0);
+    }
+    assert(bigCols.size() == 3 && bigCols[0].name == "hello" && bigCols[2].data == rows[2].data && bigCols[2].idx == -3);
+    BinarySerialization::BufferReader bigNameBytes(bigColumnWriter.data(), bigColumnWriter.size());
+    BinarySerialization::PortableReader<BinarySerialization::BufferReader> bigNameReader(bigNameBytes);
+    BinarySerialization::deserialize_columns(bigNames, bigNameReader, &UserDefinedType::name);
+    assert(bigNames.size() == 3 && bigNames[2].name == "row" && bigNames[2].idx != -3);
+    // 视图成员只在外层支持 consume 时出现；文件接口与 CopyingReader 上按拥有型成员解码
+    std::vector<NamedRowView> viewRows0{{1, "first"}, {2, "second"}}, viewRows1;
+    BinarySerialization::BufferWriter viewColumns;
+    BinarySerialization::serialize_columnar(viewRows0, viewColumns);
+    BinarySerialization::BufferReader viewColumnReader(viewColumns.data(), viewColumns.size());
+    BinarySerialization::deserialize_columnar(viewRows1, viewColumnReader);
+    assert(viewRows1.size() == 2 && viewRows1[1].name == "second" && viewRows1[1].name.data() > viewColumns.data() &&
+           viewRows1[1].name.data() < viewColumns.data() + viewColumns.size());
+    std::vector<UserDefinedType> copiedCols;
+    BinarySerialization::BufferWriter rowColumns;
+    BinarySerialization::serialize_columnar(rows, rowColumns);
+    BinarySerialization::CopyingReader copyingColumns(rowColumns.data(), rowColumns.size());
+    BinarySerialization::deserialize_columnar(copiedCols, copyingColumns);
+    assert(copiedCols.size() == 3 && copiedCols[0].name == "hello" && copyingColumns.remaining() == 0);
+
+    // 转码结果与先反序列化再用另一端序列化的文件逐字节相同
+    auto same_file = [](const char* a, const char* b) {
+        BinarySerialization::MappedFile fa(a), fb(b);
+        return std::string_view(fa.data(), fa.size()) == std::string_view(fb.data(), fb.size());
+    };
+    using Groups = std::map<std::string, std::vector<UserDefinedType>>;
+    Groups groups0{{"a", rows}, {"b", {}}};
+    BinarySerialization::serialize(groups0, "groups.data");
+    assert(xml_serialization::stream_serialize_xml(groups0, "groups", "groups_ref.xml"));
+    assert(xml_serialization::transcode_binary_to_xml<Groups>("groups.data", "groups", "groups.xml"));
+    assert(same_file("groups.xml", "groups_ref.xml"));
+    assert(xml_serialization::transcode_xml_to_binary<Groups>("groups.xml", "groups", "groups2.data"));
+    assert(same_file("groups2.data", "groups.data"));
+    assert(!xml_serialization::transcode_xml_to_binary<Groups>("groups.xml", "missing", "groups3.data"));
+    BinarySerialization::serialize_compact(groups0, "groups_compact.data");
+    assert(xml_serialization::transcode_binary_to_xml<Groups>("groups_compact.data", "groups", "groups.xml",
+                                                             xml_serialization::BinaryEncoding::Compact));
+    assert(same_file("groups.xml", "groups_ref.xml"));
+
+    // 手工编辑过的 XML：<value> 在 <key> 之前、打包数组、缺失的节点与多余的子节点
+    using Edited = std::map<std::string, std::pair<int, std::vector<double>>>;
+    std::vector<double> packedValues{0.25, -8.0};
+    std::string packedText;
+    xml_serialization::base64_encode(reinterpret_cast<const char*>(packedValues.data()), 16, packedText);
+    std::FILE* edited = std::fopen("edited.xml", "w");
+    std::fprintf(edited,
+                 "<serialization><edited><item><value><second encoding=\"base64\" count=\"2\">%s</second>"
+                 "<first val=\"5\"/></value><key val=\"k\"/></item><note/><item><key val=\"z\"/></item></edited>"
+                 "<users><item><field val=\"9\"/></item><item><extra/><field val=\"3\"/><field val=\"n\"/></item>"
+                 "</users></serialization>",
+                 packedText.c_str());
+    std::fclose(edited);
+    Edited edited1;
+    std::vector<UserDefinedType> users1;
+    xml_serialization::deserialize_xml(edited1, "edited", "edited.xml");
+    xml_serialization::deserialize_xml(users1, "users", "edited.xml");
+    assert(edited1["k"].first == 5 && edited1["k"].second == packedValues && edited1.count("z") && users1[1].name == "n");
+    BinarySerialization::serialize(edited1, "edited_ref.data");
+    BinarySerialization::serialize(users1, "users_ref.data");
+    assert(xml_serialization::transcode_xml_to_binary<Edited>("edited.xml", "edited", "edited.data"));
+    assert(xml_serialization::transcode_xml_to_binary<std::vector<UserDefinedType>>("edited.xml", "users", "users.data"));
+    assert(same_file("edited.data", "edited_ref.data") && same_file("users.data", "users_ref.data"));
+
     std::cout << "UserDefinedType serialization test passed!" << std::endl;
 }
 